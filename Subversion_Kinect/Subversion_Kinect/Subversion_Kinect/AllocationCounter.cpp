@@ -0,0 +1,53 @@
+#include "AllocationCounter.h"
+#include <stdlib.h>
+#include <new>
+
+#if defined(_MSC_VER)
+	#define XN_THREAD_LOCAL __declspec(thread)
+#else
+	#define XN_THREAD_LOCAL __thread
+#endif
+
+static XN_THREAD_LOCAL XnBool g_bCounting = false;
+static XN_THREAD_LOCAL XnUInt32 g_nAllocations = 0;
+
+void BeginCountingAllocations()
+{
+	g_nAllocations = 0;
+	g_bCounting = true;
+}
+
+XnUInt32 EndCountingAllocations()
+{
+	g_bCounting = false;
+	return g_nAllocations;
+}
+
+// Every new and delete of this module goes through here. The NITE and OpenNI libraries keep their own
+static void* CountedAlloc(size_t nSize)
+{
+	if (g_bCounting)
+		g_nAllocations++;
+
+	void* pMemory = malloc(nSize == 0 ? 1 : nSize);
+	if (pMemory == NULL)
+		throw std::bad_alloc();
+	return pMemory;
+}
+
+void* operator new(size_t nSize)
+{
+	return CountedAlloc(nSize);
+}
+void* operator new[](size_t nSize)
+{
+	return CountedAlloc(nSize);
+}
+void operator delete(void* pMemory) throw()
+{
+	free(pMemory);
+}
+void operator delete[](void* pMemory) throw()
+{
+	free(pMemory);
+}
@@ -0,0 +1,14 @@
+#ifndef ALLOCATION_COUNTER_H_
+#define ALLOCATION_COUNTER_H_
+
+#include <XnPlatform.h>
+
+/**
+ * Counts the heap allocations (operator new) the calling thread makes between Begin and End,
+ * to check that per-frame code allocates nothing. Other threads are not counted, and counts do not nest.
+ * It replaces the global operator new and delete, so it is only linked into the tests, never into the viewer.
+ */
+void BeginCountingAllocations();
+XnUInt32 EndCountingAllocations();
+
+#endif
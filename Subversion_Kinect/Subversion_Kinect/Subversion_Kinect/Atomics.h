@@ -0,0 +1,52 @@
+#ifndef ATOMICS_H_
+#define ATOMICS_H_
+
+#include <XnPlatform.h>
+
+#ifdef _WIN32
+	#include <windows.h>
+#endif
+
+// 32-bit values shared between threads without a lock. Every operation here is a full memory barrier
+
+inline XnUInt32 AtomicExchange(volatile XnUInt32* pTarget, XnUInt32 nValue)
+{
+#ifdef _WIN32
+	return (XnUInt32)InterlockedExchange((volatile LONG*)pTarget, (LONG)nValue);
+#else
+	// test_and_set is only an acquire barrier, the writes before it must not move past it either
+	__sync_synchronize();
+	return __sync_lock_test_and_set(pTarget, nValue);
+#endif
+}
+
+// Returns the incremented value
+inline XnUInt32 AtomicIncrement(volatile XnUInt32* pTarget)
+{
+#ifdef _WIN32
+	return (XnUInt32)InterlockedIncrement((volatile LONG*)pTarget);
+#else
+	return __sync_add_and_fetch(pTarget, 1);
+#endif
+}
+
+// Returns the sum
+inline XnUInt32 AtomicAdd(volatile XnUInt32* pTarget, XnUInt32 nValue)
+{
+#ifdef _WIN32
+	return (XnUInt32)InterlockedExchangeAdd((volatile LONG*)pTarget, (LONG)nValue) + nValue;
+#else
+	return __sync_add_and_fetch(pTarget, nValue);
+#endif
+}
+
+inline XnUInt32 AtomicLoad(volatile XnUInt32* pTarget)
+{
+#ifdef _WIN32
+	return (XnUInt32)InterlockedCompareExchange((volatile LONG*)pTarget, 0, 0);
+#else
+	return __sync_val_compare_and_swap(pTarget, 0, 0);
+#endif
+}
+
+#endif
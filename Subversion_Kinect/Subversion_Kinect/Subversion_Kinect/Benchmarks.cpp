@@ -0,0 +1,520 @@
+//The viewer's benchmarks, out of the viewer: none of them needs a sensor, NITE or a window.
+//Those that look at depth take a recording, or make up a frame
+
+//headers for OpenNI
+#include <XnOpenNI.h>
+#include <XnCppWrapper.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <vector>
+
+//local headers
+#include "CpuFeatures.h"
+#include "DepthColorizer.h"
+#include "HandStore.h"
+#include "HandTrajectories.h"
+#include "ProjectiveConverter.h"
+#include "FrameScheduler.h"
+#include "ZoomStream.h"
+
+#define CHECK_RC(rc, what)											\
+	if (rc != XN_STATUS_OK)											\
+	{																\
+		printf("%s failed: %s\n", what, xnGetStatusString(rc));		\
+		return rc;													\
+	}
+
+#define SYNTHETIC_X_RES 640
+#define SYNTHETIC_Y_RES 480
+
+//a room the way the sensor sees it: a back wall, a floor coming closer toward the bottom, someone standing in
+//front with a hand raised, a few mm of noise, and holes with no depth along the edges of things
+static void SyntheticDepth(XnDepthPixel* pDepth, XnUInt32 nXRes, XnUInt32 nYRes)
+{
+	XnUInt32 nSeed = 1;
+	for (XnUInt32 y = 0; y < nYRes; ++y)
+	{
+		for (XnUInt32 x = 0; x < nXRes; ++x)
+		{
+			XnInt32 nDepth = 4000;
+			if (y > nYRes*2/3)
+				nDepth = 4000 - (XnInt32)(2200*(y - nYRes*2/3)/(nYRes/3));
+			XnInt32 dx = (XnInt32)x - (XnInt32)nXRes/2;
+			XnInt32 dy = (XnInt32)y - (XnInt32)nYRes/2;
+			if (dx*dx/4 + dy*dy/16 < 3600)
+				nDepth = 1800;
+			if (x > nXRes/2 + 40 && x < nXRes/2 + 80 && y > nYRes/4 && y < nYRes/2)
+				nDepth = 1400;
+
+			nSeed = nSeed*1103515245 + 12345;
+			nDepth += (XnInt32)((nSeed >> 16) % 9) - 4;
+			// Missing depth where the person meets the wall, and one pixel in a hundred anywhere
+			if ((dx*dx/4 + dy*dy/16 >= 3500 && dx*dx/4 + dy*dy/16 < 3700) || (nSeed >> 8) % 100 == 0)
+				nDepth = 0;
+			pDepth[y*nXRes + x] = (XnDepthPixel)nDepth;
+		}
+	}
+}
+
+//the depth generator of a recording, positioned on its first frame
+static XnStatus OpenRecording(const XnChar* strFile, xn::Context& context, xn::DepthGenerator& depthGenerator)
+{
+	XnStatus rc = context.Init();
+	CHECK_RC(rc, "Init");
+	xn::Player player;
+	rc = context.OpenFileRecording(strFile, player);
+	CHECK_RC(rc, "Open recording");
+	rc = context.FindExistingNode(XN_NODE_TYPE_DEPTH, depthGenerator);
+	CHECK_RC(rc, "Find depth generator");
+	rc = depthGenerator.WaitAndUpdateData();
+	CHECK_RC(rc, "Read depth");
+	return XN_STATUS_OK;
+}
+
+//colorizer [recording.oni] [iterations]: every kernel and thread count on one depth frame
+static int BenchmarkColorizer(const XnChar* strFile, XnUInt32 nIterations)
+{
+	DepthColorizer colorizer;
+	if (strFile == NULL)
+	{
+		XnDepthPixel* pDepth = new XnDepthPixel[SYNTHETIC_X_RES*SYNTHETIC_Y_RES];
+		SyntheticDepth(pDepth, SYNTHETIC_X_RES, SYNTHETIC_Y_RES);
+		printf("Synthetic depth frame\n");
+		colorizer.Benchmark(pDepth, SYNTHETIC_X_RES, SYNTHETIC_Y_RES, nIterations);
+		delete []pDepth;
+		return 0;
+	}
+
+	xn::Context context;
+	xn::DepthGenerator depthGenerator;
+	if (OpenRecording(strFile, context, depthGenerator) != XN_STATUS_OK)
+		return 1;
+	xn::DepthMetaData depthMD;
+	depthGenerator.GetMetaData(depthMD);
+	printf("Frame %u of %s\n", depthMD.FrameID(), strFile);
+	colorizer.Benchmark(depthMD.Data(), depthMD.XRes(), depthMD.YRes(), nIterations);
+	context.Release();
+	return 0;
+}
+
+//projection recording.oni [iterations]: the library's projection against the native one, with the recording's field of view
+static int BenchmarkProjection(const XnChar* strFile, XnUInt32 nIterations)
+{
+	xn::Context context;
+	xn::DepthGenerator depthGenerator;
+	if (OpenRecording(strFile, context, depthGenerator) != XN_STATUS_OK)
+		return 1;
+
+	XnBool bMatch;
+	{
+		ProjectiveConverter projection;
+		projection.Init(depthGenerator);
+		bMatch = projection.Benchmark(nIterations);
+	}
+	context.Release();
+	return bMatch ? 0 : 1;
+}
+
+//filter [hands.csv] [prediction ms]: every hand filter on recorded hands, against the recording smoothed offline,
+//or on a synthetic hand as late as the prediction, against its true path
+static int BenchmarkFilter(const XnChar* strFile, XnFloat fPredictionMs)
+{
+	HandTrajectories trajectories;
+	if (strFile != NULL)
+	{
+		if (trajectories.Load(strFile) != XN_STATUS_OK)
+			return 1;
+		printf("Hand filters: %u samples of %u hands from %s, against the recording smoothed over %.0f ms\n",
+			trajectories.GetSampleCount(), trajectories.GetHandCount(), strFile, REFERENCE_SMOOTHING_MS);
+	}
+	else
+	{
+		trajectories.Synthesize(fPredictionMs, 3);
+		printf("Hand filters: synthetic hand, %u samples at 30 Hz, %.0f ms late with 3 mm noise, against the true path\n",
+			trajectories.GetSampleCount(), fPredictionMs);
+	}
+	trajectories.PrintScores(fPredictionMs);
+	return 0;
+}
+
+//the viewer's hands, as its drawer keeps them
+typedef HandStoreT<HandHistory<20, HAND_LAYOUT_PROJECTIVE> > ViewerHands;
+#define NITE_HANDS 4
+#define NITE_SENSOR_US 33333
+#define NITE_DISPLAY_US 16667
+
+//takes the CPU for nUs, the way NITE's gesture detectors do during an update
+static void Spin(XnUInt32 nUs)
+{
+	XnUInt64 nStart, nNow;
+	xnOSGetHighResTimeStamp(&nStart);
+	do
+	{
+		xnOSGetHighResTimeStamp(&nNow);
+	} while (nNow - nStart < nUs);
+}
+
+//what a session manager update does for the display: the detectors' time, then the drawer's, which pushes
+//every hand's new position and publishes them
+static void NiteUpdate(ViewerHands& hands, const FOVEdgeTracker& edges, XnUInt32 nFrame, XnUInt32 nUpdateUs)
+{
+	Spin(nUpdateUs);
+	for (XnUInt32 i = 0; i < NITE_HANDS; ++i)
+	{
+		XnFloat fAngle = nFrame*0.1f + i*1.5f;
+		XnPoint3D pt = {160.0f*i + 80*cosf(fAngle), 240 + 80*sinf(fAngle), 1500};
+		hands.Push(i + 1, pt, nFrame/30.0f);
+	}
+	hands.Publish(1, edges);
+}
+
+typedef struct NiteStandIn
+{
+	ViewerHands* pHands;
+	const FOVEdgeTracker* pEdges;
+	XnUInt32 nUpdateUs;
+	volatile XnUInt32 nFrame;
+	volatile XnBool bStop;
+} NiteStandIn;
+
+//the NITE thread: an update for every sensor frame
+static XN_THREAD_PROC NiteStandInThread(XN_THREAD_PARAM pParam)
+{
+	NiteStandIn* pNite = (NiteStandIn*)pParam;
+	XnUInt64 nNext;
+	xnOSGetHighResTimeStamp(&nNext);
+	while (!pNite->bStop)
+	{
+		NiteUpdate(*pNite->pHands, *pNite->pEdges, pNite->nFrame, pNite->nUpdateUs);
+		pNite->nFrame++;
+		nNext += NITE_SENSOR_US;
+		XnUInt64 nNow;
+		xnOSGetHighResTimeStamp(&nNow);
+		if (nNow < nNext)
+			xnOSSleep((XnUInt32)((nNext - nNow)/1000));
+	}
+	XN_THREAD_PROC_RETURN(XN_STATUS_OK);
+}
+
+//nite [seconds] [update us]: the display's frame times with the session manager updated in the display frame,
+//the way the viewer did, and on its own thread. A 30 Hz sensor, a 60 Hz display that colorizes every new depth
+//frame and draws the hands' snapshot, and NITE updates taking the time the viewer's 'r' reports for them
+static int BenchmarkNiteThread(XnUInt32 nSeconds, XnUInt32 nUpdateUs)
+{
+	XnDepthPixel* pDepth = new XnDepthPixel[SYNTHETIC_X_RES*SYNTHETIC_Y_RES];
+	SyntheticDepth(pDepth, SYNTHETIC_X_RES, SYNTHETIC_Y_RES);
+	XnUChar* pColors = new XnUChar[SYNTHETIC_X_RES*SYNTHETIC_Y_RES*3];
+	printf("NITE thread: %u s per case, %.1f ms per NITE update, 30 Hz sensor, 60 Hz display, %u hands, %u CPUs\n",
+		nSeconds, nUpdateUs/1000.0, NITE_HANDS, GetCpuFeatures().nLogicalCores);
+	printf("  %-28s %8s %10s %10s %10s\n", "session manager", "frames", "mean", "worst", "over 16.7");
+
+	for (XnUInt32 nThreaded = 0; nThreaded < 2; ++nThreaded)
+	{
+		DepthColorizer colorizer;
+		FOVEdgeTracker edges;
+		ViewerHands hands(20);
+		for (XnUInt32 i = 0; i < NITE_HANDS; ++i)
+		{
+			hands.Add(i + 1);
+		}
+
+		NiteStandIn nite;
+		nite.pHands = &hands;
+		nite.pEdges = &edges;
+		nite.nUpdateUs = nUpdateUs;
+		nite.nFrame = 0;
+		nite.bStop = false;
+		XN_THREAD_HANDLE hThread = NULL;
+		if (nThreaded && xnOSCreateThread(NiteStandInThread, &nite, &hThread) != XN_STATUS_OK)
+		{
+			printf("NITE thread creation failed\n");
+			return 1;
+		}
+
+		XnUInt32 nFrames = 0, nLate = 0, nColorized = 0;
+		XnUInt64 nTotal = 0, nWorst = 0;
+		XnUInt64 nStart, nNow, nNextSensor;
+		xnOSGetHighResTimeStamp(&nStart);
+		nNextSensor = nStart;
+		for (XnUInt64 nNextFrame = nStart; nNextFrame < nStart + (XnUInt64)nSeconds*1000000; nNextFrame += NITE_DISPLAY_US)
+		{
+			xnOSGetHighResTimeStamp(&nNow);
+			if (nNow < nNextFrame)
+				xnOSSleep((XnUInt32)((nNextFrame - nNow)/1000));
+
+			XnUInt64 nFrameStart, nFrameEnd;
+			xnOSGetHighResTimeStamp(&nFrameStart);
+			XnBool bNewFrame;
+			if (nThreaded)
+			{
+				bNewFrame = nite.nFrame != nColorized;
+				nColorized = nite.nFrame;
+			}
+			else
+			{
+				// The old display: the session manager updated first, whenever the sensor has a frame
+				bNewFrame = nFrameStart >= nNextSensor;
+				if (bNewFrame)
+				{
+					NiteUpdate(hands, edges, nite.nFrame++, nUpdateUs);
+					nNextSensor += NITE_SENSOR_US;
+				}
+			}
+			if (bNewFrame)
+				colorizer.Colorize(pDepth, SYNTHETIC_X_RES, SYNTHETIC_Y_RES, pColors, 3, SYNTHETIC_X_RES*3);
+			RenderQueue queue;
+			hands.Draw(queue);
+			xnOSGetHighResTimeStamp(&nFrameEnd);
+
+			XnUInt64 nFrame = nFrameEnd - nFrameStart;
+			nTotal += nFrame;
+			if (nFrame > nWorst)
+				nWorst = nFrame;
+			if (nFrame > NITE_DISPLAY_US)
+				nLate++;
+			nFrames++;
+		}
+
+		if (nThreaded)
+		{
+			nite.bStop = true;
+			xnOSWaitForThreadExit(hThread, XN_WAIT_INFINITE);
+			xnOSCloseThread(&hThread);
+		}
+		printf("  %-28s %8u %7.2f ms %7.2f ms %10u\n", nThreaded ? "own thread" : "in the display frame",
+			nFrames, nTotal/1000.0/nFrames, nWorst/1000.0, nLate);
+	}
+
+	delete []pColors;
+	delete []pDepth;
+	return 0;
+}
+
+//normally distributed noise, from a fixed seed so every run sees the same
+static XnFloat Gaussian(XnUInt32& nSeed)
+{
+	nSeed = nSeed*1664525 + 1013904223;
+	XnFloat fU1 = ((nSeed >> 8) + 1)/16777217.0f;
+	nSeed = nSeed*1664525 + 1013904223;
+	XnFloat fU2 = (nSeed >> 8)/16777216.0f;
+	return (XnFloat)(sqrt(-2*log(fU1))*cos(6.2831853*fU2));
+}
+
+//how far the synthetic hand is from the sensor at time t: still, a slow push in, a quick pull back, a sway,
+//then a slow drift, each followed by a rest
+static XnFloat SyntheticHandDepth(XnFloat t)
+{
+	typedef struct
+	{
+		XnFloat fStart;
+		XnFloat fEnd;
+		XnFloat fFrom;
+		XnFloat fTo;
+	} Move;
+	static const Move moves[] =
+	{
+		{3, 5, 1500, 1250},
+		{8, 9, 1250, 1650},
+		{12, 16, 1650, 1500}
+	};
+
+	XnFloat fZ = 1500;
+	for (XnUInt32 i = 0; i < sizeof(moves)/sizeof(moves[0]); ++i)
+	{
+		const Move& move = moves[i];
+		if (t < move.fStart)
+			break;
+		XnFloat fDone = t >= move.fEnd ? 1 : (XnFloat)(0.5 - 0.5*cos(3.1415927*(t - move.fStart)/(move.fEnd - move.fStart)));
+		fZ = move.fFrom + (move.fTo - move.fFrom)*fDone;
+	}
+	// A hand held up sways a little
+	if (t >= 9 && t < 12)
+		fZ += 10*(XnFloat)sin(6.2831853*0.5*(t - 9));
+	return fZ;
+}
+
+//zoom [hands.csv]: the zoom driven by the first hand recorded in strFile (as written by XnVHandFilter's recording),
+//or by a synthetic one, filtered the way the controls see it. How many commands sending every frame takes, against
+//streaming at a few rates, and how far the zoom sent stays behind the hand
+static int BenchmarkZoom(const XnChar* strFile)
+{
+	std::vector<XnFloat> times;
+	std::vector<XnFloat> depths;
+
+	if (strFile != NULL)
+	{
+		FILE* pFile = fopen(strFile, "r");
+		if (pFile == NULL)
+		{
+			printf("Can't open %s\n", strFile);
+			return 1;
+		}
+
+		// The first hand is the one that zooms
+		XnBool bFirst = true;
+		XnUInt32 nFirstID = 0;
+		XnChar strLine[256];
+		while (fgets(strLine, sizeof(strLine), pFile) != NULL)
+		{
+			XnFloat fTime;
+			XnUInt32 nID;
+			XnPoint3D pt;
+			if (strLine[0] == '#' || sscanf(strLine, "%f,%u,%f,%f,%f", &fTime, &nID, &pt.X, &pt.Y, &pt.Z) != 5)
+				continue;
+			if (bFirst)
+			{
+				nFirstID = nID;
+				bFirst = false;
+			}
+			if (nID != nFirstID)
+				continue;
+			times.push_back(fTime);
+			depths.push_back(pt.Z);
+		}
+		fclose(pFile);
+		printf("Zoom stream evaluation: %u positions of hand %u from %s\n", (XnUInt32)times.size(), nFirstID, strFile);
+	}
+	else
+	{
+		// 20 s at 30 Hz, with 3 mm of sensor noise
+		XnUInt32 nSeed = 1;
+		for (XnUInt32 i = 0; i < 600; ++i)
+		{
+			times.push_back(i/30.0f);
+			depths.push_back(SyntheticHandDepth(i/30.0f) + 3*Gaussian(nSeed));
+		}
+		printf("Zoom stream evaluation: synthetic hand, 600 samples at 30 Hz with 3 mm noise\n");
+	}
+	if (times.size() < 2)
+	{
+		printf("Not enough positions to zoom with\n");
+		return 1;
+	}
+
+	// The targets the hand sets, frame by frame, filtered as the controls get it, from 100% where it starts
+	std::vector<XnDouble> targets(times.size());
+	HandFilter filter;
+	XnUInt32 nLane = 0;
+	for (XnUInt32 i = 0; i < times.size(); ++i)
+	{
+		XnPoint3D pt = {0, 0, depths[i]};
+		filter.Filter(1, &nLane, &pt, &times[i]);
+		if (i == 0)
+			depths[0] = pt.Z;
+		targets[i] = ZoomStream::ForHandDepth(pt.Z, depths[0], 100);
+	}
+	XnDouble fSeconds = times.back() - times.front();
+
+	printf("  ZOOM_DOUBLING_MM %.0f, deadband %.0f%% at rest, %.0f%% on the move, %d ticks to settle\n",
+		ZOOM_DOUBLING_MM, ZOOM_DEADBAND_START*100, ZOOM_DEADBAND_TRACK*100, ZOOM_SETTLE_TICKS);
+	printf("  %-12s %9s %10s %12s %12s %10s\n", "sending", "commands", "per s", "mean error", "worst error", "at rest");
+	// Every frame sent as it comes, the player always where the hand is, if it keeps up
+	printf("  %-12s %9u %10.1f %11.2f%% %11.2f%% %9.2f%%\n", "every frame", (XnUInt32)times.size(),
+		times.size()/fSeconds, 0.0, 0.0, 0.0);
+
+	XnFloat rates[] = {5, 10, 15, 30};
+	for (XnUInt32 r = 0; r < sizeof(rates)/sizeof(rates[0]); ++r)
+	{
+		ZoomStream stream;
+		stream.SetRate(rates[r]);
+		XnDouble fPlayer = targets[0];
+		XnUInt32 nSent = 0;
+		XnDouble fErrorSum = 0;
+		XnDouble fWorstError = 0;
+		XnDouble fError = 0;
+		for (XnUInt32 i = 0; i < times.size(); ++i)
+		{
+			XnUInt64 nFrame = (XnUInt64)(times[i]*1000000);
+			XnUInt64 nNextFrame = i + 1 < times.size() ? (XnUInt64)(times[i + 1]*1000000) : nFrame + 1000000;
+			stream.SetTarget(targets[i]);
+
+			// The ticks until the next frame, the player taking every zoom at once
+			XnUInt64 nTick = stream.GetNextTick() > nFrame ? stream.GetNextTick() : nFrame;
+			while (stream.IsActive() && nTick < nNextFrame)
+			{
+				XnDouble fZoom;
+				if (stream.Tick(nTick, fPlayer, fZoom))
+				{
+					fPlayer = fZoom;
+					nSent++;
+				}
+				nTick = stream.GetNextTick();
+			}
+
+			// How far off the player is, until the next frame moves the hand again
+			fError = fabs(fPlayer/targets[i] - 1);
+			fErrorSum += fError;
+			if (fError > fWorstError)
+				fWorstError = fError;
+		}
+
+		XnChar strName[32];
+		sprintf(strName, "%.0f Hz", rates[r]);
+		printf("  %-12s %9u %10.1f %11.2f%% %11.2f%% %9.2f%%\n", strName, nSent, nSent/fSeconds,
+			fErrorSum/times.size()*100, fWorstError*100, fError*100);
+	}
+	return 0;
+}
+
+static void PrintUsage()
+{
+	printf("Usage: Benchmarks colorizer [recording.oni] [iterations]\n");
+	printf("       Benchmarks hands [iterations]\n");
+	printf("       Benchmarks projection recording.oni [iterations]\n");
+	printf("       Benchmarks filter [hands.csv] [prediction ms]\n");
+	printf("       Benchmarks zoom [hands.csv]\n");
+	printf("       Benchmarks nite [seconds per case] [update us]\n");
+	printf("       Benchmarks scheduler [seconds per case] [draw us]\n");
+}
+
+int main(int argc, char ** argv)
+{
+	if (argc < 2)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	if (strcmp(argv[1], "colorizer") == 0)
+	{
+		// A number alone is the iterations, on a synthetic frame
+		XnBool bFile = argc > 2 && atoi(argv[2]) == 0;
+		const XnChar* strIterations = bFile ? (argc > 3 ? argv[3] : NULL) : (argc > 2 ? argv[2] : NULL);
+		return BenchmarkColorizer(bFile ? argv[2] : NULL, strIterations != NULL ? atoi(strIterations) : 100);
+	}
+	if (strcmp(argv[1], "hands") == 0)
+	{
+		HandStore::Benchmark(argc > 2 ? atoi(argv[2]) : 100000);
+		return 0;
+	}
+	if (strcmp(argv[1], "projection") == 0 && argc > 2)
+	{
+		return BenchmarkProjection(argv[2], argc > 3 ? atoi(argv[3]) : 100000);
+	}
+	if (strcmp(argv[1], "nite") == 0)
+	{
+		return BenchmarkNiteThread(argc > 2 ? atoi(argv[2]) : 5, argc > 3 ? atoi(argv[3]) : 10000);
+	}
+	if (strcmp(argv[1], "scheduler") == 0)
+	{
+		return FrameScheduler::Soak(argc > 2 ? atoi(argv[2]) : 5, argc > 3 ? atoi(argv[3]) : 0);
+	}
+	if (strcmp(argv[1], "filter") == 0)
+	{
+		// A number alone is the prediction, on the synthetic hand
+		XnBool bFile = argc > 2 && !isdigit((XnUChar)argv[2][0]);
+		const XnChar* strPrediction = bFile ? (argc > 3 ? argv[3] : NULL) : (argc > 2 ? argv[2] : NULL);
+		return BenchmarkFilter(bFile ? argv[2] : NULL, strPrediction != NULL ? (XnFloat)atof(strPrediction) : 66);
+	}
+	if (strcmp(argv[1], "zoom") == 0)
+	{
+		return BenchmarkZoom(argc > 2 ? argv[2] : NULL);
+	}
+
+	PrintUsage();
+	return 1;
+}
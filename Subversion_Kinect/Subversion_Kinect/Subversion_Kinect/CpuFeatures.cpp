@@ -0,0 +1,83 @@
+#include "CpuFeatures.h"
+
+#if defined(_WIN32)
+	#include <windows.h>
+#else
+	#include <unistd.h>
+#endif
+
+#ifdef XN_CPU_X86
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#endif
+
+#ifdef XN_CPU_X86
+static void QueryCpuId(XnUInt32 nLeaf, XnUInt32 nSubLeaf, XnUInt32 regs[4])
+{
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuidex(info, nLeaf, nSubLeaf);
+	regs[0] = info[0]; regs[1] = info[1]; regs[2] = info[2]; regs[3] = info[3];
+#else
+	__cpuid_count(nLeaf, nSubLeaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// The OS has to save the YMM registers on context switch, or AVX code will crash
+static XnBool OSSavesYMM()
+{
+	XnUInt32 nLow, nHigh;
+#if defined(_MSC_VER)
+	unsigned __int64 xcr0 = _xgetbv(0);
+	nLow = (XnUInt32)xcr0;
+	nHigh = (XnUInt32)(xcr0 >> 32);
+#else
+	__asm__ __volatile__ ("xgetbv" : "=a"(nLow), "=d"(nHigh) : "c"(0));
+#endif
+	return (nLow & 0x6) == 0x6;
+}
+#endif
+
+static CpuFeatures DetectCpuFeatures()
+{
+	CpuFeatures features;
+	features.bSSE41 = FALSE;
+	features.bAVX2 = FALSE;
+
+#if defined(_WIN32)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	features.nLogicalCores = info.dwNumberOfProcessors;
+#else
+	long nCores = sysconf(_SC_NPROCESSORS_ONLN);
+	features.nLogicalCores = nCores > 0 ? (XnUInt32)nCores : 1;
+#endif
+
+#ifdef XN_CPU_X86
+	XnUInt32 regs[4];
+	QueryCpuId(0, 0, regs);
+	XnUInt32 nMaxLeaf = regs[0];
+
+	QueryCpuId(1, 0, regs);
+	features.bSSE41 = (regs[2] & (1 << 19)) != 0;
+	XnBool bOSXSave = (regs[2] & (1 << 27)) != 0;
+	XnBool bAVX = (regs[2] & (1 << 28)) != 0;
+
+	if (nMaxLeaf >= 7 && bOSXSave && bAVX && OSSavesYMM())
+	{
+		QueryCpuId(7, 0, regs);
+		features.bAVX2 = (regs[1] & (1 << 5)) != 0;
+	}
+#endif
+
+	return features;
+}
+
+const CpuFeatures& GetCpuFeatures()
+{
+	static CpuFeatures features = DetectCpuFeatures();
+	return features;
+}
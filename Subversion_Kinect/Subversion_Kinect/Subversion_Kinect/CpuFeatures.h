@@ -0,0 +1,35 @@
+#ifndef CPU_FEATURES_H_
+#define CPU_FEATURES_H_
+
+#include <XnPlatform.h>
+
+// SIMD kernels are only built for x86 targets, everything else uses the plain C paths
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+	#define XN_CPU_X86
+#endif
+
+// AVX2 intrinsics need VS2012 or a GCC/Clang that understands target attributes
+#if defined(XN_CPU_X86) && ((defined(_MSC_VER) && _MSC_VER >= 1700) || defined(__GNUC__))
+	#define XN_CPU_AVX2_KERNELS
+#endif
+
+// GCC/Clang only allow ISA intrinsics inside functions compiled for that ISA
+#if defined(__GNUC__)
+	#define XN_TARGET(isa) __attribute__((target(isa)))
+#else
+	#define XN_TARGET(isa)
+#endif
+
+typedef struct CpuFeatures
+{
+	XnBool bSSE41;
+	XnBool bAVX2;
+	XnUInt32 nLogicalCores;
+} CpuFeatures;
+
+/**
+ * Returns the instruction sets usable on this machine (queried once, then cached)
+ */
+const CpuFeatures& GetCpuFeatures();
+
+#endif
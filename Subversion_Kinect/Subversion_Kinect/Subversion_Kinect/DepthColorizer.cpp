@@ -0,0 +1,932 @@
+#include "DepthColorizer.h"
+#include "CpuFeatures.h"
+#include <XnOS.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef XN_CPU_X86
+	#include <smmintrin.h>
+	#ifdef XN_CPU_AVX2_KERNELS
+		#include <immintrin.h>
+	#endif
+#endif
+
+// Depth values past the table are folded into its last bin
+#define CLAMP_DEPTH(d) ((d) < MAX_DEPTH ? (d) : MAX_DEPTH - 1)
+
+// Colormap entries hold R, G, B and A in memory order (on little-endian targets)
+#define PACK_RGBA(r, g, b) ((XnUInt32)(r) | ((XnUInt32)(g) << 8) | ((XnUInt32)(b) << 16) | 0xFF000000)
+#define PACK_GREY(v) PACK_RGBA(v, v, v)
+
+static void FillEntries(XnUInt32* pLUT, XnUInt32 nFirst, XnUInt32 nEnd, XnUInt32 nValue)
+{
+	for (XnUInt32 i = nFirst; i < nEnd; ++i)
+	{
+		pLUT[i] = nValue;
+	}
+}
+
+// Depths past the histogram are binned as its last depth, so they share its entry
+static void FillTail(XnUInt32* pLUT)
+{
+	if (pLUT[MAX_DEPTH] != pLUT[MAX_DEPTH - 1])
+		FillEntries(pLUT, MAX_DEPTH, COLORMAP_ENTRIES, pLUT[MAX_DEPTH - 1]);
+}
+
+static XnUInt32 ToByte(XnFloat fValue)
+{
+	if (fValue <= 0)
+		return 0;
+	if (fValue >= 1)
+		return 255;
+	return (XnUInt32)(fValue*255 + 0.5f);
+}
+
+// Polynomial fit of Google's Turbo colormap, from dark blue at 0 to dark red at 1
+static XnUInt32 TurboColor(XnFloat x)
+{
+	XnFloat x2 = x*x, x3 = x2*x, x4 = x3*x, x5 = x4*x;
+	XnFloat r = 0.13572138f + 4.61539260f*x - 42.66032258f*x2 + 132.13108234f*x3 - 152.94239396f*x4 + 59.28637943f*x5;
+	XnFloat g = 0.09140261f + 2.19418839f*x + 4.84296658f*x2 - 14.18503333f*x3 + 4.27729857f*x4 + 2.82956604f*x5;
+	XnFloat b = 0.10667330f + 12.64194608f*x - 60.58204836f*x2 + 110.36276771f*x3 - 89.90310912f*x4 + 27.34824973f*x5;
+	return PACK_RGBA(ToByte(r), ToByte(g), ToByte(b));
+}
+
+DepthColorizer::DepthColorizer() :
+	m_ePhase(PHASE_HISTOGRAM), m_pDepth(NULL), m_nXRes(0), m_nYRes(0), m_pDest(NULL), m_nBytesPerPixel(0), m_nPitch(0),
+	m_pDirtyRows(NULL), m_pScratch(NULL), m_nScratchRowSize(0),
+	m_pPartials(NULL), m_nStride(1), m_nBinned(0), m_nNearClip(1), m_nFarClip(MAX_DEPTH - 1), m_eKernel(BestKernel()), m_bBitExact(true),
+	m_ePolicy(HISTOGRAM_FULL), m_nSampleStride(4), m_fDriftThreshold(0.05f), m_nMaxTableAge(30), m_bTableValid(false), m_nTableAge(0),
+	m_eColormap(COLORMAP_EQUALIZED), m_nColormapNear(500), m_nColormapFar(4500), m_nFullTime(0), m_nFullPixels(0)
+{
+	for (XnUInt32 i = 0; i < COLORMAP_COUNT; ++i)
+	{
+		m_pColormaps[i] = new XnUInt32[COLORMAP_ENTRIES];
+	}
+	FillEntries(m_pColormaps[COLORMAP_EQUALIZED], 0, COLORMAP_ENTRIES, PACK_GREY(0));
+	BuildFixedColormaps();
+	memset(&m_Stats, 0, sizeof(m_Stats));
+	memset(m_DriftReference, 0, sizeof(m_DriftReference));
+	ResetStats();
+	SetThreadCount(1);
+}
+
+DepthColorizer::~DepthColorizer()
+{
+	delete []m_pPartials;
+	delete []m_pScratch;
+	for (XnUInt32 i = 0; i < COLORMAP_COUNT; ++i)
+	{
+		delete []m_pColormaps[i];
+	}
+}
+
+XnStatus DepthColorizer::SetThreadCount(XnUInt32 nThreads)
+{
+	if (nThreads == 0)
+		nThreads = GetCpuFeatures().nLogicalCores;
+
+	XnStatus rc = m_Pool.SetThreadCount(nThreads);
+
+	// Start from clean histograms, every frame clears only what the previous one used
+	XnUInt32 nPartials = m_Pool.GetThreadCount()*PARTIALS_PER_BAND;
+	delete []m_pPartials;
+	m_pPartials = new XnUInt32[nPartials*MAX_DEPTH];
+	memset(m_pPartials, 0, nPartials*MAX_DEPTH*sizeof(XnUInt32));
+	for (XnUInt32 nBand = 0; nBand < m_Pool.GetThreadCount(); ++nBand)
+	{
+		m_Bands[nBand].nDirtyFirst = 1;
+		m_Bands[nBand].nDirtyLast = 0;
+	}
+
+	return rc;
+}
+
+void DepthColorizer::SetClipRange(XnDepthPixel nNear, XnDepthPixel nFar)
+{
+	m_nNearClip = nNear < 1 ? 1 : nNear;
+	m_nFarClip = nFar > MAX_DEPTH - 1 ? MAX_DEPTH - 1 : nFar;
+	if (m_nFarClip < m_nNearClip)
+		m_nFarClip = m_nNearClip;
+
+	// Clipped depths must come out black, but the equalized table is only rebuilt inside the volume
+	XnUInt32* pLUT = m_pColormaps[COLORMAP_EQUALIZED];
+	FillEntries(pLUT, 1, m_nNearClip, PACK_GREY(0));
+	FillEntries(pLUT, m_nFarClip + 1, MAX_DEPTH, PACK_GREY(0));
+	FillTail(pLUT);
+	m_bTableValid = false;
+
+	BuildFixedColormaps();
+}
+void DepthColorizer::ClearClipRange()
+{
+	SetClipRange(1, MAX_DEPTH - 1);
+}
+XnBool DepthColorizer::IsClipping() const
+{
+	return m_nNearClip > 1 || m_nFarClip < MAX_DEPTH - 1;
+}
+
+const DepthFrameStats& DepthColorizer::GetFrameStats() const
+{
+	return m_Stats;
+}
+
+void DepthColorizer::SetColormap(Colormap eColormap)
+{
+	m_eColormap = eColormap;
+	// The equalized table is not kept up to date while another map is shown
+	m_bTableValid = false;
+}
+DepthColorizer::Colormap DepthColorizer::GetColormap() const
+{
+	return m_eColormap;
+}
+XnBool DepthColorizer::IsGreyColormap() const
+{
+	return m_eColormap != COLORMAP_TURBO;
+}
+const XnChar* DepthColorizer::GetColormapName(Colormap eColormap)
+{
+	switch (eColormap)
+	{
+	case COLORMAP_LINEAR:
+		return "linear";
+	case COLORMAP_TURBO:
+		return "turbo";
+	default:
+		return "equalized";
+	}
+}
+void DepthColorizer::SetColormapRange(XnDepthPixel nNear, XnDepthPixel nFar)
+{
+	m_nColormapNear = nNear;
+	m_nColormapFar = nFar > nNear ? nFar : nNear + 1;
+	BuildFixedColormaps();
+}
+
+// The maps that only depend on the settings. Rebuilt when they change, which costs about a millisecond
+void DepthColorizer::BuildFixedColormaps()
+{
+	XnUInt32* pLinear = m_pColormaps[COLORMAP_LINEAR];
+	XnUInt32* pTurbo = m_pColormaps[COLORMAP_TURBO];
+	XnFloat fSpan = (XnFloat)(m_nColormapFar - m_nColormapNear);
+	for (XnUInt32 nDepth = 0; nDepth < MAX_DEPTH; ++nDepth)
+	{
+		// Missing and clipped depths are black, as in the equalized map
+		if (nDepth < m_nNearClip || nDepth > m_nFarClip)
+		{
+			pLinear[nDepth] = PACK_GREY(0);
+			pTurbo[nDepth] = PACK_GREY(0);
+			continue;
+		}
+
+		// 1 at the near end of the range, 0 at the far end
+		XnFloat x = (m_nColormapFar - (XnFloat)nDepth)/fSpan;
+		x = x < 0 ? 0 : (x > 1 ? 1 : x);
+		pLinear[nDepth] = PACK_GREY(ToByte(x));
+		pTurbo[nDepth] = TurboColor(x);
+	}
+	FillTail(pLinear);
+	FillTail(pTurbo);
+}
+
+void DepthColorizer::SetHistogramPolicy(HistogramPolicy ePolicy)
+{
+	m_ePolicy = ePolicy;
+	m_bTableValid = false;
+}
+DepthColorizer::HistogramPolicy DepthColorizer::GetHistogramPolicy() const
+{
+	return m_ePolicy;
+}
+const XnChar* DepthColorizer::GetHistogramPolicyName(HistogramPolicy ePolicy)
+{
+	switch (ePolicy)
+	{
+	case HISTOGRAM_SUBSAMPLED:
+		return "subsampled";
+	case HISTOGRAM_CACHED:
+		return "cached";
+	default:
+		return "full";
+	}
+}
+void DepthColorizer::SetSampleStride(XnUInt32 nStride)
+{
+	m_nSampleStride = nStride < 1 ? 1 : nStride;
+	m_bTableValid = false;
+}
+void DepthColorizer::SetDriftThreshold(XnFloat fThreshold)
+{
+	m_fDriftThreshold = fThreshold;
+}
+void DepthColorizer::SetMaxTableAge(XnUInt32 nMaxAge)
+{
+	m_nMaxTableAge = nMaxAge;
+}
+
+XnUInt32 DepthColorizer::GetThreadCount() const
+{
+	return m_Pool.GetThreadCount();
+}
+
+XnUInt32* DepthColorizer::GetPartial(XnUInt32 nPartial) const
+{
+	return m_pPartials + nPartial*MAX_DEPTH;
+}
+
+void DepthColorizer::SetBitExact(XnBool bBitExact)
+{
+	m_bBitExact = bBitExact;
+	m_bTableValid = false;
+}
+XnBool DepthColorizer::IsBitExact() const
+{
+	return m_bBitExact;
+}
+
+void DepthColorizer::SetKernel(Kernel eKernel)
+{
+	m_eKernel = IsSupported(eKernel) ? eKernel : BestKernel();
+}
+DepthColorizer::Kernel DepthColorizer::GetKernel() const
+{
+	return m_eKernel;
+}
+const XnChar* DepthColorizer::GetKernelName(Kernel eKernel)
+{
+	switch (eKernel)
+	{
+	case KERNEL_SSE41:
+		return "SSE4.1";
+	case KERNEL_AVX2:
+		return "AVX2";
+	default:
+		return "scalar";
+	}
+}
+
+XnBool DepthColorizer::IsSupported(Kernel eKernel)
+{
+	switch (eKernel)
+	{
+	case KERNEL_SSE41:
+		return GetCpuFeatures().bSSE41;
+	case KERNEL_AVX2:
+#ifdef XN_CPU_AVX2_KERNELS
+		return GetCpuFeatures().bAVX2;
+#else
+		return FALSE;
+#endif
+	default:
+		return TRUE;
+	}
+}
+DepthColorizer::Kernel DepthColorizer::BestKernel()
+{
+	if (IsSupported(KERNEL_AVX2))
+		return KERNEL_AVX2;
+	if (IsSupported(KERNEL_SSE41))
+		return KERNEL_SSE41;
+	return KERNEL_SCALAR;
+}
+
+XnDouble DepthColorizer::GetNsPerPixel() const
+{
+	if (m_Counters.nPixels == 0)
+		return 0;
+	return m_Counters.nTime * 1000.0 / m_Counters.nPixels;
+}
+XnUInt32 DepthColorizer::GetFrameCount() const
+{
+	return m_Counters.nFrames;
+}
+XnUInt32 DepthColorizer::GetRebuildCount() const
+{
+	return m_Counters.nRebuilds;
+}
+XnDouble DepthColorizer::GetSavedMs() const
+{
+	return m_Counters.nSavedTime / 1000.0;
+}
+void DepthColorizer::ResetStats()
+{
+	memset(&m_Counters, 0, sizeof(m_Counters));
+}
+
+void DepthColorizer::Colorize(const XnDepthPixel* pDepth, XnUInt32 nXRes, XnUInt32 nYRes,
+							   XnUChar* pDest, XnUInt32 nBytesPerPixel, XnUInt32 nPitch, XnUChar* pDirtyRows)
+{
+	XnUInt64 nStart, nEnd;
+	xnOSGetHighResTimeStamp(&nStart);
+
+	// A table built for another resolution says nothing about this one
+	if (nXRes != m_nXRes || nYRes != m_nYRes)
+		m_bTableValid = false;
+
+	m_pDepth = pDepth;
+	m_nXRes = nXRes;
+	m_nYRes = nYRes;
+	m_pDest = pDest;
+	m_nBytesPerPixel = nBytesPerPixel;
+	m_nPitch = nPitch;
+	m_pDirtyRows = pDirtyRows;
+	if (pDirtyRows != NULL && m_nScratchRowSize < nXRes*nBytesPerPixel)
+	{
+		delete []m_pScratch;
+		m_nScratchRowSize = nXRes*nBytesPerPixel;
+		m_pScratch = new XnUChar[MAX_POOL_THREADS*m_nScratchRowSize];
+	}
+
+	XnUInt32 nStride = 1;
+	XnBool bBuild = true;
+	switch (m_ePolicy)
+	{
+	case HISTOGRAM_SUBSAMPLED:
+		// Until one frame was binned in full there is nothing to tell what subsampling saves
+		if (m_nFullPixels != 0)
+			nStride = m_nSampleStride;
+		break;
+	case HISTOGRAM_CACHED:
+		bBuild = CheckDrift();
+		break;
+	default:
+		break;
+	}
+
+	XnUInt64 nBuildStart, nBuildEnd;
+	xnOSGetHighResTimeStamp(&nBuildStart);
+	if (bBuild)
+		BuildHistogram(nStride);
+	xnOSGetHighResTimeStamp(&nBuildEnd);
+
+	// Full builds cost what they cost, and also tell what the others would have.
+	// Anything else saves the estimated full build, minus what it spent instead
+	XnUInt32 nPixels = nXRes*nYRes;
+	if (bBuild && nStride == 1)
+	{
+		m_nFullTime += nBuildEnd - nBuildStart;
+		m_nFullPixels += nPixels;
+		m_Counters.nRebuilds++;
+		// The drift check was spent on top of the build
+		if (m_ePolicy == HISTOGRAM_CACHED)
+			m_Counters.nSavedTime -= (XnInt64)(nBuildStart - nStart);
+	}
+	else
+	{
+		m_Counters.nSavedTime += (XnInt64)(m_nFullTime*nPixels/m_nFullPixels) - (XnInt64)(nBuildEnd - nStart);
+	}
+
+	m_ePhase = PHASE_EXPAND;
+	m_Pool.Run(RunTask, this);
+
+	xnOSGetHighResTimeStamp(&nEnd);
+	m_Counters.nTime += nEnd - nStart;
+	m_Counters.nPixels += nPixels;
+	m_Counters.nFrames++;
+}
+
+void DepthColorizer::BuildHistogram(XnUInt32 nStride)
+{
+	// Private histograms per band
+	m_nStride = nStride;
+	m_ePhase = PHASE_HISTOGRAM;
+	m_Pool.Run(RunTask, this);
+
+	XnUInt32 nBands = m_Pool.GetThreadCount();
+	XnUInt32 nMissing = 0;
+	m_Stats.nMinDepth = MAX_DEPTH;
+	m_Stats.nMaxDepth = 0;
+	for (XnUInt32 nBand = 0; nBand < nBands; ++nBand)
+	{
+		if (m_Bands[nBand].nMin < m_Stats.nMinDepth)
+			m_Stats.nMinDepth = (XnDepthPixel)m_Bands[nBand].nMin;
+		if (m_Bands[nBand].nMax > m_Stats.nMaxDepth)
+			m_Stats.nMaxDepth = (XnDepthPixel)m_Bands[nBand].nMax;
+		for (XnUInt32 i = 0; i < PARTIALS_PER_BAND; ++i)
+		{
+			nMissing += GetPartial(nBand*PARTIALS_PER_BAND + i)[0];
+		}
+	}
+	XnUInt32 nSamples = ((m_nXRes + nStride - 1)/nStride)*((m_nYRes + nStride - 1)/nStride);
+	m_nBinned = nSamples - nMissing;
+	m_Stats.nValidPixels = (XnUInt32)((XnUInt64)m_nBinned*m_nXRes*m_nYRes/nSamples);
+
+	if (m_nBinned == 0)
+	{
+		m_Stats.nMinDepth = 0;
+		return;
+	}
+
+	// The other colormaps only need the stats
+	if (m_eColormap != COLORMAP_EQUALIZED)
+		return;
+
+	// Merge the bands bin-slice by bin-slice. The first partial now holds the frame's range
+	m_ePhase = PHASE_MERGE;
+	m_Pool.Run(RunTask, this);
+	m_Bands[0].nDirtyFirst = m_Stats.nMinDepth;
+	m_Bands[0].nDirtyLast = m_Stats.nMaxDepth;
+
+	// The cumulative pass is serial, but only runs over the bins in range
+	BuildLUT();
+}
+
+// Samples the frame on the same grid as the subsampled histogram, but into coarse depth slices,
+// and compares that with the slices of the frame the table was built from.
+// Returns whether the table should be rebuilt, in which case this frame becomes the reference
+XnBool DepthColorizer::CheckDrift()
+{
+	XnUInt32 slices[DRIFT_BINS];
+	memset(slices, 0, sizeof(slices));
+
+	XnUInt32 nSpan = m_nFarClip - m_nNearClip;
+	XnUInt32 nSamples = 0;
+	for (XnUInt32 nY = 0; nY < m_nYRes; nY += m_nSampleStride)
+	{
+		const XnDepthPixel* pRow = m_pDepth + nY*m_nXRes;
+		for (XnUInt32 nX = 0; nX < m_nXRes; nX += m_nSampleStride, ++nSamples)
+		{
+			XnUInt32 nDepth = CLAMP_DEPTH(pRow[nX]);
+			slices[nDepth - m_nNearClip <= nSpan ? (nDepth >> DRIFT_SHIFT) + 1 : 0]++;
+		}
+	}
+
+	m_nTableAge++;
+	if (m_bTableValid && (m_nMaxTableAge == 0 || m_nTableAge < m_nMaxTableAge))
+	{
+		// Every sample that changed slice is counted twice, once where it left and once where it arrived
+		XnUInt32 nMoved = 0;
+		for (XnUInt32 i = 0; i < DRIFT_BINS; ++i)
+		{
+			nMoved += slices[i] > m_DriftReference[i] ? slices[i] - m_DriftReference[i] : m_DriftReference[i] - slices[i];
+		}
+		if (nMoved <= 2*m_fDriftThreshold*nSamples)
+			return false;
+	}
+
+	memcpy(m_DriftReference, slices, sizeof(slices));
+	m_nTableAge = 0;
+	m_bTableValid = true;
+	return true;
+}
+
+void DepthColorizer::RunTask(void* pCookie, XnUInt32 nTask, XnUInt32 nTasks)
+{
+	DepthColorizer* pThis = (DepthColorizer*)pCookie;
+	switch (pThis->m_ePhase)
+	{
+	case PHASE_HISTOGRAM:
+		pThis->HistogramBand(nTask, nTasks);
+		break;
+	case PHASE_MERGE:
+		pThis->MergeBins(nTask, nTasks);
+		break;
+	case PHASE_EXPAND:
+		pThis->ExpandBand(nTask, nTasks);
+		break;
+	}
+}
+
+// Bins nPixels pixels, nStride apart, into four interleaved histograms.
+// Depths outside [nNear, nFar] go to bin 0, together with the missing ones
+static void HistogramScalar(const XnDepthPixel* pDepth, XnUInt32 nPixels, XnUInt32 nStride, XnUInt32 nNear, XnUInt32 nFar,
+							XnUInt32* pHist[PARTIALS_PER_BAND])
+{
+	XnUInt32 nSpan = nFar - nNear;
+
+	// The clip test is a mask rather than a branch, it is unpredictable along object edges
+#define BIN_PIXEL(hist, d)								\
+	{													\
+		XnUInt32 nBin = CLAMP_DEPTH(d);					\
+		hist[nBin & (0 - (XnUInt32)(nBin - nNear <= nSpan))]++;	\
+	}
+
+	XnUInt32 i = 0;
+	for (; i + 4 <= nPixels; i += 4, pDepth += 4*nStride)
+	{
+		BIN_PIXEL(pHist[0], pDepth[0]);
+		BIN_PIXEL(pHist[1], pDepth[nStride]);
+		BIN_PIXEL(pHist[2], pDepth[2*nStride]);
+		BIN_PIXEL(pHist[3], pDepth[3*nStride]);
+	}
+	for (; i < nPixels; ++i, pDepth += nStride)
+	{
+		BIN_PIXEL(pHist[0], pDepth[0]);
+	}
+
+#undef BIN_PIXEL
+}
+
+// Without SIMD, tracking the range per pixel costs more than looking for it in the bins afterwards.
+// The search stops at the nearest and farthest used bin, so it rarely walks the whole table
+static void FindBinRange(XnUInt32* pHist[PARTIALS_PER_BAND], XnUInt32& nMin, XnUInt32& nMax)
+{
+	XnUInt32 nBin = 1;
+	while (nBin < MAX_DEPTH && (pHist[0][nBin] | pHist[1][nBin] | pHist[2][nBin] | pHist[3][nBin]) == 0)
+		++nBin;
+	if (nBin == MAX_DEPTH)
+		return;
+	nMin = nBin;
+
+	nBin = MAX_DEPTH - 1;
+	while ((pHist[0][nBin] | pHist[1][nBin] | pHist[2][nBin] | pHist[3][nBin]) == 0)
+		--nBin;
+	nMax = nBin;
+}
+
+#ifdef XN_CPU_X86
+// Same as HistogramScalar, but also tracks the nearest and farthest depth binned, which is nearly free here
+XN_TARGET("sse4.1") static void HistogramSSE41(const XnDepthPixel* pDepth, XnUInt32 nPixels, XnUInt32 nNear, XnUInt32 nFar,
+											   XnUInt32* pHist[PARTIALS_PER_BAND], XnUInt32& nMin, XnUInt32& nMax)
+{
+	const __m128i maxDepth = _mm_set1_epi16(MAX_DEPTH - 1);
+	const __m128i nearDepth = _mm_set1_epi16((short)nNear);
+	const __m128i farDepth = _mm_set1_epi16((short)nFar);
+	const __m128i one = _mm_set1_epi16(1);
+	__m128i minMinusOne = _mm_set1_epi16(-1);
+	__m128i maxBin = _mm_setzero_si128();
+
+	XnUInt16 bins[8];
+	XnUInt32 i = 0;
+	for (; i + 8 <= nPixels; i += 8)
+	{
+		__m128i d = _mm_min_epu16(_mm_loadu_si128((const __m128i*)(pDepth + i)), maxDepth);
+		// A depth is inside the interaction volume if clamping it to the volume leaves it as is
+		__m128i inside = _mm_cmpeq_epi16(d, _mm_max_epu16(_mm_min_epu16(d, farDepth), nearDepth));
+		d = _mm_and_si128(d, inside);
+
+		maxBin = _mm_max_epu16(maxBin, d);
+		// Bin 0 wraps around to 0xFFFF, so it never wins the minimum
+		minMinusOne = _mm_min_epu16(minMinusOne, _mm_sub_epi16(d, one));
+
+		_mm_storeu_si128((__m128i*)bins, d);
+		pHist[0][bins[0]]++;
+		pHist[1][bins[1]]++;
+		pHist[2][bins[2]]++;
+		pHist[3][bins[3]]++;
+		pHist[0][bins[4]]++;
+		pHist[1][bins[5]]++;
+		pHist[2][bins[6]]++;
+		pHist[3][bins[7]]++;
+	}
+
+	// Horizontal reductions. minpos finds the minimum, and the maximum is the minimum of the complement
+	XnUInt32 nVectorMin = (XnUInt16)_mm_cvtsi128_si32(_mm_minpos_epu16(minMinusOne)) + 1;
+	XnUInt32 nVectorMax = 0xFFFF - (XnUInt16)_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_xor_si128(maxBin, _mm_set1_epi16(-1))));
+	if (nVectorMin < nMin)
+		nMin = nVectorMin;
+	if (nVectorMax > nMax)
+		nMax = nVectorMax;
+
+	for (; i < nPixels; ++i)
+	{
+		XnUInt32 nBin = CLAMP_DEPTH(pDepth[i]);
+		nBin = (nBin >= nNear && nBin <= nFar) ? nBin : 0;
+		pHist[0][nBin]++;
+		if (nBin != 0 && nBin < nMin)
+			nMin = nBin;
+		if (nBin > nMax)
+			nMax = nBin;
+	}
+}
+#endif
+
+void DepthColorizer::HistogramBand(XnUInt32 nBand, XnUInt32 nBands)
+{
+	XnUInt32 nFirstRow = m_nYRes*nBand/nBands;
+	XnUInt32 nLastRow = m_nYRes*(nBand + 1)/nBands;
+	const XnDepthPixel* pDepth = m_pDepth + nFirstRow*m_nXRes;
+
+	XnUInt32* pHist[PARTIALS_PER_BAND];
+	for (XnUInt32 i = 0; i < PARTIALS_PER_BAND; ++i)
+	{
+		pHist[i] = GetPartial(nBand*PARTIALS_PER_BAND + i);
+
+		// Only the bins used by the previous frame need clearing
+		pHist[i][0] = 0;
+		if (m_Bands[nBand].nDirtyFirst <= m_Bands[nBand].nDirtyLast)
+		{
+			memset(pHist[i] + m_Bands[nBand].nDirtyFirst, 0,
+				(m_Bands[nBand].nDirtyLast - m_Bands[nBand].nDirtyFirst + 1)*sizeof(XnUInt32));
+		}
+	}
+
+	XnUInt32 nMin = MAX_DEPTH, nMax = 0;
+	if (m_nStride > 1)
+	{
+		// Sampled rows are on the frame's grid rather than the band's, so the bands add up to the whole subsample
+		XnUInt32 nSamplesPerRow = (m_nXRes + m_nStride - 1)/m_nStride;
+		for (XnUInt32 nY = (nFirstRow + m_nStride - 1)/m_nStride*m_nStride; nY < nLastRow; nY += m_nStride)
+		{
+			HistogramScalar(m_pDepth + nY*m_nXRes, nSamplesPerRow, m_nStride, m_nNearClip, m_nFarClip, pHist);
+		}
+		FindBinRange(pHist, nMin, nMax);
+	}
+	else
+	{
+		XnUInt32 nPixels = (nLastRow - nFirstRow)*m_nXRes;
+#ifdef XN_CPU_X86
+		if (m_eKernel != KERNEL_SCALAR)
+			HistogramSSE41(pDepth, nPixels, m_nNearClip, m_nFarClip, pHist, nMin, nMax);
+		else
+#endif
+		{
+			HistogramScalar(pDepth, nPixels, 1, m_nNearClip, m_nFarClip, pHist);
+			FindBinRange(pHist, nMin, nMax);
+		}
+	}
+
+	m_Bands[nBand].nMin = nMin;
+	m_Bands[nBand].nMax = nMax;
+	m_Bands[nBand].nDirtyFirst = nMin;
+	m_Bands[nBand].nDirtyLast = nMax;
+}
+
+void DepthColorizer::MergeBins(XnUInt32 nSlice, XnUInt32 nSlices)
+{
+	// Only the bins between the nearest and the farthest depth of the frame hold anything
+	XnUInt32 nRange = m_Stats.nMaxDepth - m_Stats.nMinDepth + 1;
+	XnUInt32 nFirstBin = m_Stats.nMinDepth + nRange*nSlice/nSlices;
+	XnUInt32 nLastBin = m_Stats.nMinDepth + nRange*(nSlice + 1)/nSlices;
+	XnUInt32 nPartials = nSlices*PARTIALS_PER_BAND;
+
+	XnUInt32* pMerged = GetPartial(0);
+	for (XnUInt32 nPartial = 1; nPartial < nPartials; ++nPartial)
+	{
+		const XnUInt32* pHist = GetPartial(nPartial);
+		for (XnUInt32 nBin = nFirstBin; nBin < nLastBin; ++nBin)
+		{
+			pMerged[nBin] += pHist[nBin];
+		}
+	}
+}
+
+// Only [nMinDepth, nMaxDepth] is computed. The rest of the clip range is filled with what nearer and farther
+// depths would get, for the pixels a subsample missed and for later frames sharing a cached table
+void DepthColorizer::BuildLUT()
+{
+	const XnUInt32* pHist = GetPartial(0);
+	XnUInt32* pLUT = m_pColormaps[COLORMAP_EQUALIZED];
+	XnUInt32 nValidPoints = m_nBinned;
+	XnUInt32 nCumulative = 0;
+
+	// Nearer than anything binned is 256, which wraps to 0 in the original
+	FillEntries(pLUT, m_nNearClip, m_Stats.nMinDepth, PACK_GREY(m_bBitExact ? 0 : 255));
+	FillEntries(pLUT, m_Stats.nMaxDepth + 1, m_nFarClip + 1, PACK_GREY(0));
+
+	if (m_bBitExact)
+	{
+		// Same expression as the original float histogram. The counts are below 2^24, so they are exact as floats
+		for (XnUInt32 nIndex = m_Stats.nMinDepth; nIndex <= m_Stats.nMaxDepth; nIndex++)
+		{
+			nCumulative += pHist[nIndex];
+			XnUInt32 nHistValue = (unsigned int)(256 * (1.0f - ((float)nCumulative / nValidPoints)));
+			pLUT[nIndex] = PACK_GREY((XnUChar)nHistValue);
+		}
+	}
+	else
+	{
+		// 256 * remaining / valid, with the division replaced by a 32.32 reciprocal
+		XnUInt64 nReciprocal = ((XnUInt64)256 << 32) / nValidPoints;
+		for (XnUInt32 nIndex = m_Stats.nMinDepth; nIndex <= m_Stats.nMaxDepth; nIndex++)
+		{
+			nCumulative += pHist[nIndex];
+			XnUInt32 nHistValue = (XnUInt32)(((nValidPoints - nCumulative) * nReciprocal) >> 32);
+			pLUT[nIndex] = PACK_GREY(nHistValue > 255 ? 255 : nHistValue);
+		}
+	}
+	FillTail(pLUT);
+}
+
+static void ExpandRowScalar(const XnDepthPixel* pSrc, XnUInt32 nCount, const XnUInt32* pLUT, XnUChar* pDst, XnUInt32 nBytesPerPixel)
+{
+	switch (nBytesPerPixel)
+	{
+	case 4:
+		for (XnUInt32 x = 0; x < nCount; ++x, pDst += 4)
+		{
+			XnUInt32 nColor = pLUT[pSrc[x]];
+			memcpy(pDst, &nColor, 4);
+		}
+		break;
+	case 3:
+		for (XnUInt32 x = 0; x < nCount; ++x, pDst += 3)
+		{
+			XnUInt32 nColor = pLUT[pSrc[x]];
+			pDst[0] = (XnUChar)nColor;
+			pDst[1] = (XnUChar)(nColor >> 8);
+			pDst[2] = (XnUChar)(nColor >> 16);
+		}
+		break;
+	default:
+		for (XnUInt32 x = 0; x < nCount; ++x)
+		{
+			pDst[x] = (XnUChar)pLUT[pSrc[x]];
+		}
+		break;
+	}
+}
+
+#ifdef XN_CPU_X86
+// Store 16 RGBA pixels as they are, as 48 bytes of RGB, or as their red bytes only
+XN_TARGET("sse4.1") static void StorePixels(__m128i p0, __m128i p1, __m128i p2, __m128i p3, XnUChar* pDst, XnUInt32 nBytesPerPixel)
+{
+	if (nBytesPerPixel == 4)
+	{
+		_mm_storeu_si128((__m128i*)pDst, p0);
+		_mm_storeu_si128((__m128i*)(pDst + 16), p1);
+		_mm_storeu_si128((__m128i*)(pDst + 32), p2);
+		_mm_storeu_si128((__m128i*)(pDst + 48), p3);
+	}
+	else if (nBytesPerPixel == 3)
+	{
+		// Squeeze out the alpha bytes, then stitch the 12-byte runs together
+		const __m128i dropAlpha = _mm_setr_epi8(0,1,2, 4,5,6, 8,9,10, 12,13,14, -1,-1,-1,-1);
+		p0 = _mm_shuffle_epi8(p0, dropAlpha);
+		p1 = _mm_shuffle_epi8(p1, dropAlpha);
+		p2 = _mm_shuffle_epi8(p2, dropAlpha);
+		p3 = _mm_shuffle_epi8(p3, dropAlpha);
+		_mm_storeu_si128((__m128i*)pDst, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+		_mm_storeu_si128((__m128i*)(pDst + 16), _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+		_mm_storeu_si128((__m128i*)(pDst + 32), _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+	}
+	else
+	{
+		const __m128i red = _mm_set1_epi32(0xFF);
+		__m128i w0 = _mm_packus_epi32(_mm_and_si128(p0, red), _mm_and_si128(p1, red));
+		__m128i w1 = _mm_packus_epi32(_mm_and_si128(p2, red), _mm_and_si128(p3, red));
+		_mm_storeu_si128((__m128i*)pDst, _mm_packus_epi16(w0, w1));
+	}
+}
+
+// SSE has no gather, so the lookups are scalar loads assembled into vectors
+#define LOOKUP4(p) _mm_setr_epi32(pLUT[(p)[0]], pLUT[(p)[1]], pLUT[(p)[2]], pLUT[(p)[3]])
+
+XN_TARGET("sse4.1") static void ExpandRowSSE41(const XnDepthPixel* pSrc, XnUInt32 nCount, const XnUInt32* pLUT, XnUChar* pDst, XnUInt32 nBytesPerPixel)
+{
+	XnUInt32 x = 0;
+	for (; x + 16 <= nCount; x += 16)
+	{
+		const XnDepthPixel* p = pSrc + x;
+		StorePixels(LOOKUP4(p), LOOKUP4(p + 4), LOOKUP4(p + 8), LOOKUP4(p + 12), pDst + x*nBytesPerPixel, nBytesPerPixel);
+	}
+	ExpandRowScalar(pSrc + x, nCount - x, pLUT, pDst + x*nBytesPerPixel, nBytesPerPixel);
+}
+
+#undef LOOKUP4
+
+#ifdef XN_CPU_AVX2_KERNELS
+XN_TARGET("avx2") static void ExpandRowAVX2(const XnDepthPixel* pSrc, XnUInt32 nCount, const XnUInt32* pLUT, XnUChar* pDst, XnUInt32 nBytesPerPixel)
+{
+	XnUInt32 x = 0;
+	for (; x + 16 <= nCount; x += 16)
+	{
+		__m256i d0 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(pSrc + x)));
+		__m256i d1 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(pSrc + x + 8)));
+
+		// One gather per 8 pixels, straight from the RGBA table
+		__m256i g0 = _mm256_i32gather_epi32((const int*)pLUT, d0, 4);
+		__m256i g1 = _mm256_i32gather_epi32((const int*)pLUT, d1, 4);
+
+		StorePixels(_mm256_castsi256_si128(g0), _mm256_extracti128_si256(g0, 1),
+			_mm256_castsi256_si128(g1), _mm256_extracti128_si256(g1, 1), pDst + x*nBytesPerPixel, nBytesPerPixel);
+	}
+	ExpandRowScalar(pSrc + x, nCount - x, pLUT, pDst + x*nBytesPerPixel, nBytesPerPixel);
+}
+#endif
+#endif
+
+static XnBool RowChangedScalar(const XnUChar* pNew, const XnUChar* pOld, XnUInt32 nBytes)
+{
+	return memcmp(pNew, pOld, nBytes) != 0;
+}
+
+#ifdef XN_CPU_X86
+// 64 bytes per iteration, stopping at the first difference
+XN_TARGET("sse4.1") static XnBool RowChangedSSE41(const XnUChar* pNew, const XnUChar* pOld, XnUInt32 nBytes)
+{
+	XnUInt32 i = 0;
+	for (; i + 64 <= nBytes; i += 64)
+	{
+		__m128i x0 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(pNew + i)), _mm_loadu_si128((const __m128i*)(pOld + i)));
+		__m128i x1 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(pNew + i + 16)), _mm_loadu_si128((const __m128i*)(pOld + i + 16)));
+		__m128i x2 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(pNew + i + 32)), _mm_loadu_si128((const __m128i*)(pOld + i + 32)));
+		__m128i x3 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(pNew + i + 48)), _mm_loadu_si128((const __m128i*)(pOld + i + 48)));
+		__m128i any = _mm_or_si128(_mm_or_si128(x0, x1), _mm_or_si128(x2, x3));
+		if (!_mm_testz_si128(any, any))
+			return true;
+	}
+	return RowChangedScalar(pNew + i, pOld + i, nBytes - i);
+}
+#endif
+
+void DepthColorizer::ExpandBand(XnUInt32 nBand, XnUInt32 nBands) const
+{
+	void (*pExpandRow)(const XnDepthPixel*, XnUInt32, const XnUInt32*, XnUChar*, XnUInt32) = ExpandRowScalar;
+#ifdef XN_CPU_X86
+	if (m_eKernel == KERNEL_SSE41)
+		pExpandRow = ExpandRowSSE41;
+#ifdef XN_CPU_AVX2_KERNELS
+	if (m_eKernel == KERNEL_AVX2)
+		pExpandRow = ExpandRowAVX2;
+#endif
+#endif
+
+	const XnUInt32* pLUT = m_pColormaps[m_eColormap];
+	XnUInt32 nFirstRow = m_nYRes*nBand/nBands;
+	XnUInt32 nLastRow = m_nYRes*(nBand + 1)/nBands;
+	if (m_pDirtyRows == NULL)
+	{
+		for (XnUInt32 nY = nFirstRow; nY < nLastRow; ++nY)
+		{
+			pExpandRow(m_pDepth + nY*m_nXRes, m_nXRes, pLUT, m_pDest + nY*m_nPitch, m_nBytesPerPixel);
+		}
+		return;
+	}
+
+	XnBool (*pRowChanged)(const XnUChar*, const XnUChar*, XnUInt32) = RowChangedScalar;
+#ifdef XN_CPU_X86
+	if (m_eKernel != KERNEL_SCALAR)
+		pRowChanged = RowChangedSSE41;
+#endif
+
+	// Expand into the scratch row while it is in cache, and only write rows that differ from the previous frame
+	XnUChar* pScratch = m_pScratch + nBand*m_nScratchRowSize;
+	XnUInt32 nRowSize = m_nXRes*m_nBytesPerPixel;
+	for (XnUInt32 nY = nFirstRow; nY < nLastRow; ++nY)
+	{
+		pExpandRow(m_pDepth + nY*m_nXRes, m_nXRes, pLUT, pScratch, m_nBytesPerPixel);
+		XnBool bChanged = pRowChanged(pScratch, m_pDest + nY*m_nPitch, nRowSize);
+		if (bChanged)
+			memcpy(m_pDest + nY*m_nPitch, pScratch, nRowSize);
+		m_pDirtyRows[nY] = (XnUChar)bChanged;
+	}
+}
+
+void DepthColorizer::Benchmark(const XnDepthPixel* pDepth, XnUInt32 nXRes, XnUInt32 nYRes, XnUInt32 nIterations)
+{
+	XnUInt32 nSize = nXRes*nYRes*3;
+	XnUChar* pReference = new XnUChar[nSize];
+	XnUChar* pOutput = new XnUChar[nSize];
+
+	Kernel eOriginal = m_eKernel;
+	XnUInt32 nOriginalThreads = GetThreadCount();
+	HistogramPolicy eOriginalPolicy = m_ePolicy;
+	Counters savedCounters = m_Counters;
+	XnUInt64 nSavedFullTime = m_nFullTime, nSavedFullPixels = m_nFullPixels;
+
+	printf("Depth colorizer benchmark, %ux%u, %u iterations, %s table\n", nXRes, nYRes, nIterations, m_bBitExact ? "bit-exact" : "fixed point");
+
+	// Every iteration builds its own histogram, so the kernels are compared on the same work
+	SetHistogramPolicy(HISTOGRAM_FULL);
+	SetThreadCount(1);
+	m_eKernel = KERNEL_SCALAR;
+	Colorize(pDepth, nXRes, nYRes, pReference, 3, nXRes*3);
+
+	Kernel kernels[] = {KERNEL_SCALAR, KERNEL_SSE41, KERNEL_AVX2};
+	for (XnUInt32 k = 0; k < sizeof(kernels)/sizeof(kernels[0]); ++k)
+	{
+		if (!IsSupported(kernels[k]))
+		{
+			printf("  %-8s not supported\n", GetKernelName(kernels[k]));
+			continue;
+		}
+
+		m_eKernel = kernels[k];
+		ResetStats();
+		for (XnUInt32 i = 0; i < nIterations; ++i)
+		{
+			Colorize(pDepth, nXRes, nYRes, pOutput, 3, nXRes*3);
+		}
+
+		printf("  %-8s %6.3f ns/pixel %s\n", GetKernelName(kernels[k]), GetNsPerPixel(),
+			memcmp(pOutput, pReference, nSize) == 0 ? "" : "(OUTPUT MISMATCH)");
+	}
+
+	// Thread scaling, with the best kernel
+	m_eKernel = BestKernel();
+	for (XnUInt32 nThreads = 1; nThreads <= GetCpuFeatures().nLogicalCores && nThreads <= MAX_POOL_THREADS; nThreads *= 2)
+	{
+		SetThreadCount(nThreads);
+		ResetStats();
+		for (XnUInt32 i = 0; i < nIterations; ++i)
+		{
+			Colorize(pDepth, nXRes, nYRes, pOutput, 3, nXRes*3);
+		}
+
+		printf("  %2u threads %6.3f ns/pixel %s\n", nThreads, GetNsPerPixel(),
+			memcmp(pOutput, pReference, nSize) == 0 ? "" : "(OUTPUT MISMATCH)");
+	}
+
+	SetThreadCount(nOriginalThreads);
+	m_eKernel = eOriginal;
+	SetHistogramPolicy(eOriginalPolicy);
+	m_Counters = savedCounters;
+	m_nFullTime = nSavedFullTime;
+	m_nFullPixels = nSavedFullPixels;
+
+	delete []pReference;
+	delete []pOutput;
+}
@@ -0,0 +1,253 @@
+#ifndef DEPTH_COLORIZER_H_
+#define DEPTH_COLORIZER_H_
+
+#include <XnCppWrapper.h>
+#include "WorkerPool.h"
+
+#define MAX_DEPTH 10000
+#define PARTIALS_PER_BAND 4
+// Colormaps are indexed by the raw depth, so no depth needs clamping on the way out
+#define COLORMAP_ENTRIES 65536
+// The drift check bins samples into 128mm slices, plus one slice for missing depth
+#define DRIFT_SHIFT 7
+#define DRIFT_BINS (((MAX_DEPTH - 1) >> DRIFT_SHIFT) + 2)
+
+/**
+ * What the colorizer saw in the last frame, gathered during its histogram pass
+ */
+typedef struct DepthFrameStats
+{
+	// Nearest and farthest depth inside the clip range. Both 0 when there were no valid pixels
+	XnDepthPixel nMinDepth;
+	XnDepthPixel nMaxDepth;
+	// Pixels with a depth inside the clip range
+	XnUInt32 nValidPixels;
+} DepthFrameStats;
+
+/**
+ * Turns depth frames into colors, through a table of packed RGBA per depth value.
+ * The default table is histogram-equalized grey: nearer pixels are brighter, pixels with no depth are black.
+ * The expansion pass uses the widest SIMD kernel the CPU supports, and the frame
+ * is split into row bands over a pool of threads.
+ */
+class DepthColorizer
+{
+public:
+	typedef enum
+	{
+		KERNEL_SCALAR,
+		KERNEL_SSE41,
+		KERNEL_AVX2
+	} Kernel;
+
+	typedef enum
+	{
+		// Bin every pixel of every frame
+		HISTOGRAM_FULL,
+		// Bin one pixel in SampleStride of one row in SampleStride, every frame
+		HISTOGRAM_SUBSAMPLED,
+		// Keep the table until the depth distribution drifts away from it, or it gets too old
+		HISTOGRAM_CACHED
+	} HistogramPolicy;
+
+	typedef enum
+	{
+		// Histogram-equalized grey, rebuilt as the histogram policy says
+		COLORMAP_EQUALIZED,
+		// Grey, linear over the colormap range
+		COLORMAP_LINEAR,
+		// Turbo false color over the colormap range, red when near and blue when far
+		COLORMAP_TURBO,
+		COLORMAP_COUNT
+	} Colormap;
+
+	DepthColorizer();
+	~DepthColorizer();
+
+	/**
+	 * Colorize a whole frame into pDest, destination rows are nPitch bytes apart.
+	 * nBytesPerPixel is 4 for RGBA, 3 for RGB or 1 for the red channel alone, which is the intensity of the grey colormaps.
+	 * With pDirtyRows, pDest must hold the previous frame: only the rows that changed are written,
+	 * and pDirtyRows[y] tells whether row y did.
+	 */
+	void Colorize(const XnDepthPixel* pDepth, XnUInt32 nXRes, XnUInt32 nYRes,
+		XnUChar* pDest, XnUInt32 nBytesPerPixel, XnUInt32 nPitch, XnUChar* pDirtyRows = NULL);
+
+	/**
+	 * Bit-exact mode reproduces the original float equalization, byte for byte.
+	 * Otherwise the table is computed in fixed point, and the nearest bin saturates at 255 instead of wrapping to 0.
+	 */
+	void SetBitExact(XnBool bBitExact);
+	XnBool IsBitExact() const;
+
+	/**
+	 * Force a kernel. Falls back to the best supported one if this CPU lacks it.
+	 */
+	void SetKernel(Kernel eKernel);
+	Kernel GetKernel() const;
+	static const XnChar* GetKernelName(Kernel eKernel);
+
+	/**
+	 * Limit the frame to an interaction volume. Depths outside [nNear, nFar] are treated as missing:
+	 * they are black and left out of the histogram and the stats.
+	 */
+	void SetClipRange(XnDepthPixel nNear, XnDepthPixel nFar);
+	void ClearClipRange();
+	XnBool IsClipping() const;
+
+	/**
+	 * Switch to another colormap. All of them are kept up to date, so this only swaps tables
+	 */
+	void SetColormap(Colormap eColormap);
+	Colormap GetColormap() const;
+	static const XnChar* GetColormapName(Colormap eColormap);
+	/**
+	 * Whether the current colormap only has shades of grey, so its pixels can be written as one byte
+	 */
+	XnBool IsGreyColormap() const;
+	/**
+	 * Depth range spread over the linear and false color maps. Depths outside it get the color of the nearest end
+	 */
+	void SetColormapRange(XnDepthPixel nNear, XnDepthPixel nFar);
+
+	/**
+	 * Stats of the last colorized frame
+	 */
+	const DepthFrameStats& GetFrameStats() const;
+
+	/**
+	 * How the equalization table follows the frames. The subsampled and cached policies skip most of
+	 * the histogram pass, at the cost of a less accurate table.
+	 * With the cached policy the frame stats are those of the frame the table was built from.
+	 */
+	void SetHistogramPolicy(HistogramPolicy ePolicy);
+	HistogramPolicy GetHistogramPolicy() const;
+	static const XnChar* GetHistogramPolicyName(HistogramPolicy ePolicy);
+	/**
+	 * Distance between samples, in pixels and in rows, of the subsampled histogram and of the drift check
+	 */
+	void SetSampleStride(XnUInt32 nStride);
+	/**
+	 * The cached table is rebuilt once the share of samples that changed 128mm depth slice goes
+	 * over fThreshold, or after nMaxAge frames (0 for no limit)
+	 */
+	void SetDriftThreshold(XnFloat fThreshold);
+	void SetMaxTableAge(XnUInt32 nMaxAge);
+
+	/**
+	 * Number of threads (the caller included) sharing every frame. 0 means one per core
+	 */
+	XnStatus SetThreadCount(XnUInt32 nThreads);
+	XnUInt32 GetThreadCount() const;
+
+	/**
+	 * Average cost of Colorize since the last reset
+	 */
+	XnDouble GetNsPerPixel() const;
+	/**
+	 * Frames colorized and histograms built in full since the last reset, and the CPU time the histogram
+	 * policy saved compared to full builds (estimated from the measured cost of the full builds)
+	 */
+	XnUInt32 GetFrameCount() const;
+	XnUInt32 GetRebuildCount() const;
+	XnDouble GetSavedMs() const;
+	void ResetStats();
+
+	/**
+	 * Run every supported kernel nIterations times on the given frame, check it against the
+	 * scalar output and print the cost in ns/pixel. Then do the same for growing thread counts.
+	 */
+	void Benchmark(const XnDepthPixel* pDepth, XnUInt32 nXRes, XnUInt32 nYRes, XnUInt32 nIterations);
+protected:
+	typedef enum
+	{
+		PHASE_HISTOGRAM,
+		PHASE_MERGE,
+		PHASE_EXPAND
+	} Phase;
+
+	static void RunTask(void* pCookie, XnUInt32 nTask, XnUInt32 nTasks);
+	void HistogramBand(XnUInt32 nBand, XnUInt32 nBands);
+	void MergeBins(XnUInt32 nSlice, XnUInt32 nSlices);
+	void ExpandBand(XnUInt32 nBand, XnUInt32 nBands) const;
+	void BuildHistogram(XnUInt32 nStride);
+	XnBool CheckDrift();
+	void BuildLUT();
+	void BuildFixedColormaps();
+
+	XnUInt32* GetPartial(XnUInt32 nPartial) const;
+
+	static Kernel BestKernel();
+	static XnBool IsSupported(Kernel eKernel);
+
+	WorkerPool m_Pool;
+	Phase m_ePhase;
+
+	// The frame being colorized, shared with the pool threads
+	const XnDepthPixel* m_pDepth;
+	XnUInt32 m_nXRes;
+	XnUInt32 m_nYRes;
+	XnUChar* m_pDest;
+	XnUInt32 m_nBytesPerPixel;
+	XnUInt32 m_nPitch;
+	XnUChar* m_pDirtyRows;
+	// Rows are expanded here first when tracking changes, one row per band
+	XnUChar* m_pScratch;
+	XnUInt32 m_nScratchRowSize;
+
+	// Private histograms, PARTIALS_PER_BAND for every band. Interleaving them keeps runs of
+	// equal depth from serializing on one counter. They are summed into the first one.
+	XnUInt32* m_pPartials;
+
+	typedef struct
+	{
+		// Depth range binned by the band in this frame
+		XnUInt32 nMin;
+		XnUInt32 nMax;
+		// Bins of the band's partials that must be cleared before the next frame
+		XnUInt32 nDirtyFirst;
+		XnUInt32 nDirtyLast;
+	} Band;
+	Band m_Bands[MAX_POOL_THREADS];
+	// Pixels sampled by the histogram pass, 1 for all of them
+	XnUInt32 m_nStride;
+	// Entries in the merged histogram, which may be a subsample of the valid pixels
+	XnUInt32 m_nBinned;
+
+	XnDepthPixel m_nNearClip;
+	XnDepthPixel m_nFarClip;
+	DepthFrameStats m_Stats;
+
+	Kernel m_eKernel;
+	XnBool m_bBitExact;
+
+	HistogramPolicy m_ePolicy;
+	XnUInt32 m_nSampleStride;
+	XnFloat m_fDriftThreshold;
+	XnUInt32 m_nMaxTableAge;
+	// Cached policy: whether the table still matches the settings, and how it was built
+	XnBool m_bTableValid;
+	XnUInt32 m_nTableAge;
+	XnUInt32 m_DriftReference[DRIFT_BINS];
+
+	// RGBA per depth value, for every colormap
+	XnUInt32* m_pColormaps[COLORMAP_COUNT];
+	Colormap m_eColormap;
+	XnDepthPixel m_nColormapNear;
+	XnDepthPixel m_nColormapFar;
+
+	typedef struct
+	{
+		XnUInt64 nTime;
+		XnUInt64 nPixels;
+		XnUInt32 nFrames;
+		XnUInt32 nRebuilds;
+		XnInt64 nSavedTime;
+	} Counters;
+	Counters m_Counters;
+	// Cost of the full histogram builds so far, never reset
+	XnUInt64 m_nFullTime;
+	XnUInt64 m_nFullPixels;
+};
+
+#endif
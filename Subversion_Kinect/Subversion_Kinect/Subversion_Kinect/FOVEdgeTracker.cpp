@@ -0,0 +1,42 @@
+#include "FOVEdgeTracker.h"
+
+// Generation 0 is never open, so the zeroed entries start out stale
+FOVEdgeTracker::FOVEdgeTracker() :
+	m_nGeneration(2)
+{
+	for (XnUInt32 nSlot = 0; nSlot < MAX_HANDS; ++nSlot)
+	{
+		for (XnUInt32 i = 0; i < 2; ++i)
+		{
+			m_Entries[nSlot][i].nID = 0;
+			m_Entries[nSlot][i].nGeneration = 0;
+			m_Entries[nSlot][i].eDirection = XN_DIRECTION_ILLEGAL;
+		}
+	}
+}
+
+void FOVEdgeTracker::Report(XnUInt32 nSlot, XnUInt32 nID, XnDirection eDirection)
+{
+	if (nSlot >= MAX_HANDS)
+		return;
+	// The other entry of the slot holds the closed generation, still being read
+	Entry& entry = m_Entries[nSlot][m_nGeneration & 1];
+	entry.nID = nID;
+	entry.eDirection = eDirection;
+	entry.nGeneration = m_nGeneration;
+}
+
+void FOVEdgeTracker::EndUpdate()
+{
+	m_nGeneration++;
+}
+
+XnDirection FOVEdgeTracker::Get(XnUInt32 nSlot, XnUInt32 nID) const
+{
+	if (nSlot >= MAX_HANDS)
+		return XN_DIRECTION_ILLEGAL;
+	const Entry& entry = m_Entries[nSlot][(m_nGeneration - 1) & 1];
+	if (entry.nGeneration + 1 == m_nGeneration && entry.nID == nID)
+		return entry.eDirection;
+	return XN_DIRECTION_ILLEGAL;
+}
@@ -0,0 +1,49 @@
+#ifndef FOV_EDGE_TRACKER_H_
+#define FOV_EDGE_TRACKER_H_
+
+#include <XnPlatform.h>
+#include <XnTypes.h>
+#include "HandTable.h"
+
+/**
+ * The hands reported at the edge of the field of view, and which edge, one NITE update at a time.
+ * Entries are indexed by the hand's slot in the drawer's HandRing, one per generation: reports go to the open
+ * generation's; EndUpdate closes it, and Get reads the closed one's until the next EndUpdate.
+ * Entries are stamped with their generation and hand instead of being cleared, so nothing is freed or allocated per
+ * frame, and a slot taken over by another hand does not inherit its edge.
+ * Report is called from the touching callback on the acquisition thread and EndUpdate/Get from the NITE update:
+ * both run under the context lock, which keeps them apart.
+ */
+class FOVEdgeTracker
+{
+public:
+	FOVEdgeTracker();
+
+	/**
+	 * Hand nID, in nSlot, touches the eDirection edge. A second report of the same hand in an update replaces the first.
+	 * Ignored for INVALID_HAND_SLOT, a hand not in the table yet
+	 */
+	void Report(XnUInt32 nSlot, XnUInt32 nID, XnDirection eDirection);
+	/**
+	 * The reports so far become the ones Get sees
+	 */
+	void EndUpdate();
+	/**
+	 * The edge hand nID, in nSlot, touched in the last closed update, XN_DIRECTION_ILLEGAL if none
+	 */
+	XnDirection Get(XnUInt32 nSlot, XnUInt32 nID) const;
+protected:
+	typedef struct
+	{
+		XnUInt32 nID;
+		XnUInt32 nGeneration;
+		XnDirection eDirection;
+	} Entry;
+
+	// Per slot, the entry of the even generations and the one of the odd ones: the open one and the closed one
+	Entry m_Entries[MAX_HANDS][2];
+	// The open generation. m_nGeneration - 1 is the closed one, anything older is stale
+	XnUInt32 m_nGeneration;
+};
+
+#endif
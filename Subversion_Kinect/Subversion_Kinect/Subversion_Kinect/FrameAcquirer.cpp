@@ -0,0 +1,183 @@
+#include "FrameAcquirer.h"
+#include "Atomics.h"
+#include <stdio.h>
+#include <string.h>
+
+#define FRESH_FRAME 0x80000000
+// How long the acquisition thread waits for the sensor before checking whether it should stop
+#define NEW_DATA_TIMEOUT 100
+
+FrameAcquirer::FrameAcquirer() :
+	m_pContext(NULL), m_hNewDataCallback(NULL), m_pFrameHandler(NULL), m_pFrameCookie(NULL), m_hThread(NULL), m_bStop(false), m_bRunning(false),
+	m_nBack(0), m_nFront(1), m_nMiddle(2), m_bHaveFrame(false), m_nProduced(0), m_nConsumed(0), m_nDropped(0)
+{
+	memset(m_Frames, 0, sizeof(m_Frames));
+	xnOSCreateEvent(&m_hNewData, false);
+	xnOSCreateCriticalSection(&m_hContextLock);
+}
+
+FrameAcquirer::~FrameAcquirer()
+{
+	Stop();
+	for (XnUInt32 i = 0; i < 3; ++i)
+	{
+		delete []m_Frames[i].pDepth;
+	}
+	xnOSCloseCriticalSection(&m_hContextLock);
+	xnOSCloseEvent(&m_hNewData);
+}
+
+void FrameAcquirer::SetFrameHandler(FrameHandler pHandler, void* pCookie)
+{
+	m_pFrameHandler = pHandler;
+	m_pFrameCookie = pCookie;
+}
+
+XnStatus FrameAcquirer::Start(xn::Context& context, xn::DepthGenerator& depthGenerator)
+{
+	m_pContext = &context;
+	m_DepthGenerator = depthGenerator;
+
+	XnStatus rc = m_DepthGenerator.RegisterToNewDataAvailable(OnNewData, this, m_hNewDataCallback);
+	if (rc == XN_STATUS_OK)
+	{
+		m_bStop = false;
+		rc = xnOSCreateThread(AcquisitionThread, this, &m_hThread);
+		if (rc != XN_STATUS_OK)
+			m_DepthGenerator.UnregisterFromNewDataAvailable(m_hNewDataCallback);
+	}
+	if (rc != XN_STATUS_OK)
+	{
+		printf("Acquisition thread creation failed: %s\n", xnGetStatusString(rc));
+		return rc;
+	}
+
+	m_bRunning = true;
+	return XN_STATUS_OK;
+}
+
+void FrameAcquirer::Stop()
+{
+	if (!m_bRunning)
+		return;
+
+	m_bStop = true;
+	xnOSSetEvent(m_hNewData);
+	xnOSWaitForThreadExit(m_hThread, XN_WAIT_INFINITE);
+	xnOSCloseThread(&m_hThread);
+	m_DepthGenerator.UnregisterFromNewDataAvailable(m_hNewDataCallback);
+	m_bRunning = false;
+}
+
+void FrameAcquirer::LockContext()
+{
+	xnOSEnterCriticalSection(&m_hContextLock);
+}
+void FrameAcquirer::UnlockContext()
+{
+	xnOSLeaveCriticalSection(&m_hContextLock);
+}
+xn::Context* FrameAcquirer::GetContext() const
+{
+	return m_pContext;
+}
+
+XnUInt32 FrameAcquirer::GetProducedCount() const
+{
+	return m_nProduced;
+}
+XnUInt32 FrameAcquirer::GetConsumedCount() const
+{
+	return m_nConsumed;
+}
+XnUInt32 FrameAcquirer::GetDroppedCount() const
+{
+	return m_nDropped;
+}
+
+// Called from the driver's thread. The update itself is left to the acquisition thread, under the context lock
+void XN_CALLBACK_TYPE FrameAcquirer::OnNewData(xn::ProductionNode& node, void* pCookie)
+{
+	xnOSSetEvent(((FrameAcquirer*)pCookie)->m_hNewData);
+}
+
+XN_THREAD_PROC FrameAcquirer::AcquisitionThread(XN_THREAD_PARAM pParam)
+{
+	((FrameAcquirer*)pParam)->AcquisitionLoop();
+	XN_THREAD_PROC_RETURN(XN_STATUS_OK);
+}
+
+void FrameAcquirer::AcquisitionLoop()
+{
+	while (!m_bStop)
+	{
+		// The timeout keeps Stop from hanging when the sensor went away
+		if (xnOSWaitEvent(m_hNewData, NEW_DATA_TIMEOUT) != XN_STATUS_OK || m_bStop)
+			continue;
+
+		// The depth is already there, so this only swaps the new data in
+		LockContext();
+		XnStatus rc = m_pContext->WaitNoneUpdateAll();
+		if (rc == XN_STATUS_OK)
+		{
+			xn::DepthMetaData depthMD;
+			m_DepthGenerator.GetMetaData(depthMD);
+			CopyFrame(depthMD, m_Frames[m_nBack]);
+		}
+		UnlockContext();
+
+		if (rc == XN_STATUS_OK)
+		{
+			Publish();
+			if (m_pFrameHandler != NULL)
+				m_pFrameHandler(m_pFrameCookie);
+		}
+	}
+}
+
+void FrameAcquirer::CopyFrame(const xn::DepthMetaData& depthMD, DepthFrame& frame)
+{
+	// Frames go round all three slots, each one is resized when it comes back to the acquisition thread
+	if (frame.pDepth == NULL || frame.nXRes != depthMD.XRes() || frame.nYRes != depthMD.YRes())
+	{
+		delete []frame.pDepth;
+		frame.pDepth = new XnDepthPixel[depthMD.XRes()*depthMD.YRes()];
+		frame.nXRes = depthMD.XRes();
+		frame.nYRes = depthMD.YRes();
+	}
+
+	memcpy(frame.pDepth, depthMD.Data(), depthMD.XRes()*depthMD.YRes()*sizeof(XnDepthPixel));
+	frame.nFrameID = depthMD.FrameID();
+	frame.nTimestamp = depthMD.Timestamp();
+}
+
+void FrameAcquirer::Publish()
+{
+	XnUInt32 nPrevious = AtomicExchange(&m_nMiddle, m_nBack | FRESH_FRAME);
+	// The reader never saw the frame that was waiting there
+	if (nPrevious & FRESH_FRAME)
+		AtomicIncrement(&m_nDropped);
+	m_nBack = nPrevious & ~FRESH_FRAME;
+	AtomicIncrement(&m_nProduced);
+}
+
+const DepthFrame* FrameAcquirer::GetLatestFrame(XnBool& bNew)
+{
+	bNew = false;
+	// Only the acquisition thread sets the flag, so once it is seen, the exchange below gets a fresh frame:
+	// this one, or one published right after it
+	if (AtomicLoad(&m_nMiddle) & FRESH_FRAME)
+	{
+		m_nFront = AtomicExchange(&m_nMiddle, m_nFront) & ~FRESH_FRAME;
+		AtomicIncrement(&m_nConsumed);
+		m_bHaveFrame = true;
+		bNew = true;
+	}
+
+	return GetCurrentFrame();
+}
+
+const DepthFrame* FrameAcquirer::GetCurrentFrame() const
+{
+	return m_bHaveFrame ? &m_Frames[m_nFront] : NULL;
+}
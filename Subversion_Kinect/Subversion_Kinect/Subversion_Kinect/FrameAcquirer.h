@@ -0,0 +1,104 @@
+#ifndef FRAME_ACQUIRER_H_
+#define FRAME_ACQUIRER_H_
+
+#include <XnCppWrapper.h>
+#include <XnOS.h>
+
+/**
+ * A depth frame, copied out of the generator
+ */
+typedef struct DepthFrame
+{
+	XnDepthPixel* pDepth;
+	XnUInt32 nXRes;
+	XnUInt32 nYRes;
+	XnUInt32 nFrameID;
+	XnUInt64 nTimestamp;
+} DepthFrame;
+
+/**
+ * Reads the sensor on a thread of its own, so drawing never waits for the device.
+ * Every depth frame is copied into a triple buffer: the reader always gets the newest complete frame
+ * without taking a lock, and a frame replaced before anyone read it is dropped rather than queued.
+ * The context is updated on the acquisition thread, so whoever else reads node data from it (NITE)
+ * must do it between LockContext and UnlockContext.
+ */
+class FrameAcquirer
+{
+public:
+	/**
+	 * Called on the acquisition thread after every frame it publishes
+	 */
+	typedef void (*FrameHandler)(void* pCookie);
+
+	FrameAcquirer();
+	~FrameAcquirer();
+
+	/**
+	 * Set before Start, whoever else must follow the frames (the NITE worker)
+	 */
+	void SetFrameHandler(FrameHandler pHandler, void* pCookie);
+
+	/**
+	 * Start acquiring. The context must be generating already
+	 */
+	XnStatus Start(xn::Context& context, xn::DepthGenerator& depthGenerator);
+	void Stop();
+
+	/**
+	 * Take the newest complete frame. Never blocks.
+	 * bNew tells whether it arrived since the last call, when it did not the previous frame is returned again.
+	 * NULL until the first frame arrived.
+	 */
+	const DepthFrame* GetLatestFrame(XnBool& bNew);
+	/**
+	 * The frame the last GetLatestFrame returned, from the thread that called it
+	 */
+	const DepthFrame* GetCurrentFrame() const;
+
+	/**
+	 * Keep the acquisition thread from updating the context
+	 */
+	void LockContext();
+	void UnlockContext();
+	xn::Context* GetContext() const;
+
+	/**
+	 * Frames published by the acquisition thread, taken by GetLatestFrame, and replaced before they were taken
+	 */
+	XnUInt32 GetProducedCount() const;
+	XnUInt32 GetConsumedCount() const;
+	XnUInt32 GetDroppedCount() const;
+protected:
+	static void XN_CALLBACK_TYPE OnNewData(xn::ProductionNode& node, void* pCookie);
+	static XN_THREAD_PROC AcquisitionThread(XN_THREAD_PARAM pParam);
+	void AcquisitionLoop();
+	void CopyFrame(const xn::DepthMetaData& depthMD, DepthFrame& frame);
+	void Publish();
+
+	xn::Context* m_pContext;
+	xn::DepthGenerator m_DepthGenerator;
+	XnCallbackHandle m_hNewDataCallback;
+	FrameHandler m_pFrameHandler;
+	void* m_pFrameCookie;
+
+	XN_THREAD_HANDLE m_hThread;
+	XN_EVENT_HANDLE m_hNewData;
+	XN_CRITICAL_SECTION_HANDLE m_hContextLock;
+	volatile XnBool m_bStop;
+	XnBool m_bRunning;
+
+	// The acquisition thread fills m_nBack, the reader draws m_nFront, and they swap with m_nMiddle.
+	// m_nMiddle carries FRESH_FRAME while it holds a frame the reader has not taken yet.
+	DepthFrame m_Frames[3];
+	XnUInt32 m_nBack;
+	XnUInt32 m_nFront;
+	volatile XnUInt32 m_nMiddle;
+	XnBool m_bHaveFrame;
+
+	volatile XnUInt32 m_nProduced;
+	volatile XnUInt32 m_nConsumed;
+	volatile XnUInt32 m_nDropped;
+};
+
+#endif
@@ -0,0 +1,312 @@
+#include "FrameScheduler.h"
+#include "Atomics.h"
+#include <stdio.h>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <sys/resource.h>
+#endif
+
+// How often a polled loop looks for notifications when it does not follow the frames, in ms
+#define WATCH_INTERVAL 100
+
+// The soak's sensor and input, like the real ones
+#define SOAK_FRAME_MS 33
+#define SOAK_INPUT_POLL_MS 100
+
+// CPU time the whole process took, all threads, in us
+static XnUInt64 GetProcessCpuTime()
+{
+#ifdef _WIN32
+	FILETIME creation, exit, kernel, user;
+	if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+		return 0;
+	ULARGE_INTEGER nKernel, nUser;
+	nKernel.LowPart = kernel.dwLowDateTime;
+	nKernel.HighPart = kernel.dwHighDateTime;
+	nUser.LowPart = user.dwLowDateTime;
+	nUser.HighPart = user.dwHighDateTime;
+	// In 100 ns units
+	return (nKernel.QuadPart + nUser.QuadPart)/10;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+	return (XnUInt64)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec)*1000000 + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#endif
+}
+
+FrameScheduler::FrameScheduler() :
+	m_fRefreshRate(60), m_nIntervals(1), m_bPolled(false), m_nFramePending(0), m_nChangePending(0),
+	m_bFollowingFrames(true), m_bPaused(false), m_bDrawPending(true), m_nAnimateUntil(0),
+	m_bStarted(false), m_nGridOrigin(0), m_nNextSlot(0)
+{
+	xnOSCreateEvent(&m_hWake, false);
+	ResetStats();
+}
+
+FrameScheduler::~FrameScheduler()
+{
+	xnOSCloseEvent(&m_hWake);
+}
+
+void FrameScheduler::SetRefreshRate(XnFloat fHz)
+{
+	XnFloat fMaxRate = GetMaxRate();
+	m_fRefreshRate = fHz > 1 ? fHz : 1;
+	SetMaxRate(fMaxRate);
+}
+XnFloat FrameScheduler::GetRefreshRate() const
+{
+	return m_fRefreshRate;
+}
+
+void FrameScheduler::SetMaxRate(XnFloat fHz)
+{
+	// The fewest whole refresh intervals that keep under the cap. A little slack for rates like 59.94
+	m_nIntervals = 1;
+	while (fHz > 0 && m_fRefreshRate/m_nIntervals > fHz*1.01f)
+		m_nIntervals++;
+}
+XnFloat FrameScheduler::GetMaxRate() const
+{
+	return m_fRefreshRate/m_nIntervals;
+}
+
+void FrameScheduler::SetPolled(XnBool bPolled)
+{
+	m_bPolled = bPolled;
+}
+
+void FrameScheduler::NotifyFrame()
+{
+	AtomicExchange(&m_nFramePending, 1);
+	xnOSSetEvent(m_hWake);
+}
+
+void FrameScheduler::NotifyChange()
+{
+	AtomicExchange(&m_nChangePending, 1);
+	xnOSSetEvent(m_hWake);
+}
+
+void FrameScheduler::SetFollowingFrames(XnBool bFollowing)
+{
+	m_bFollowingFrames = bFollowing;
+}
+
+void FrameScheduler::SetPaused(XnBool bPaused)
+{
+	m_bPaused = bPaused;
+}
+
+void FrameScheduler::NotifyInput()
+{
+	m_bDrawPending = true;
+}
+
+void FrameScheduler::Animate(XnUInt32 nMs)
+{
+	XnUInt64 nNow;
+	xnOSGetHighResTimeStamp(&nNow);
+	if (nNow + nMs*1000 > m_nAnimateUntil)
+		m_nAnimateUntil = nNow + nMs*1000;
+}
+
+XnUInt64 FrameScheduler::GetPeriod() const
+{
+	return (XnUInt64)(1000000*m_nIntervals/m_fRefreshRate);
+}
+
+XnUInt32 FrameScheduler::Tick(XnBool& bDraw)
+{
+	XnUInt64 nNow;
+	xnOSGetHighResTimeStamp(&nNow);
+	m_nWakeups++;
+	if (!m_bStarted)
+	{
+		m_nGridOrigin = m_nNextSlot = nNow;
+		m_bStarted = true;
+	}
+
+	if (AtomicExchange(&m_nChangePending, 0) != 0)
+		m_bDrawPending = true;
+	if (AtomicExchange(&m_nFramePending, 0) != 0 && m_bFollowingFrames && !m_bPaused)
+		m_bDrawPending = true;
+	XnBool bAnimating = !m_bPaused && nNow < m_nAnimateUntil;
+	if (bAnimating)
+		m_bDrawPending = true;
+
+	// The first slot of the grid after now. Late frames do not shift the grid
+	XnUInt64 nPeriod = GetPeriod();
+	XnUInt64 nSlotAfterNow = m_nGridOrigin + ((nNow - m_nGridOrigin)/nPeriod + 1)*nPeriod;
+
+	bDraw = false;
+	if (m_bDrawPending && nNow >= m_nNextSlot)
+	{
+		bDraw = true;
+		m_bDrawPending = false;
+		m_nNextSlot = nSlotAfterNow;
+		m_nFrames++;
+	}
+
+	XnUInt64 nWake = m_nNextSlot > nNow ? m_nNextSlot : nSlotAfterNow;
+	XnUInt32 nToSlot = (XnUInt32)((nWake - nNow + 999)/1000);
+	if (m_bDrawPending || bAnimating)
+		return nToSlot;
+	if (!m_bPolled)
+		return XN_WAIT_INFINITE;
+	// A polled loop has to come back for the notifications, paused too: a quit or a change would wait for a key
+	return m_bFollowingFrames && !m_bPaused ? nToSlot : WATCH_INTERVAL;
+}
+
+void FrameScheduler::Wait(XnUInt32 nMs)
+{
+	xnOSWaitEvent(m_hWake, nMs);
+}
+
+void FrameScheduler::PrintStats() const
+{
+	XnUInt64 nNow;
+	xnOSGetHighResTimeStamp(&nNow);
+	XnDouble fSeconds = (nNow - m_nStatsStart)/1000000.0;
+	XnDouble fCpu = fSeconds <= 0 ? 0 : (GetProcessCpuTime() - m_nStatsCpuStart)/10000.0/fSeconds;
+	printf("Display: %u frames, %u wakeups over %.1f s, %.0f fps cap, process CPU %.1f%% of one core\n",
+		m_nFrames, m_nWakeups, fSeconds, GetMaxRate(), fCpu);
+}
+
+void FrameScheduler::ResetStats()
+{
+	m_nFrames = 0;
+	m_nWakeups = 0;
+	xnOSGetHighResTimeStamp(&m_nStatsStart);
+	m_nStatsCpuStart = GetProcessCpuTime();
+}
+
+typedef struct SoakSensor
+{
+	FrameScheduler* pScheduler;
+	volatile XnBool bStop;
+} SoakSensor;
+
+static XN_THREAD_PROC SoakSensorThread(XN_THREAD_PARAM pParam)
+{
+	SoakSensor* pSensor = (SoakSensor*)pParam;
+	while (!pSensor->bStop)
+	{
+		xnOSSleep(SOAK_FRAME_MS);
+		pSensor->pScheduler->NotifyFrame();
+	}
+	XN_THREAD_PROC_RETURN(XN_STATUS_OK);
+}
+
+// Stands for drawing a frame: takes the CPU for nUs
+static void SoakDraw(XnUInt32 nUs)
+{
+	if (nUs == 0)
+		return;
+	XnUInt64 nStart, nNow;
+	xnOSGetHighResTimeStamp(&nStart);
+	do
+	{
+		xnOSGetHighResTimeStamp(&nNow);
+	} while (nNow - nStart < nUs);
+}
+
+int FrameScheduler::Soak(XnUInt32 nSeconds, XnUInt32 nDrawUs)
+{
+	typedef struct
+	{
+		const XnChar* strName;
+		XnBool bSpin;
+		XnBool bPolled;
+		XnBool bPaused;
+		XnBool bFollowing;
+		XnBool bAnimating;
+	} SoakCase;
+	static const SoakCase cases[] =
+	{
+		{"old loop, drawing without a pause", true, false, false, true, false},
+		{"paused", false, false, true, true, false},
+		{"paused, polled", false, true, true, true, false},
+		{"idle, not following the frames", false, false, false, false, false},
+		{"idle, polled", false, true, false, false, false},
+		{"following the frames", false, false, false, true, false},
+		{"following the frames, polled", false, true, false, true, false},
+		{"animating", false, false, false, true, true},
+		{"animating, polled", false, true, false, true, true}
+	};
+
+	printf("Frame scheduler soak: %u s per case, %d Hz sensor, %.1f ms per draw, 60 Hz refresh, 60 fps cap\n",
+		nSeconds, 1000/SOAK_FRAME_MS, nDrawUs/1000.0);
+
+	for (XnUInt32 i = 0; i < sizeof(cases)/sizeof(cases[0]); ++i)
+	{
+		const SoakCase& soakCase = cases[i];
+		FrameScheduler scheduler;
+		scheduler.SetPolled(soakCase.bPolled);
+		scheduler.SetPaused(soakCase.bPaused);
+		scheduler.SetFollowingFrames(soakCase.bFollowing);
+
+		SoakSensor sensor;
+		sensor.pScheduler = &scheduler;
+		sensor.bStop = false;
+		XN_THREAD_HANDLE hThread;
+		if (xnOSCreateThread(SoakSensorThread, &sensor, &hThread) != XN_STATUS_OK)
+		{
+			printf("Soak thread creation failed\n");
+			return 1;
+		}
+
+		scheduler.ResetStats();
+		XnUInt64 nStart, nNow;
+		xnOSGetHighResTimeStamp(&nStart);
+		XnUInt64 nEnd = nStart + (XnUInt64)nSeconds*1000000;
+		for (nNow = nStart; nNow < nEnd; xnOSGetHighResTimeStamp(&nNow))
+		{
+			if (soakCase.bSpin)
+			{
+				// What the idle callback did: draw again, whether anything changed or not
+				scheduler.m_nWakeups++;
+				scheduler.m_nFrames++;
+				SoakDraw(nDrawUs);
+				continue;
+			}
+
+			XnBool bDraw;
+			XnUInt32 nSleep = scheduler.Tick(bDraw);
+			if (bDraw)
+			{
+				SoakDraw(nDrawUs);
+				if (soakCase.bAnimating)
+					scheduler.Animate(SOAK_FRAME_MS);
+			}
+
+			// No sleeping past the end of the case
+			XnUInt32 nLeft = (XnUInt32)((nEnd - nNow)/1000) + 1;
+			if (nSleep > nLeft)
+				nSleep = nLeft;
+			if (soakCase.bPolled)
+			{
+				xnOSSleep(nSleep);
+			}
+			else
+			{
+				// The GLES loop looks at the keyboard in between
+				scheduler.Wait(nSleep < SOAK_INPUT_POLL_MS ? nSleep : SOAK_INPUT_POLL_MS);
+			}
+		}
+
+		XnUInt64 nCpu = GetProcessCpuTime() - scheduler.m_nStatsCpuStart;
+		XnDouble fSeconds = (nNow - nStart)/1000000.0;
+		sensor.bStop = true;
+		xnOSWaitForThreadExit(hThread, XN_WAIT_INFINITE);
+		xnOSCloseThread(&hThread);
+
+		printf("  %-36s %6.1f frames/s %7.1f wakeups/s %6.1f%% CPU\n", soakCase.strName,
+			scheduler.m_nFrames/fSeconds, scheduler.m_nWakeups/fSeconds, nCpu/10000.0/fSeconds);
+	}
+
+	return 0;
+}
@@ -0,0 +1,116 @@
+#ifndef FRAME_SCHEDULER_H_
+#define FRAME_SCHEDULER_H_
+
+#include <XnOS.h>
+
+/**
+ * Decides when the display draws, instead of it drawing as fast as it can.
+ * A frame is drawn when something it shows changed: a sensor frame came in (only when the display follows
+ * the frames), another thread changed what is shown, a key was pressed, or an animation still runs.
+ * Frames are never closer than the rate cap, and are kept on a grid of whole refresh intervals, so they
+ * land on the same vsync every time. When nothing can change, the main thread sleeps until something does.
+ * Notify* can be called from any thread, everything else from the main thread only.
+ */
+class FrameScheduler
+{
+public:
+	FrameScheduler();
+	~FrameScheduler();
+
+	/**
+	 * The display's refresh rate, in Hz
+	 */
+	void SetRefreshRate(XnFloat fHz);
+	XnFloat GetRefreshRate() const;
+	/**
+	 * The most frames to draw per second. Rounded down to the refresh rate divided by a whole number
+	 */
+	void SetMaxRate(XnFloat fHz);
+	XnFloat GetMaxRate() const;
+
+	/**
+	 * Whether the main loop sleeps in Wait, which the notifications cut short. When it cannot be woken
+	 * (GLUT's timers), the notifications are looked for at every refresh slot while following the frames,
+	 * and every WATCH_INTERVAL ms otherwise, paused included
+	 */
+	void SetPolled(XnBool bPolled);
+
+	/**
+	 * A new sensor frame is ready
+	 */
+	void NotifyFrame();
+	/**
+	 * Something the main thread shows or acts on changed: draw, and look at it soon
+	 */
+	void NotifyChange();
+
+	/**
+	 * Whether what is shown follows the sensor's frames. If not, new frames do not need drawing
+	 */
+	void SetFollowingFrames(XnBool bFollowing);
+	/**
+	 * Nothing but input and changes are drawn while paused
+	 */
+	void SetPaused(XnBool bPaused);
+	/**
+	 * A key was pressed: draw the next frame
+	 */
+	void NotifyInput();
+	/**
+	 * Keep drawing at the cap for nMs more, for what moves between the sensor's frames
+	 */
+	void Animate(XnUInt32 nMs);
+
+	/**
+	 * Called every time the main loop wakes. bDraw tells whether to draw a frame now.
+	 * Returns how long the loop can sleep before calling again, in ms, or XN_WAIT_INFINITE when only
+	 * input or a notification can give it something to do. Never XN_WAIT_INFINITE when polled
+	 */
+	XnUInt32 Tick(XnBool& bDraw);
+	/**
+	 * Sleep up to nMs, or until a notification
+	 */
+	void Wait(XnUInt32 nMs);
+
+	/**
+	 * Print the frames drawn, the times the main loop woke and the CPU time the process took, since the last reset
+	 */
+	void PrintStats() const;
+	void ResetStats();
+
+	/**
+	 * Drive a scheduler for nSeconds per case with a 30 Hz stand-in sensor: paused, idle, following the frames
+	 * and animating, waking on notifications and polling, and the old loop drawing without a pause.
+	 * A draw takes nDrawUs of CPU, 0 to leave only what the loop itself costs.
+	 * Prints the frames, the wakeups and the CPU the process took in each, as getrusage/GetProcessTimes measured it
+	 */
+	static int Soak(XnUInt32 nSeconds, XnUInt32 nDrawUs);
+protected:
+	XnUInt64 GetPeriod() const;
+
+	XnFloat m_fRefreshRate;
+	// Refresh intervals between two frames
+	XnUInt32 m_nIntervals;
+	XnBool m_bPolled;
+
+	XN_EVENT_HANDLE m_hWake;
+	volatile XnUInt32 m_nFramePending;
+	volatile XnUInt32 m_nChangePending;
+
+	XnBool m_bFollowingFrames;
+	XnBool m_bPaused;
+	// A frame is owed, waiting for its slot
+	XnBool m_bDrawPending;
+	XnUInt64 m_nAnimateUntil;
+	// The grid the frames are drawn on: its origin, and the first slot not drawn yet, in us
+	XnBool m_bStarted;
+	XnUInt64 m_nGridOrigin;
+	XnUInt64 m_nNextSlot;
+
+	XnUInt32 m_nFrames;
+	XnUInt32 m_nWakeups;
+	XnUInt64 m_nStatsStart;
+	XnUInt64 m_nStatsCpuStart;
+};
+
+#endif
@@ -0,0 +1,116 @@
+#include "HandCursor.h"
+#include <stdio.h>
+#include <math.h>
+
+// The sensor's rate, until a hand has two samples to measure it from
+static const XnFloat fDefaultPeriod = 1/30.0f;
+
+HandCursor::HandCursor() :
+	m_eMode(CURSOR_INTERPOLATE)
+{
+	for (XnUInt32 nSlot = 0; nSlot < MAX_HANDS; ++nSlot)
+	{
+		m_bPlaced[nSlot] = false;
+	}
+	ResetStats();
+}
+
+void HandCursor::SetMode(Mode eMode)
+{
+	m_eMode = eMode;
+}
+HandCursor::Mode HandCursor::GetMode() const
+{
+	return m_eMode;
+}
+const XnChar* HandCursor::GetModeName(Mode eMode)
+{
+	switch (eMode)
+	{
+	case CURSOR_INTERPOLATE:
+		return "interpolate";
+	case CURSOR_EXTRAPOLATE:
+		return "extrapolate";
+	default:
+		return "latest";
+	}
+}
+
+const XnFloat* HandCursor::GetPosition(XnUInt32 nSlot) const
+{
+	return m_fPosition[nSlot];
+}
+
+void HandCursor::ResetStats()
+{
+	m_nFrames = 0;
+	m_nSamples = 0;
+	m_fLagSum = 0;
+	m_fSquaredErrorSum = 0;
+	m_fErrorMax = 0;
+}
+
+void HandCursor::PrintStats() const
+{
+	printf("Hand cursor (%s): %u frames, %u samples", GetModeName(m_eMode), m_nFrames, m_nSamples);
+	if (m_nSamples > 0)
+		printf(", error %.2f px RMS, %.2f px max", sqrt(m_fSquaredErrorSum/m_nSamples), m_fErrorMax);
+	if (m_nFrames > 0)
+		printf(", drawn %.1f ms behind", m_fLagSum*1000/m_nFrames);
+	printf("\n");
+}
+
+void HandCursor::Place(XnUInt32 nSlot, XnUInt32 nID, const XnFloat* pPrevious, XnFloat fPreviousTime,
+	const XnFloat* pNewest, XnFloat fNewestTime, XnFloat fNow)
+{
+	XnBool bSameHand = m_bPlaced[nSlot] && m_nID[nSlot] == nID;
+	if (bSameHand && fNewestTime > m_fSampleTime[nSlot])
+	{
+		// A real sample came in: how far from it was the cursor drawn last
+		XnFloat fDX = pNewest[0] - m_fPosition[nSlot][0];
+		XnFloat fDY = pNewest[1] - m_fPosition[nSlot][1];
+		XnFloat fError = sqrt(fDX*fDX + fDY*fDY);
+		m_fSquaredErrorSum += fError*fError;
+		if (fError > m_fErrorMax)
+			m_fErrorMax = fError;
+		m_nSamples++;
+	}
+
+	XnFloat fPeriod = fNewestTime - fPreviousTime;
+	if (pPrevious == pNewest || fPeriod <= 0)
+		fPeriod = fDefaultPeriod;
+
+	// The time on the sensor's clock the cursor stands for, kept on the line between the samples or one period past it
+	XnFloat fShown = fNewestTime;
+	switch (m_eMode)
+	{
+	case CURSOR_INTERPOLATE:
+		fShown = fNow - fPeriod;
+		if (fShown < fPreviousTime)
+			fShown = fPreviousTime;
+		if (fShown > fNewestTime)
+			fShown = fNewestTime;
+		break;
+	case CURSOR_EXTRAPOLATE:
+		fShown = fNow;
+		if (fShown < fNewestTime)
+			fShown = fNewestTime;
+		if (fShown > fNewestTime + fPeriod)
+			fShown = fNewestTime + fPeriod;
+		break;
+	default:
+		break;
+	}
+
+	// 0 on the previous sample, 1 on the newest
+	XnFloat fT = pPrevious == pNewest ? 1 : 1 + (fShown - fNewestTime)/fPeriod;
+	m_fPosition[nSlot][0] = pPrevious[0] + fT*(pNewest[0] - pPrevious[0]);
+	m_fPosition[nSlot][1] = pPrevious[1] + fT*(pNewest[1] - pPrevious[1]);
+
+	m_bPlaced[nSlot] = true;
+	m_nID[nSlot] = nID;
+	m_fSampleTime[nSlot] = fNewestTime;
+
+	m_nFrames++;
+	m_fLagSum += fNow > fShown ? fNow - fShown : 0;
+}
@@ -0,0 +1,87 @@
+#ifndef HAND_CURSOR_H_
+#define HAND_CURSOR_H_
+
+#include <XnPlatform.h>
+#include <XnTypes.h>
+#include "HandTable.h"
+
+/**
+ * Where to draw each hand at display rate, between the sensor's samples.
+ * The sensor gives a position every 33 ms, the display draws several frames in between: each frame places every
+ * hand on the line through its last two samples, at a time on the sensor's clock estimated for that frame.
+ * Every time a real sample comes in, the cursor drawn just before it is measured against it.
+ */
+class HandCursor
+{
+public:
+	typedef enum
+	{
+		// The newest sample, held until the next one
+		CURSOR_LATEST,
+		// Behind by one sample period, gliding from the previous sample to the newest one. Never overshoots
+		CURSOR_INTERPOLATE,
+		// Ahead of the newest sample, by at most one sample period. No lag, overshoots when the hand turns
+		CURSOR_EXTRAPOLATE
+	} Mode;
+
+	HandCursor();
+
+	void SetMode(Mode eMode);
+	Mode GetMode() const;
+	static const XnChar* GetModeName(Mode eMode);
+
+	/**
+	 * Place every hand of the table at fNow, in seconds of the sensor's clock.
+	 * Takes a HandTable, or any table with its interface, like HandHistory
+	 */
+	template <class Table>
+	void Update(const Table& hands, XnFloat fNow)
+	{
+		const XnUInt32 nStride = Table::GetComponents();
+		for (XnUInt32 nSlot = 0; nSlot < MAX_HANDS; ++nSlot)
+		{
+			XnUInt32 nLength = hands.IsUsed(nSlot) ? hands.GetLength(nSlot) : 0;
+			if (nLength == 0)
+			{
+				m_bPlaced[nSlot] = false;
+				continue;
+			}
+
+			// The newest position is last in the span
+			const XnFloat* pNewest = hands.GetPositions(nSlot) + (nLength - 1)*nStride;
+			const XnFloat* pPrevious = nLength > 1 ? pNewest - nStride : pNewest;
+			Place(nSlot, hands.GetID(nSlot), pPrevious, hands.GetPreviousTime(nSlot), pNewest, hands.GetTime(nSlot), fNow);
+		}
+	}
+
+	/**
+	 * The x, y of the hand in nSlot, as placed by the last Update
+	 */
+	const XnFloat* GetPosition(XnUInt32 nSlot) const;
+
+	/**
+	 * Print the error of the cursor against the samples that followed it, in pixels, and how far behind the
+	 * estimated sensor time it was drawn, since the last reset
+	 */
+	void PrintStats() const;
+	void ResetStats();
+protected:
+	void Place(XnUInt32 nSlot, XnUInt32 nID, const XnFloat* pPrevious, XnFloat fPreviousTime,
+		const XnFloat* pNewest, XnFloat fNewestTime, XnFloat fNow);
+
+	Mode m_eMode;
+
+	// Per slot: which hand was placed, its newest sample's time then, and where it was drawn
+	XnBool m_bPlaced[MAX_HANDS];
+	XnUInt32 m_nID[MAX_HANDS];
+	XnFloat m_fSampleTime[MAX_HANDS];
+	XnFloat m_fPosition[MAX_HANDS][2];
+
+	XnUInt32 m_nFrames;
+	XnUInt32 m_nSamples;
+	XnDouble m_fLagSum;
+	XnDouble m_fSquaredErrorSum;
+	XnFloat m_fErrorMax;
+};
+
+#endif
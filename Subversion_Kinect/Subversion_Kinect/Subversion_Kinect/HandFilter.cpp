@@ -0,0 +1,201 @@
+#include "HandFilter.h"
+#include <math.h>
+
+static const XnFloat fTwoPi = 6.2831853f;
+
+HandFilter::HandFilter() :
+	m_eType(FILTER_KALMAN), m_fPrediction(0),
+	m_fMinCutoff(1.0f), m_fBeta(0.02f), m_fDerivativeCutoff(2.0f),
+	m_fProcessNoise(1e6f), m_fMeasurementNoise(16.0f)
+{
+	for (XnUInt32 nLane = 0; nLane < MAX_HANDS; ++nLane)
+	{
+		Reset(nLane);
+	}
+}
+
+void HandFilter::SetType(Type eType)
+{
+	m_eType = eType;
+}
+HandFilter::Type HandFilter::GetType() const
+{
+	return m_eType;
+}
+const XnChar* HandFilter::GetTypeName(Type eType)
+{
+	switch (eType)
+	{
+	case FILTER_ONE_EURO:
+		return "one euro";
+	case FILTER_KALMAN:
+		return "kalman";
+	default:
+		return "none";
+	}
+}
+
+void HandFilter::SetPrediction(XnFloat fMs)
+{
+	m_fPrediction = fMs;
+}
+XnFloat HandFilter::GetPrediction() const
+{
+	return m_fPrediction;
+}
+
+void HandFilter::SetOneEuro(XnFloat fMinCutoff, XnFloat fBeta, XnFloat fDerivativeCutoff)
+{
+	m_fMinCutoff = fMinCutoff;
+	m_fBeta = fBeta;
+	m_fDerivativeCutoff = fDerivativeCutoff;
+}
+void HandFilter::SetKalman(XnFloat fProcessNoise, XnFloat fMeasurementNoise)
+{
+	m_fProcessNoise = fProcessNoise;
+	m_fMeasurementNoise = fMeasurementNoise;
+}
+
+void HandFilter::Reset(XnUInt32 nLane)
+{
+	m_bStarted[nLane] = false;
+	m_fTime[nLane] = 0;
+}
+
+void HandFilter::Filter(XnUInt32 nCount, const XnUInt32* pLanes, XnPoint3D* pPoints, const XnFloat* pTimes)
+{
+	// Time since each lane's last sample. 0 for new lanes, which start where their first sample is,
+	// and for samples seen already, which leave the state as it is
+	XnFloat fDT[MAX_HANDS];
+	for (XnUInt32 i = 0; i < nCount; ++i)
+	{
+		XnUInt32 nLane = pLanes[i];
+		if (!m_bStarted[nLane])
+		{
+			const XnFloat* pPoint = &pPoints[i].X;
+			for (XnUInt32 nAxis = 0; nAxis < 3; ++nAxis)
+			{
+				m_fPosition[nAxis][nLane] = pPoint[nAxis];
+				m_fVelocity[nAxis][nLane] = 0;
+				// Sure of the position as much as of one measurement, not at all of the speed
+				m_fP00[nAxis][nLane] = m_fMeasurementNoise;
+				m_fP01[nAxis][nLane] = 0;
+				m_fP11[nAxis][nLane] = 1e6f;
+			}
+			m_bStarted[nLane] = true;
+			fDT[i] = 0;
+		}
+		else
+			fDT[i] = pTimes[i] > m_fTime[nLane] ? pTimes[i] - m_fTime[nLane] : 0;
+		m_fTime[nLane] = pTimes[i];
+	}
+
+	switch (m_eType)
+	{
+	case FILTER_ONE_EURO:
+		FilterOneEuro(nCount, pLanes, pPoints, fDT);
+		break;
+	case FILTER_KALMAN:
+		FilterKalman(nCount, pLanes, pPoints, fDT);
+		break;
+	default:
+		// Nothing smoothed, but the speed is still needed to predict
+		for (XnUInt32 nAxis = 0; nAxis < 3; ++nAxis)
+		{
+			for (XnUInt32 i = 0; i < nCount; ++i)
+			{
+				XnUInt32 nLane = pLanes[i];
+				XnFloat fX = (&pPoints[i].X)[nAxis];
+				if (fDT[i] > 0)
+				{
+					m_fVelocity[nAxis][nLane] = (fX - m_fPosition[nAxis][nLane])/fDT[i];
+					m_fPosition[nAxis][nLane] = fX;
+				}
+			}
+		}
+		break;
+	}
+
+	// Out goes the state, ahead by the prediction
+	XnFloat fAhead = m_fPrediction/1000.0f;
+	for (XnUInt32 nAxis = 0; nAxis < 3; ++nAxis)
+	{
+		for (XnUInt32 i = 0; i < nCount; ++i)
+		{
+			XnUInt32 nLane = pLanes[i];
+			(&pPoints[i].X)[nAxis] = m_fPosition[nAxis][nLane] + m_fVelocity[nAxis][nLane]*fAhead;
+		}
+	}
+}
+
+void HandFilter::FilterOneEuro(XnUInt32 nCount, const XnUInt32* pLanes, XnPoint3D* pPoints, const XnFloat* pDT)
+{
+	XnFloat fDerivativeTau = 1.0f/(fTwoPi*m_fDerivativeCutoff);
+	for (XnUInt32 nAxis = 0; nAxis < 3; ++nAxis)
+	{
+		for (XnUInt32 i = 0; i < nCount; ++i)
+		{
+			XnFloat fDT = pDT[i];
+			if (fDT <= 0)
+				continue;
+
+			XnUInt32 nLane = pLanes[i];
+			XnFloat fX = (&pPoints[i].X)[nAxis];
+			XnFloat& fPosition = m_fPosition[nAxis][nLane];
+			XnFloat& fVelocity = m_fVelocity[nAxis][nLane];
+
+			// The speed, smoothed with a fixed cutoff
+			XnFloat fAlpha = fDT/(fDT + fDerivativeTau);
+			fVelocity += fAlpha*((fX - fPosition)/fDT - fVelocity);
+
+			// The position, smoothed less the faster it goes
+			XnFloat fCutoff = m_fMinCutoff + m_fBeta*(XnFloat)fabs(fVelocity);
+			fAlpha = fDT/(fDT + 1.0f/(fTwoPi*fCutoff));
+			fPosition += fAlpha*(fX - fPosition);
+		}
+	}
+}
+
+void HandFilter::FilterKalman(XnUInt32 nCount, const XnUInt32* pLanes, XnPoint3D* pPoints, const XnFloat* pDT)
+{
+	for (XnUInt32 nAxis = 0; nAxis < 3; ++nAxis)
+	{
+		for (XnUInt32 i = 0; i < nCount; ++i)
+		{
+			XnFloat fDT = pDT[i];
+			if (fDT <= 0)
+				continue;
+
+			XnUInt32 nLane = pLanes[i];
+			XnFloat fX = (&pPoints[i].X)[nAxis];
+			XnFloat fPosition = m_fPosition[nAxis][nLane];
+			XnFloat fVelocity = m_fVelocity[nAxis][nLane];
+			XnFloat fP00 = m_fP00[nAxis][nLane];
+			XnFloat fP01 = m_fP01[nAxis][nLane];
+			XnFloat fP11 = m_fP11[nAxis][nLane];
+
+			// Predict: move at the current speed, and grow less sure of it with white noise acceleration
+			fPosition += fVelocity*fDT;
+			fP00 += fDT*(2*fP01 + fDT*fP11) + m_fProcessNoise*fDT*fDT*fDT/3;
+			fP01 += fDT*fP11 + m_fProcessNoise*fDT*fDT/2;
+			fP11 += m_fProcessNoise*fDT;
+
+			// Correct with the measured position
+			XnFloat fS = fP00 + m_fMeasurementNoise;
+			XnFloat fK0 = fP00/fS;
+			XnFloat fK1 = fP01/fS;
+			XnFloat fInnovation = fX - fPosition;
+			fPosition += fK0*fInnovation;
+			fVelocity += fK1*fInnovation;
+			fP11 -= fK1*fP01;
+			fP00 *= 1 - fK0;
+			fP01 *= 1 - fK0;
+
+			m_fPosition[nAxis][nLane] = fPosition;
+			m_fVelocity[nAxis][nLane] = fVelocity;
+			m_fP00[nAxis][nLane] = fP00;
+			m_fP01[nAxis][nLane] = fP01;
+			m_fP11[nAxis][nLane] = fP11;
+		}
+	}
+}
@@ -0,0 +1,84 @@
+#ifndef HAND_FILTER_H_
+#define HAND_FILTER_H_
+
+#include <XnPlatform.h>
+#include <XnTypes.h>
+#include "HandTable.h"
+
+/**
+ * Smooths hand positions, and optionally predicts them ahead to make up for the sensor and pipeline latency.
+ * One lane per hand, MAX_HANDS of them, each axis filtered on its own. The state of every lane is kept in
+ * fixed arrays per quantity and per axis, and Filter runs a whole batch of hands one quantity at a time.
+ * Positions are in mm and times in seconds, the way NITE reports them.
+ * It starts as the filter the viewer runs: Kalman, without prediction, which TestHandFilter checks beats the raw
+ * positions.
+ */
+class HandFilter
+{
+public:
+	typedef enum
+	{
+		// Positions pass through, only predicted if asked to
+		FILTER_NONE,
+		// Low pass whose cutoff rises with the speed: smooth when still, little lag when moving
+		FILTER_ONE_EURO,
+		// Constant velocity Kalman filter
+		FILTER_KALMAN
+	} Type;
+
+	HandFilter();
+
+	void SetType(Type eType);
+	Type GetType() const;
+	static const XnChar* GetTypeName(Type eType);
+
+	/**
+	 * How far ahead to predict every position, in ms. 0 to only smooth
+	 */
+	void SetPrediction(XnFloat fMs);
+	XnFloat GetPrediction() const;
+
+	/**
+	 * One Euro: the cutoff when still, in Hz, how fast it rises with the speed, in Hz per mm/s,
+	 * and the cutoff of the speed estimate, in Hz
+	 */
+	void SetOneEuro(XnFloat fMinCutoff, XnFloat fBeta, XnFloat fDerivativeCutoff);
+	/**
+	 * Kalman: the acceleration noise, in (mm/s^2)^2/Hz, and the measurement noise, in mm^2
+	 */
+	void SetKalman(XnFloat fProcessNoise, XnFloat fMeasurementNoise);
+
+	/**
+	 * Forget the hand in nLane: its next position starts it over
+	 */
+	void Reset(XnUInt32 nLane);
+	/**
+	 * Filter nCount positions in place, the one of pPoints[i] belonging to lane pLanes[i], sampled at pTimes[i].
+	 * Every lane at most once per call
+	 */
+	void Filter(XnUInt32 nCount, const XnUInt32* pLanes, XnPoint3D* pPoints, const XnFloat* pTimes);
+
+protected:
+	void FilterOneEuro(XnUInt32 nCount, const XnUInt32* pLanes, XnPoint3D* pPoints, const XnFloat* pDT);
+	void FilterKalman(XnUInt32 nCount, const XnUInt32* pLanes, XnPoint3D* pPoints, const XnFloat* pDT);
+
+	Type m_eType;
+	XnFloat m_fPrediction;
+	XnFloat m_fMinCutoff;
+	XnFloat m_fBeta;
+	XnFloat m_fDerivativeCutoff;
+	XnFloat m_fProcessNoise;
+	XnFloat m_fMeasurementNoise;
+
+	// Per lane
+	XnBool m_bStarted[MAX_HANDS];
+	XnFloat m_fTime[MAX_HANDS];
+	// Per axis and lane: the filtered position and speed, and for Kalman their covariance
+	XnFloat m_fPosition[3][MAX_HANDS];
+	XnFloat m_fVelocity[3][MAX_HANDS];
+	XnFloat m_fP00[3][MAX_HANDS];
+	XnFloat m_fP01[3][MAX_HANDS];
+	XnFloat m_fP11[3][MAX_HANDS];
+};
+
+#endif
@@ -0,0 +1,154 @@
+#include "HandFilterControl.h"
+#include <XnVPointMessage.h>
+#include <XnVHandPointContext.h>
+
+XnVHandFilter::XnVHandFilter() :
+	XnVPointFilter("XnVHandFilter"),
+	m_pRecording(NULL), m_nType(m_Filter.GetType()), m_fPrediction(m_Filter.GetPrediction()),
+	m_strRecording(NULL), m_bRecordingChanged(false)
+{
+	for (XnUInt32 nLane = 0; nLane < MAX_HANDS; ++nLane)
+	{
+		m_bLaneUsed[nLane] = false;
+	}
+}
+
+XnVHandFilter::~XnVHandFilter()
+{
+	if (m_pRecording != NULL)
+		fclose(m_pRecording);
+}
+
+void XnVHandFilter::SetType(HandFilter::Type eType)
+{
+	m_nType = eType;
+}
+HandFilter::Type XnVHandFilter::GetType() const
+{
+	return (HandFilter::Type)m_nType;
+}
+void XnVHandFilter::SetPrediction(XnFloat fMs)
+{
+	m_fPrediction = fMs;
+}
+XnFloat XnVHandFilter::GetPrediction() const
+{
+	return m_fPrediction;
+}
+void XnVHandFilter::SetRecording(const XnChar* strFile)
+{
+	m_strRecording = strFile;
+	m_bRecordingChanged = true;
+}
+
+// On the NITE thread, between updates
+void XnVHandFilter::ApplySettings()
+{
+	m_Filter.SetType((HandFilter::Type)m_nType);
+	m_Filter.SetPrediction(m_fPrediction);
+
+	if (m_bRecordingChanged)
+	{
+		m_bRecordingChanged = false;
+		if (m_pRecording != NULL)
+		{
+			fclose(m_pRecording);
+			m_pRecording = NULL;
+			printf("Hand recording stopped\n");
+		}
+		if (m_strRecording != NULL)
+		{
+			m_pRecording = fopen(m_strRecording, "w");
+			if (m_pRecording == NULL)
+			{
+				printf("Can't record hands to %s\n", m_strRecording);
+				return;
+			}
+			fprintf(m_pRecording, "# time,id,x,y,z\n");
+			for (XnUInt32 nLane = 0; nLane < MAX_HANDS; ++nLane)
+			{
+				m_fRecordedTime[nLane] = -1;
+			}
+			printf("Recording hands to %s\n", m_strRecording);
+		}
+	}
+}
+
+XnUInt32 XnVHandFilter::GetLane(XnUInt32 nID)
+{
+	XnUInt32 nFree = INVALID_HAND_SLOT;
+	for (XnUInt32 nLane = 0; nLane < MAX_HANDS; ++nLane)
+	{
+		if (m_bLaneUsed[nLane] && m_LaneIDs[nLane] == nID)
+			return nLane;
+		if (!m_bLaneUsed[nLane] && nFree == INVALID_HAND_SLOT)
+			nFree = nLane;
+	}
+
+	if (nFree != INVALID_HAND_SLOT)
+	{
+		m_bLaneUsed[nFree] = true;
+		m_LaneIDs[nFree] = nID;
+		m_Filter.Reset(nFree);
+		m_fRecordedTime[nFree] = -1;
+	}
+	return nFree;
+}
+
+void XnVHandFilter::Update(XnVMessage* pMessage)
+{
+	ApplySettings();
+
+	XnVPointMessage* pPointMessage = XNV_GET_SPECIFIC_MESSAGE(pMessage, XnVPointMessage);
+	if (pPointMessage == NULL)
+	{
+		// No hands in it, nothing to filter
+		Generate(pMessage);
+		return;
+	}
+	((const XnVMultipleHands*)pPointMessage->GetData())->Clone(m_Filtered);
+
+	// Gather the hands, so they are all filtered in one go
+	XnVHandPointContext* contexts[MAX_HANDS];
+	XnUInt32 lanes[MAX_HANDS];
+	XnPoint3D points[MAX_HANDS];
+	XnFloat times[MAX_HANDS];
+	XnBool bSeen[MAX_HANDS] = {false};
+	XnUInt32 nCount = 0;
+	for (XnVMultipleHands::Iterator iter = m_Filtered.begin(); iter != m_Filtered.end() && nCount < MAX_HANDS; ++iter)
+	{
+		XnVHandPointContext* pContext = *iter;
+		XnUInt32 nLane = GetLane(pContext->nID);
+		if (nLane == INVALID_HAND_SLOT)
+			continue;
+
+		if (m_pRecording != NULL && pContext->fTime > m_fRecordedTime[nLane])
+		{
+			fprintf(m_pRecording, "%f,%u,%f,%f,%f\n", pContext->fTime, pContext->nID,
+				pContext->ptPosition.X, pContext->ptPosition.Y, pContext->ptPosition.Z);
+			m_fRecordedTime[nLane] = pContext->fTime;
+		}
+
+		bSeen[nLane] = true;
+		contexts[nCount] = pContext;
+		lanes[nCount] = nLane;
+		points[nCount] = pContext->ptPosition;
+		times[nCount] = pContext->fTime;
+		nCount++;
+	}
+
+	// Hands that are gone free their lanes
+	for (XnUInt32 nLane = 0; nLane < MAX_HANDS; ++nLane)
+	{
+		if (!bSeen[nLane])
+			m_bLaneUsed[nLane] = false;
+	}
+
+	m_Filter.Filter(nCount, lanes, points, times);
+	for (XnUInt32 i = 0; i < nCount; ++i)
+	{
+		contexts[i]->ptPosition = points[i];
+	}
+
+	GenerateReplaced(pMessage, m_Filtered);
+}
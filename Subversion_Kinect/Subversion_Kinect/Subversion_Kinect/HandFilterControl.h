@@ -0,0 +1,57 @@
+#ifndef HAND_FILTER_CONTROL_H_
+#define HAND_FILTER_CONTROL_H_
+
+#include <stdio.h>
+#include <XnVPointFilter.h>
+#include <XnVMultipleHands.h>
+#include "HandFilter.h"
+
+/**
+ * A point filter between the session manager and the controls: every point message goes out again with its
+ * hands' positions passed through a HandFilter, all the hands of the message in one batch.
+ * Other messages go through as they are. Settings can be changed from any thread, they are applied
+ * at the start of the next update, on the NITE thread.
+ */
+class XnVHandFilter : public XnVPointFilter
+{
+public:
+	XnVHandFilter();
+	~XnVHandFilter();
+
+	void Update(XnVMessage* pMessage);
+
+	void SetType(HandFilter::Type eType);
+	HandFilter::Type GetType() const;
+	/**
+	 * How far ahead to predict the hands, in ms
+	 */
+	void SetPrediction(XnFloat fMs);
+	XnFloat GetPrediction() const;
+
+	/**
+	 * Write every raw position to strFile as "time,id,x,y,z" lines, for HandTrajectories::Load. NULL to stop.
+	 * The file name must stay valid until the recording starts, at the next update
+	 */
+	void SetRecording(const XnChar* strFile);
+protected:
+	// Lane of hand nID, which is given one if it has none. INVALID_HAND_SLOT when all are taken
+	XnUInt32 GetLane(XnUInt32 nID);
+	void ApplySettings();
+
+	HandFilter m_Filter;
+	// The message's hands, with the filtered positions
+	XnVMultipleHands m_Filtered;
+	XnBool m_bLaneUsed[MAX_HANDS];
+	XnUInt32 m_LaneIDs[MAX_HANDS];
+
+	FILE* m_pRecording;
+	XnFloat m_fRecordedTime[MAX_HANDS];
+
+	// Requested from other threads
+	volatile XnUInt32 m_nType;
+	volatile XnFloat m_fPrediction;
+	const XnChar* volatile m_strRecording;
+	volatile XnBool m_bRecordingChanged;
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef HAND_HISTORY_H_
+#define HAND_HISTORY_H_
+
+#include <assert.h>
+#include <string.h>
+#include "HandTable.h"
+
+/**
+ * Where a HandHistory keeps its positions: rings of N positions, part of the object.
+ * Every bound is a constant: the ring wraps with a mask when N is a power of two, and the copies have a fixed size.
+ * With HAND_LAYOUT_3D the positions are x, y, z triples, and there is no separate GetZ.
+ */
+template <XnUInt32 N, HandLayout Layout>
+class HandHistoryStorage
+{
+public:
+	enum
+	{
+		COMPONENTS = Layout == HAND_LAYOUT_3D ? 3 : 2,
+		// Every position is stored twice, N apart, like in HandTable
+		SLOT_FLOATS = 2*N*COMPONENTS
+	};
+
+	/**
+	 * Nothing to allocate: here for code written against HandTable, nCapacity must be N
+	 */
+	void Allocate(XnUInt32 nCapacity)
+	{
+		assert(nCapacity == N);
+	}
+	XnUInt32 GetCapacity() const
+	{
+		return N;
+	}
+	XnUInt32 Next(XnUInt32 nHead) const
+	{
+		// Both sides are constants, only one of them is compiled in
+		if ((N & (N - 1)) == 0)
+			return (nHead + 1) & (N - 1);
+		return nHead + 1 == N ? 0 : nHead + 1;
+	}
+	void Write(XnUInt32 nSlot, XnUInt32 nHead, const XnPoint3D& ptPosition)
+	{
+		XnFloat* pFirst = m_Positions[nSlot] + nHead*COMPONENTS;
+		XnFloat* pSecond = pFirst + N*COMPONENTS;
+
+		pFirst[0] = pSecond[0] = ptPosition.X;
+		pFirst[1] = pSecond[1] = ptPosition.Y;
+		if (COMPONENTS == 3)
+			pFirst[2] = pSecond[2] = ptPosition.Z;
+	}
+	const XnFloat* GetPositions(XnUInt32 nSlot, XnUInt32 nFirst) const
+	{
+		return m_Positions[nSlot] + nFirst*COMPONENTS;
+	}
+	static XnUInt32 GetComponents()
+	{
+		return COMPONENTS;
+	}
+	void CopySlot(XnUInt32 nSlot, const HandHistoryStorage& other)
+	{
+		memcpy(m_Positions[nSlot], other.m_Positions[nSlot], sizeof(m_Positions[nSlot]));
+	}
+private:
+	XnFloat m_Positions[MAX_HANDS][SLOT_FLOATS];
+};
+
+/**
+ * A HandTable with its ring length N and its layout fixed at compile time, and its storage part of the object.
+ * The same ring logic as HandTable, so code templated on the table takes either.
+ */
+template <XnUInt32 N, HandLayout Layout>
+class HandHistory : public HandRing<HandHistoryStorage<N, Layout> >
+{
+};
+
+#endif
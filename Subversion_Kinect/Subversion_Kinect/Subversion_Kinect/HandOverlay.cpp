@@ -0,0 +1,144 @@
+#include "HandOverlay.h"
+#include <stddef.h>
+
+// Colors for the points
+static const GLubyte Colors[][4] =
+{
+	{128,128,128,255},	// Grey
+	{0,255,0,255},		// Green
+	{0,128,255,255},	// Light blue
+	{255,255,0,255},	// Yellow
+	{255,128,0,255},	// Orange
+	{255,0,255,255},	// Purple
+	{255,255,255,255}	// White. reserved for the primary point
+};
+static const XnUInt32 nColors = 6;
+static const GLubyte Red[4] = {255,0,0,255};
+
+#ifdef USE_GLUT
+	// The entry points come with the ARB extension, GL 1.1 has none of them
+	#define XN_GEN_BUFFERS glGenBuffersARB
+	#define XN_BIND_BUFFER glBindBufferARB
+	#define XN_BUFFER_DATA glBufferDataARB
+	#define XN_ARRAY_BUFFER GL_ARRAY_BUFFER_ARB
+	#define XN_STREAM_DRAW GL_STREAM_DRAW_ARB
+#else
+	#define XN_GEN_BUFFERS glGenBuffers
+	#define XN_BIND_BUFFER glBindBuffer
+	#define XN_BUFFER_DATA glBufferData
+	#define XN_ARRAY_BUFFER GL_ARRAY_BUFFER
+	// GLES 1.1 has no stream hint, its drivers treat dynamic data the same way
+	#define XN_STREAM_DRAW GL_DYNAMIC_DRAW
+#endif
+
+HandOverlay::HandOverlay() :
+	m_pVertices(NULL), m_nCapacity(0), m_nLineVertices(0), m_nPointVertices(0),
+	m_bVBOChecked(false), m_bUseVBO(false), m_nVBO(0)
+{
+}
+
+// The buffer object is left to the GL context, which is usually gone by now
+HandOverlay::~HandOverlay()
+{
+	delete []m_pVertices;
+}
+
+XnUInt32 HandOverlay::GetVertexCount() const
+{
+	return m_nLineVertices + m_nPointVertices;
+}
+
+void HandOverlay::Allocate(XnUInt32 nCapacity)
+{
+	// A full trail of every hand as separate segments, an edge tick and the current position of every hand
+	delete []m_pVertices;
+	m_pVertices = new Vertex[MAX_HANDS*((nCapacity > 0 ? nCapacity - 1 : 0)*2 + 2 + 1)];
+	m_nCapacity = nCapacity;
+}
+
+const GLubyte* HandOverlay::GetColor(XnUInt32 nID, XnBool bPrimary)
+{
+	return Colors[bPrimary ? 6 : nID % nColors];
+}
+
+const GLubyte* HandOverlay::GetEdgeColor()
+{
+	return Red;
+}
+
+XnBool HandOverlay::GetEdgeTick(XnDirection eEdge, XnFloat& fDX, XnFloat& fDY)
+{
+	// Projective coordinates, y grows downwards
+	const XnFloat fLength = 20;
+	fDX = fDY = 0;
+	switch (eEdge)
+	{
+	case XN_DIRECTION_LEFT:
+		fDX = -fLength; return true;
+	case XN_DIRECTION_RIGHT:
+		fDX = fLength; return true;
+	case XN_DIRECTION_UP:
+		fDY = -fLength; return true;
+	case XN_DIRECTION_DOWN:
+		fDY = fLength; return true;
+	default:
+		return false;
+	}
+}
+
+void HandOverlay::Render(RenderState& state, XnUInt32 nParam)
+{
+	XnUInt32 nVertices = m_nLineVertices + m_nPointVertices;
+	if (nVertices == 0)
+		return;
+
+	if (!m_bVBOChecked)
+	{
+#ifdef USE_GLUT
+		m_bUseVBO = glh_init_extensions("GL_ARB_vertex_buffer_object");
+#else
+		m_bUseVBO = true;
+#endif
+		if (m_bUseVBO)
+			XN_GEN_BUFFERS(1, &m_nVBO);
+		m_bVBOChecked = true;
+	}
+
+	const GLubyte* pBase = (const GLubyte*)m_pVertices;
+	if (m_bUseVBO)
+	{
+		// New storage every frame: the driver hands out fresh memory rather than wait for the last draw from it
+		XN_BIND_BUFFER(XN_ARRAY_BUFFER, m_nVBO);
+		XN_BUFFER_DATA(XN_ARRAY_BUFFER, nVertices*sizeof(Vertex), m_pVertices, XN_STREAM_DRAW);
+		state.Count(2);
+		// Reading from the bound buffer, the pointers are offsets into it
+		pBase = NULL;
+	}
+
+	// Untextured, colored per vertex
+	state.UseTexture(0, 0);
+	state.Disable(GL_BLEND);
+	state.EnableClientState(GL_VERTEX_ARRAY);
+	state.EnableClientState(GL_COLOR_ARRAY);
+	state.DisableClientState(GL_TEXTURE_COORD_ARRAY);
+	glVertexPointer(2, GL_FLOAT, sizeof(Vertex), pBase + offsetof(Vertex, fX));
+	glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), pBase + offsetof(Vertex, Color));
+	state.Count(2);
+
+	if (m_nLineVertices > 0)
+	{
+		glDrawArrays(GL_LINES, 0, m_nLineVertices);
+		state.Count();
+	}
+	state.PointSize(8);
+	glDrawArrays(GL_POINTS, m_nLineVertices, m_nPointVertices);
+	state.Count();
+	// Drawing with a color array leaves the current color undefined
+	state.InvalidateColor();
+
+	if (m_bUseVBO)
+	{
+		XN_BIND_BUFFER(XN_ARRAY_BUFFER, 0);
+		state.Count();
+	}
+}
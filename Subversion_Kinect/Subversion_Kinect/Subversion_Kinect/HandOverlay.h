@@ -0,0 +1,149 @@
+#ifndef HAND_OVERLAY_H_
+#define HAND_OVERLAY_H_
+
+#include <string.h>
+#include "HandTable.h"
+#include "HandCursor.h"
+#include "RenderQueue.h"
+
+#ifdef USE_GLUT
+	#include <glh_extensions.h>
+#elif defined(USE_GLES)
+	#include "opengles.h"
+#endif
+
+/**
+ * Draws the trails and current positions of all the hands of a table in two calls: one batch of lines
+ * and one of points, colored per vertex. The vertices are packed when the table is prepared, and drawn
+ * when the render queue gets to them. The vertices are streamed through a vertex buffer object,
+ * respecified every frame so the driver never waits for the previous frame's draw.
+ * Without vertex buffer objects they are drawn from client memory, still in two calls.
+ */
+class HandOverlay : public Renderable
+{
+public:
+	HandOverlay();
+	~HandOverlay();
+
+	/**
+	 * Make room for tables of nCapacity positions per hand, so drawing them allocates nothing
+	 */
+	void Allocate(XnUInt32 nCapacity);
+	/**
+	 * Get ready to draw every hand of the table. Takes a HandTable, or any table with its interface, like HandHistory.
+	 * With a cursor updated from the same table, the current positions are the cursor's rather than the newest samples
+	 */
+	template <class Table>
+	void Prepare(const Table& hands, const HandCursor* pCursor = NULL)
+	{
+		if (m_pVertices == NULL || hands.GetCapacity() > m_nCapacity)
+			Allocate(hands.GetCapacity());
+
+		Pack(hands, pCursor);
+	}
+	/**
+	 * Fill the vertices from the table without drawing them. Returns how many there are
+	 */
+	template <class Table>
+	XnUInt32 Pack(const Table& hands, const HandCursor* pCursor = NULL)
+	{
+		// Count the line vertices first, the points go right after them.
+		// The lines are the trails, then a tick from each hand at an edge towards that edge
+		m_nLineVertices = 0;
+		m_nPointVertices = 0;
+		XnUInt32 nTicks = 0;
+		for (XnUInt32 nSlot = 0; nSlot < MAX_HANDS; ++nSlot)
+		{
+			if (hands.IsUsed(nSlot) && hands.GetLength(nSlot) > 0)
+			{
+				XnFloat fDX, fDY;
+				m_nLineVertices += (hands.GetLength(nSlot) - 1)*2;
+				m_nPointVertices++;
+				if (hands.IsTouchingFOVEdge(nSlot) && GetEdgeTick(hands.GetFOVEdge(nSlot), fDX, fDY))
+					nTicks++;
+			}
+		}
+
+		// A constant for HandHistory, so the loops below unroll to fixed strides
+		const XnUInt32 nStride = Table::GetComponents();
+		Vertex* pLine = m_pVertices;
+		Vertex* pTick = m_pVertices + m_nLineVertices;
+		m_nLineVertices += nTicks*2;
+		Vertex* pPoint = m_pVertices + m_nLineVertices;
+		for (XnUInt32 nSlot = 0; nSlot < MAX_HANDS; ++nSlot)
+		{
+			XnUInt32 nLength = hands.IsUsed(nSlot) ? hands.GetLength(nSlot) : 0;
+			if (nLength == 0)
+				continue;
+
+			const GLubyte* pColor = GetColor(hands.GetID(nSlot), hands.IsPrimary(nSlot));
+			const XnFloat* pPosition = hands.GetPositions(nSlot);
+
+			// Separate segments rather than a strip, so the trails of different hands stay apart in one batch
+			for (XnUInt32 i = 0; i + 1 < nLength; ++i, pLine += 2, pPosition += nStride)
+			{
+				pLine[0].fX = pPosition[0];
+				pLine[0].fY = pPosition[1];
+				pLine[1].fX = pPosition[nStride];
+				pLine[1].fY = pPosition[nStride + 1];
+				memcpy(pLine[0].Color, pColor, 4);
+				memcpy(pLine[1].Color, pColor, 4);
+			}
+
+			// The current position is the newest, last in the span, unless the cursor places the hand in between
+			const XnFloat* pCurrent = pCursor != NULL ? pCursor->GetPosition(nSlot) : pPosition;
+			pPoint->fX = pCurrent[0];
+			pPoint->fY = pCurrent[1];
+			memcpy(pPoint->Color, hands.IsTouchingFOVEdge(nSlot) ? GetEdgeColor() : pColor, 4);
+
+			XnFloat fDX, fDY;
+			if (hands.IsTouchingFOVEdge(nSlot) && GetEdgeTick(hands.GetFOVEdge(nSlot), fDX, fDY))
+			{
+				pTick[0] = pTick[1] = *pPoint;
+				pTick[1].fX += fDX;
+				pTick[1].fY += fDY;
+				pTick += 2;
+			}
+			++pPoint;
+		}
+
+		return m_nLineVertices + m_nPointVertices;
+	}
+
+	/**
+	 * Draw what the last Pack filled
+	 */
+	virtual void Render(RenderState& state, XnUInt32 nParam);
+
+	/**
+	 * Vertices drawn in the last frame
+	 */
+	XnUInt32 GetVertexCount() const;
+protected:
+	typedef struct
+	{
+		GLfloat fX;
+		GLfloat fY;
+		GLubyte Color[4];
+	} Vertex;
+
+	static const GLubyte* GetColor(XnUInt32 nID, XnBool bPrimary);
+	static const GLubyte* GetEdgeColor();
+	/**
+	 * Offset of the tick drawn towards the eEdge edge of the view. False for the edges with no direction on screen
+	 */
+	static XnBool GetEdgeTick(XnDirection eEdge, XnFloat& fDX, XnFloat& fDY);
+
+	// Line segments first, then one point per hand
+	Vertex* m_pVertices;
+	// Positions per hand there is room for
+	XnUInt32 m_nCapacity;
+	XnUInt32 m_nLineVertices;
+	XnUInt32 m_nPointVertices;
+
+	XnBool m_bVBOChecked;
+	XnBool m_bUseVBO;
+	GLuint m_nVBO;
+};
+
+#endif
@@ -0,0 +1,227 @@
+#ifndef HAND_RING_H_
+#define HAND_RING_H_
+
+#include <string.h>
+#include <XnPlatform.h>
+#include <XnTypes.h>
+
+#define MAX_HANDS 16
+#define INVALID_HAND_SLOT ((XnUInt32)-1)
+
+/**
+ * The slots of a hand table and the ring of positions of each, over a Storage that holds the positions.
+ * All of the bookkeeping is here, once: which slots are used and by which hand, where each ring's head is and
+ * how long it is, the sample times and the flags. The storage only knows where a position goes:
+ *   void Allocate(XnUInt32 nCapacity)
+ *   XnUInt32 GetCapacity() const
+ *   XnUInt32 Next(XnUInt32 nHead) const: the head after nHead, wrapped
+ *   void Write(XnUInt32 nSlot, XnUInt32 nHead, const XnPoint3D& pt): at nHead, and again one capacity further
+ *   const XnFloat* GetPositions(XnUInt32 nSlot, XnUInt32 nFirst) const: from position nFirst of the doubled ring
+ *   static XnUInt32 GetComponents()
+ *   void CopySlot(XnUInt32 nSlot, const Storage& other)
+ * and, when it keeps the depths apart, const XnFloat* GetZ(XnUInt32 nSlot, XnUInt32 nFirst) const.
+ * Every position is written twice, one capacity apart, so a hand's positions are always one contiguous span.
+ */
+template <class Storage>
+class HandRing
+{
+public:
+	HandRing() :
+		m_nTouchingFOVEdge(0)
+	{
+		memset(m_bUsed, 0, sizeof(m_bUsed));
+	}
+
+	/**
+	 * Allocate rings of nCapacity positions. Forgets every hand
+	 */
+	void Allocate(XnUInt32 nCapacity)
+	{
+		m_Storage.Allocate(nCapacity);
+		memset(m_bUsed, 0, sizeof(m_bUsed));
+	}
+	XnUInt32 GetCapacity() const
+	{
+		return m_Storage.GetCapacity();
+	}
+
+	/**
+	 * Slot of hand nID, INVALID_HAND_SLOT if it is not in the table.
+	 * NITE keeps a handful of hands at most, a scan is as fast as any map
+	 */
+	XnUInt32 Find(XnUInt32 nID) const
+	{
+		for (XnUInt32 nSlot = 0; nSlot < MAX_HANDS; ++nSlot)
+		{
+			if (m_bUsed[nSlot] && m_nID[nSlot] == nID)
+				return nSlot;
+		}
+		return INVALID_HAND_SLOT;
+	}
+	/**
+	 * Add hand nID with no positions, or clear its positions if it is there already.
+	 * INVALID_HAND_SLOT when all MAX_HANDS slots are taken
+	 */
+	XnUInt32 Add(XnUInt32 nID)
+	{
+		XnUInt32 nSlot = Find(nID);
+		for (XnUInt32 i = 0; nSlot == INVALID_HAND_SLOT && i < MAX_HANDS; ++i)
+		{
+			if (!m_bUsed[i])
+				nSlot = i;
+		}
+		if (nSlot == INVALID_HAND_SLOT)
+			return INVALID_HAND_SLOT;
+
+		m_bUsed[nSlot] = true;
+		m_nID[nSlot] = nID;
+		m_nHead[nSlot] = 0;
+		m_nLength[nSlot] = 0;
+		m_fTime[nSlot] = m_fPreviousTime[nSlot] = 0;
+		m_bPrimary[nSlot] = false;
+		m_nTouchingFOVEdge &= ~(1 << nSlot);
+		m_eFOVEdge[nSlot] = XN_DIRECTION_ILLEGAL;
+		return nSlot;
+	}
+	void Remove(XnUInt32 nID)
+	{
+		XnUInt32 nSlot = Find(nID);
+		if (nSlot != INVALID_HAND_SLOT)
+			m_bUsed[nSlot] = false;
+	}
+
+	/**
+	 * Append the newest position of the hand in nSlot, sampled at fTime, replacing its oldest one when the ring is full
+	 */
+	void Push(XnUInt32 nSlot, const XnPoint3D& ptPosition, XnFloat fTime)
+	{
+		XnUInt32 nHead = m_nHead[nSlot];
+		m_Storage.Write(nSlot, nHead, ptPosition);
+
+		m_nHead[nSlot] = m_Storage.Next(nHead);
+		if (m_nLength[nSlot] < m_Storage.GetCapacity())
+			m_nLength[nSlot]++;
+		m_fPreviousTime[nSlot] = m_fTime[nSlot];
+		m_fTime[nSlot] = fTime;
+	}
+
+	/**
+	 * Slots in use are found by walking [0, MAX_HANDS) with IsUsed
+	 */
+	XnBool IsUsed(XnUInt32 nSlot) const
+	{
+		return m_bUsed[nSlot];
+	}
+	XnUInt32 GetID(XnUInt32 nSlot) const
+	{
+		return m_nID[nSlot];
+	}
+	XnUInt32 GetLength(XnUInt32 nSlot) const
+	{
+		return m_nLength[nSlot];
+	}
+	/**
+	 * The GetLength(nSlot) positions of the hand, GetComponents() floats each, oldest first.
+	 * The span ends just before the head's mirror, so it never runs past the second copy
+	 */
+	const XnFloat* GetPositions(XnUInt32 nSlot) const
+	{
+		return m_Storage.GetPositions(nSlot, GetFirst(nSlot));
+	}
+	/**
+	 * Their depths, when the storage keeps them apart
+	 */
+	const XnFloat* GetZ(XnUInt32 nSlot) const
+	{
+		return m_Storage.GetZ(nSlot, GetFirst(nSlot));
+	}
+	static XnUInt32 GetComponents()
+	{
+		return Storage::GetComponents();
+	}
+	/**
+	 * When the newest position of the hand and the one before it were sampled, in seconds of the sensor's clock
+	 */
+	XnFloat GetTime(XnUInt32 nSlot) const
+	{
+		return m_fTime[nSlot];
+	}
+	XnFloat GetPreviousTime(XnUInt32 nSlot) const
+	{
+		return m_fPreviousTime[nSlot];
+	}
+
+	/**
+	 * Flags the drawing side needs, set when publishing a copy of the table.
+	 * eFOVEdge is the edge of the field of view the hand touches, XN_DIRECTION_ILLEGAL for none
+	 */
+	void SetFlags(XnUInt32 nSlot, XnBool bPrimary, XnDirection eFOVEdge)
+	{
+		m_bPrimary[nSlot] = bPrimary;
+		m_eFOVEdge[nSlot] = eFOVEdge;
+		if (eFOVEdge != XN_DIRECTION_ILLEGAL)
+			m_nTouchingFOVEdge |= 1 << nSlot;
+		else
+			m_nTouchingFOVEdge &= ~(1 << nSlot);
+	}
+	XnBool IsPrimary(XnUInt32 nSlot) const
+	{
+		return m_bPrimary[nSlot];
+	}
+	XnBool IsTouchingFOVEdge(XnUInt32 nSlot) const
+	{
+		return (m_nTouchingFOVEdge >> nSlot) & 1;
+	}
+	XnDirection GetFOVEdge(XnUInt32 nSlot) const
+	{
+		return m_eFOVEdge[nSlot];
+	}
+
+	/**
+	 * Copy the hands of a table with the same capacity
+	 */
+	void CopyFrom(const HandRing& other)
+	{
+		memcpy(m_bUsed, other.m_bUsed, sizeof(m_bUsed));
+		memcpy(m_nID, other.m_nID, sizeof(m_nID));
+		memcpy(m_nHead, other.m_nHead, sizeof(m_nHead));
+		memcpy(m_nLength, other.m_nLength, sizeof(m_nLength));
+		memcpy(m_fTime, other.m_fTime, sizeof(m_fTime));
+		memcpy(m_fPreviousTime, other.m_fPreviousTime, sizeof(m_fPreviousTime));
+		memcpy(m_bPrimary, other.m_bPrimary, sizeof(m_bPrimary));
+		memcpy(m_eFOVEdge, other.m_eFOVEdge, sizeof(m_eFOVEdge));
+		m_nTouchingFOVEdge = other.m_nTouchingFOVEdge;
+
+		// Only the rings of the hands in use
+		for (XnUInt32 nSlot = 0; nSlot < MAX_HANDS; ++nSlot)
+		{
+			if (m_bUsed[nSlot])
+				m_Storage.CopySlot(nSlot, other.m_Storage);
+		}
+	}
+protected:
+	// Where the oldest position of the slot is, in the doubled ring
+	XnUInt32 GetFirst(XnUInt32 nSlot) const
+	{
+		return m_nHead[nSlot] + m_Storage.GetCapacity() - m_nLength[nSlot];
+	}
+
+	Storage m_Storage;
+
+	XnBool m_bUsed[MAX_HANDS];
+	XnUInt32 m_nID[MAX_HANDS];
+	// Where the next position of the slot goes, in [0, capacity), and how many it holds
+	XnUInt32 m_nHead[MAX_HANDS];
+	XnUInt32 m_nLength[MAX_HANDS];
+	XnFloat m_fTime[MAX_HANDS];
+	XnFloat m_fPreviousTime[MAX_HANDS];
+	XnBool m_bPrimary[MAX_HANDS];
+	// One bit per slot, and the edge each one touches
+	XnUInt32 m_nTouchingFOVEdge;
+	XnDirection m_eFOVEdge[MAX_HANDS];
+private:
+	HandRing(const HandRing&);
+	HandRing& operator=(const HandRing&);
+};
+
+#endif
@@ -0,0 +1,82 @@
+#include "HandStore.h"
+#include <stdio.h>
+
+// One frame of the hands' path, the way the drawer runs it: a position for every hand on the NITE thread,
+// the copy for the display, the cursor and the vertices for the overlay. Returns ns per frame
+template <class Table>
+static XnDouble TimeHands(XnUInt32 nCapacity, XnUInt32 nHands, XnUInt32 nIterations, XnUInt32& nVertices)
+{
+	Table* pHands = new Table;
+	Table* pSnapshot = new Table;
+	HandCursor cursor;
+	HandOverlay overlay;
+	pHands->Allocate(nCapacity);
+	pSnapshot->Allocate(nCapacity);
+	overlay.Allocate(nCapacity);
+
+	for (XnUInt32 nID = 1; nID <= nHands; ++nID)
+	{
+		pHands->Add(nID);
+	}
+
+	XnUInt64 nStart, nEnd;
+	xnOSGetHighResTimeStamp(&nStart);
+	for (XnUInt32 i = 0; i < nIterations; ++i)
+	{
+		for (XnUInt32 nSlot = 0; nSlot < nHands; ++nSlot)
+		{
+			XnPoint3D ptPosition;
+			ptPosition.X = (XnFloat)((i + nSlot*37) % 640);
+			ptPosition.Y = (XnFloat)((i*3 + nSlot*11) % 480);
+			ptPosition.Z = 1000.0f + nSlot;
+			pHands->Push(nSlot, ptPosition, i/30.0f);
+		}
+		pSnapshot->CopyFrom(*pHands);
+		// Halfway between two samples
+		cursor.Update(*pSnapshot, (i + 0.5f)/30.0f);
+		nVertices = overlay.Pack(*pSnapshot, &cursor);
+	}
+	xnOSGetHighResTimeStamp(&nEnd);
+
+	delete pHands;
+	delete pSnapshot;
+	return (nEnd - nStart)*1000.0/nIterations;
+}
+
+void HandStore::Benchmark(XnUInt32 nIterations)
+{
+	printf("Hand store benchmark, %u frames\n", nIterations);
+	printf("  %-24s %10s %10s %10s\n", "table", "1 hand", "4 hands", "16 hands");
+
+	XnUInt32 hands[] = {1, 4, 16};
+	XnUInt32 nVertices = 0;
+	XnUInt32 nReference[3];
+	XnDouble fTime[3];
+
+	for (XnUInt32 h = 0; h < 3; ++h)
+	{
+		fTime[h] = TimeHands<HandTable>(20, hands[h], nIterations, nReference[h]);
+	}
+	printf("  %-24s %7.0f ns %7.0f ns %7.0f ns\n", "HandTable(20)", fTime[0], fTime[1], fTime[2]);
+
+	// Same history as the runtime table, so the vertex counts must match
+	XnBool bMatch = true;
+	for (XnUInt32 h = 0; h < 3; ++h)
+	{
+		fTime[h] = TimeHands<HandHistory<20, HAND_LAYOUT_PROJECTIVE> >(20, hands[h], nIterations, nVertices);
+		bMatch = bMatch && nVertices == nReference[h];
+	}
+	printf("  %-24s %7.0f ns %7.0f ns %7.0f ns %s\n", "HandHistory<20,proj>", fTime[0], fTime[1], fTime[2], bMatch ? "" : "(VERTEX COUNT MISMATCH)");
+
+	for (XnUInt32 h = 0; h < 3; ++h)
+	{
+		fTime[h] = TimeHands<HandHistory<32, HAND_LAYOUT_PROJECTIVE> >(32, hands[h], nIterations, nVertices);
+	}
+	printf("  %-24s %7.0f ns %7.0f ns %7.0f ns\n", "HandHistory<32,proj>", fTime[0], fTime[1], fTime[2]);
+
+	for (XnUInt32 h = 0; h < 3; ++h)
+	{
+		fTime[h] = TimeHands<HandHistory<20, HAND_LAYOUT_3D> >(20, hands[h], nIterations, nVertices);
+	}
+	printf("  %-24s %7.0f ns %7.0f ns %7.0f ns\n", "HandHistory<20,3d>", fTime[0], fTime[1], fTime[2]);
+}
@@ -0,0 +1,183 @@
+#ifndef HAND_STORE_H_
+#define HAND_STORE_H_
+
+#include <XnOS.h>
+#include "FOVEdgeTracker.h"
+#include "HandTable.h"
+#include "HandHistory.h"
+#include "HandOverlay.h"
+
+/**
+ * The hands of a point drawer are kept in a HandStoreT, over the table type it was built with.
+ * This holds what does not depend on it
+ */
+class HandStore
+{
+public:
+	/**
+	 * Time pushing a position to every hand, publishing, placing the cursors and packing the overlay for 1, 4 and 16 hands,
+	 * with the runtime table and the compile-time ones. Prints ns per frame
+	 */
+	static void Benchmark(XnUInt32 nIterations);
+};
+
+/**
+ * The hands of a point drawer over a given table type, HandTable or HandHistory: the table NITE updates, the snapshots
+ * published for the display, and the overlay they are drawn with. Nothing in it is virtual, the drawer knows the type
+ * it holds, so every call on the hands' path is a direct one.
+ * NITE fills m_nBack, the display draws m_nFront, and they swap with m_nMiddle under m_hLock.
+ * Only the indices are swapped, never the tables.
+ * Each snapshot carries the time of its newest sample and when, locally, that sample was first published:
+ * the display adds the time since then to know where the sensor's clock is now
+ */
+template <class Table>
+class HandStoreT
+{
+public:
+	HandStoreT(XnUInt32 nCapacity) :
+		m_nBack(0), m_nMiddle(1), m_nFront(2), m_bFresh(false), m_fLatestTime(0), m_nLatestPublished(0)
+	{
+		// All the hand storage there will ever be
+		m_Hands.Allocate(nCapacity);
+		for (XnUInt32 i = 0; i < 3; ++i)
+		{
+			m_Snapshots[i].Allocate(nCapacity);
+			m_fSnapshotTime[i] = 0;
+			m_nSnapshotPublished[i] = 0;
+		}
+		m_Overlay.Allocate(nCapacity);
+		xnOSCreateCriticalSection(&m_hLock);
+	}
+	~HandStoreT()
+	{
+		xnOSCloseCriticalSection(&m_hLock);
+	}
+
+	/**
+	 * Add hand nID with no positions. INVALID_HAND_SLOT when there is no room for it
+	 */
+	XnUInt32 Add(XnUInt32 nID)
+	{
+		return m_Hands.Add(nID);
+	}
+	void Remove(XnUInt32 nID)
+	{
+		m_Hands.Remove(nID);
+	}
+	/**
+	 * Slot of hand nID in the table NITE updates, the one snapshots keep it in. INVALID_HAND_SLOT if it is not there
+	 */
+	XnUInt32 Find(XnUInt32 nID) const
+	{
+		return m_Hands.Find(nID);
+	}
+	/**
+	 * Append the newest position of hand nID, in projective coordinates, sampled at fTime on the sensor's clock.
+	 * Ignored for hands not in the store
+	 */
+	void Push(XnUInt32 nID, const XnPoint3D& ptProjective, XnFloat fTime)
+	{
+		XnUInt32 nSlot = m_Hands.Find(nID);
+		if (nSlot != INVALID_HAND_SLOT)
+			m_Hands.Push(nSlot, ptProjective, fTime);
+	}
+
+	/**
+	 * Copy the hands into a snapshot for the display, flagging the primary one and the edges each one touches.
+	 * Called on the NITE thread at the end of every update
+	 */
+	void Publish(XnUInt32 nPrimaryID, const FOVEdgeTracker& edges)
+	{
+		Table& hands = m_Snapshots[m_nBack];
+		hands.CopyFrom(m_Hands);
+
+		// From here on the edges are per slot, the display only tests bits
+		XnFloat fLatestTime = m_fLatestTime;
+		for (XnUInt32 nSlot = 0; nSlot < MAX_HANDS; ++nSlot)
+		{
+			if (!hands.IsUsed(nSlot))
+				continue;
+			hands.SetFlags(nSlot, hands.GetID(nSlot) == nPrimaryID, edges.Get(nSlot, hands.GetID(nSlot)));
+			if (hands.GetLength(nSlot) > 0 && hands.GetTime(nSlot) > fLatestTime)
+				fLatestTime = hands.GetTime(nSlot);
+		}
+
+		// Updates with no new sample keep the clock where it was, or it would jump back on every one of them
+		if (fLatestTime > m_fLatestTime)
+		{
+			m_fLatestTime = fLatestTime;
+			xnOSGetHighResTimeStamp(&m_nLatestPublished);
+		}
+		m_fSnapshotTime[m_nBack] = m_fLatestTime;
+		m_nSnapshotPublished[m_nBack] = m_nLatestPublished;
+
+		xnOSEnterCriticalSection(&m_hLock);
+		XnUInt32 nPublished = m_nBack;
+		m_nBack = m_nMiddle;
+		m_nMiddle = nPublished;
+		m_bFresh = true;
+		xnOSLeaveCriticalSection(&m_hLock);
+	}
+
+	/**
+	 * Take the newest snapshot, if there is one, and queue the drawing of its hands where the cursor places them
+	 * for now. Called on the display thread, every frame
+	 */
+	void Draw(RenderQueue& queue)
+	{
+		xnOSEnterCriticalSection(&m_hLock);
+		if (m_bFresh)
+		{
+			XnUInt32 nTaken = m_nMiddle;
+			m_nMiddle = m_nFront;
+			m_nFront = nTaken;
+			m_bFresh = false;
+		}
+		xnOSLeaveCriticalSection(&m_hLock);
+
+		// The sensor's clock now, from the microseconds since the snapshot's newest sample was published
+		XnUInt64 nNow;
+		xnOSGetHighResTimeStamp(&nNow);
+		XnFloat fNow = m_fSnapshotTime[m_nFront] + (XnFloat)((nNow - m_nSnapshotPublished[m_nFront])*1e-6);
+		m_Cursor.Update(m_Snapshots[m_nFront], fNow);
+
+		// All the hands in one batch of lines and one of points
+		m_Overlay.Prepare(m_Snapshots[m_nFront], &m_Cursor);
+		queue.Record(RenderQueue::LAYER_HANDS, 0, &m_Overlay, 0);
+	}
+	/**
+	 * How the hands are placed between samples. Only to be used on the display thread
+	 */
+	HandCursor& GetCursor()
+	{
+		return m_Cursor;
+	}
+
+	/**
+	 * Positions kept per hand
+	 */
+	XnUInt32 GetCapacity() const
+	{
+		return m_Hands.GetCapacity();
+	}
+protected:
+	HandStoreT(const HandStoreT&);
+	HandStoreT& operator=(const HandStoreT&);
+
+	Table m_Hands;
+	Table m_Snapshots[3];
+	XnFloat m_fSnapshotTime[3];
+	XnUInt64 m_nSnapshotPublished[3];
+	HandCursor m_Cursor;
+	HandOverlay m_Overlay;
+	XnUInt32 m_nBack;
+	XnUInt32 m_nMiddle;
+	XnUInt32 m_nFront;
+	XnBool m_bFresh;
+	// On the NITE thread: the newest sample time published so far, and when
+	XnFloat m_fLatestTime;
+	XnUInt64 m_nLatestPublished;
+	XN_CRITICAL_SECTION_HANDLE m_hLock;
+};
+
+#endif
@@ -0,0 +1,28 @@
+#include "HandTable.h"
+#include <string.h>
+
+HandTableStorage::HandTableStorage() :
+	m_nCapacity(0), m_pXY(NULL), m_pZ(NULL)
+{
+}
+
+HandTableStorage::~HandTableStorage()
+{
+	delete []m_pXY;
+	delete []m_pZ;
+}
+
+void HandTableStorage::Allocate(XnUInt32 nCapacity)
+{
+	delete []m_pXY;
+	delete []m_pZ;
+	m_nCapacity = nCapacity;
+	m_pXY = new XnFloat[MAX_HANDS*nCapacity*4];
+	m_pZ = new XnFloat[MAX_HANDS*nCapacity*2];
+}
+
+void HandTableStorage::CopySlot(XnUInt32 nSlot, const HandTableStorage& other)
+{
+	memcpy(m_pXY + nSlot*m_nCapacity*4, other.m_pXY + nSlot*m_nCapacity*4, m_nCapacity*4*sizeof(XnFloat));
+	memcpy(m_pZ + nSlot*m_nCapacity*2, other.m_pZ + nSlot*m_nCapacity*2, m_nCapacity*2*sizeof(XnFloat));
+}
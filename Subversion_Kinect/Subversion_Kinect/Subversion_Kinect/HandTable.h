@@ -0,0 +1,78 @@
+#ifndef HAND_TABLE_H_
+#define HAND_TABLE_H_
+
+#include <XnPlatform.h>
+#include <XnTypes.h>
+#include "HandRing.h"
+
+/**
+ * What a hand table keeps of every position: x and y in projective coordinates, or all of x, y and z
+ */
+typedef enum
+{
+	HAND_LAYOUT_PROJECTIVE,
+	HAND_LAYOUT_3D
+} HandLayout;
+
+/**
+ * Where a HandTable keeps its positions: rings of a capacity chosen at runtime, allocated up front.
+ * The rings are split in arrays: x and y pairs, the way GL takes vertices, and depths on their own.
+ */
+class HandTableStorage
+{
+public:
+	HandTableStorage();
+	~HandTableStorage();
+
+	void Allocate(XnUInt32 nCapacity);
+	XnUInt32 GetCapacity() const
+	{
+		return m_nCapacity;
+	}
+	XnUInt32 Next(XnUInt32 nHead) const
+	{
+		return nHead + 1 == m_nCapacity ? 0 : nHead + 1;
+	}
+	void Write(XnUInt32 nSlot, XnUInt32 nHead, const XnPoint3D& ptPosition)
+	{
+		XnFloat* pXY = m_pXY + nSlot*m_nCapacity*4;
+		XnFloat* pZ = m_pZ + nSlot*m_nCapacity*2;
+
+		// Once here, and once a capacity further, where the span of the next laps reads it
+		pXY[2*nHead] = pXY[2*(nHead + m_nCapacity)] = ptPosition.X;
+		pXY[2*nHead + 1] = pXY[2*(nHead + m_nCapacity) + 1] = ptPosition.Y;
+		pZ[nHead] = pZ[nHead + m_nCapacity] = ptPosition.Z;
+	}
+	const XnFloat* GetPositions(XnUInt32 nSlot, XnUInt32 nFirst) const
+	{
+		return m_pXY + nSlot*m_nCapacity*4 + 2*nFirst;
+	}
+	const XnFloat* GetZ(XnUInt32 nSlot, XnUInt32 nFirst) const
+	{
+		return m_pZ + nSlot*m_nCapacity*2 + nFirst;
+	}
+	static XnUInt32 GetComponents()
+	{
+		return 2;
+	}
+	void CopySlot(XnUInt32 nSlot, const HandTableStorage& other);
+private:
+	HandTableStorage(const HandTableStorage&);
+	HandTableStorage& operator=(const HandTableStorage&);
+
+	XnUInt32 m_nCapacity;
+	// 2*m_nCapacity x, y pairs and 2*m_nCapacity depths per slot
+	XnFloat* m_pXY;
+	XnFloat* m_pZ;
+};
+
+/**
+ * The recent positions of every tracked hand, in one ring per hand of a capacity chosen at runtime.
+ * All the storage is allocated up front: adding hands, positions or copying tables allocates nothing.
+ * The positions are x, y pairs, their depths are apart, in GetZ.
+ */
+class HandTable : public HandRing<HandTableStorage>
+{
+};
+
+#endif
@@ -0,0 +1,253 @@
+#include "HandTrajectories.h"
+#include <math.h>
+#include <stdio.h>
+
+static const XnFloat fTwoPi = 6.2831853f;
+
+HandTrajectories::HandTrajectories() :
+	m_nHands(0)
+{
+}
+
+static XnFloat Distance2(const XnPoint3D& a, const XnPoint3D& b)
+{
+	return (a.X - b.X)*(a.X - b.X) + (a.Y - b.Y)*(a.Y - b.Y) + (a.Z - b.Z)*(a.Z - b.Z);
+}
+
+// Normally distributed noise, from a fixed seed so every run sees the same
+static XnFloat Gaussian(XnUInt32& nSeed)
+{
+	nSeed = nSeed*1664525 + 1013904223;
+	XnFloat fU1 = ((nSeed >> 8) + 1)/16777217.0f;
+	nSeed = nSeed*1664525 + 1013904223;
+	XnFloat fU2 = (nSeed >> 8)/16777216.0f;
+	return (XnFloat)(sqrt(-2*log(fU1))*cos(fTwoPi*fU2));
+}
+
+// Where the synthetic hand is at time t
+static void SyntheticHand(XnFloat t, XnPoint3D& pt)
+{
+	pt.X = 200*(XnFloat)sin(fTwoPi*0.5f*t) + 100*(XnFloat)sin(fTwoPi*1.3f*t);
+	pt.Y = 150*(XnFloat)sin(fTwoPi*0.7f*t + 1);
+	pt.Z = 1500 + 100*(XnFloat)sin(fTwoPi*0.3f*t);
+}
+
+XnStatus HandTrajectories::Load(const XnChar* strFile)
+{
+	FILE* pFile = fopen(strFile, "r");
+	if (pFile == NULL)
+	{
+		printf("Can't open %s\n", strFile);
+		return XN_STATUS_ERROR;
+	}
+
+	m_Samples.clear();
+	XnUInt32 ids[MAX_HANDS];
+	m_nHands = 0;
+	XnChar strLine[256];
+	while (fgets(strLine, sizeof(strLine), pFile) != NULL)
+	{
+		Sample sample;
+		XnUInt32 nID;
+		if (strLine[0] == '#' || sscanf(strLine, "%f,%u,%f,%f,%f", &sample.fTime, &nID, &sample.ptRaw.X, &sample.ptRaw.Y, &sample.ptRaw.Z) != 5)
+			continue;
+
+		for (sample.nLane = 0; sample.nLane < m_nHands && ids[sample.nLane] != nID; ++sample.nLane)
+			;
+		if (sample.nLane == m_nHands)
+		{
+			if (m_nHands == MAX_HANDS)
+				continue;
+			ids[m_nHands++] = nID;
+		}
+		m_Samples.push_back(sample);
+	}
+	fclose(pFile);
+
+	Link();
+	SmoothReference();
+	return XN_STATUS_OK;
+}
+
+void HandTrajectories::Synthesize(XnFloat fLateMs, XnFloat fNoise)
+{
+	m_Samples.clear();
+	m_nHands = 1;
+	XnUInt32 nSeed = 1;
+	for (XnUInt32 i = 0; i < 600; ++i)
+	{
+		Sample sample;
+		sample.fTime = i/30.0f;
+		sample.nLane = 0;
+		SyntheticHand(sample.fTime, sample.ptReference);
+		SyntheticHand(sample.fTime - fLateMs/1000.0f, sample.ptRaw);
+		sample.ptRaw.X += fNoise*Gaussian(nSeed);
+		sample.ptRaw.Y += fNoise*Gaussian(nSeed);
+		sample.ptRaw.Z += fNoise*Gaussian(nSeed);
+		m_Samples.push_back(sample);
+	}
+	Link();
+}
+
+XnUInt32 HandTrajectories::GetSampleCount() const
+{
+	return (XnUInt32)m_Samples.size();
+}
+XnUInt32 HandTrajectories::GetHandCount() const
+{
+	return m_nHands;
+}
+
+// Link every sample to the previous and next ones of its hand
+void HandTrajectories::Link()
+{
+	XnInt32 last[MAX_HANDS];
+	for (XnUInt32 nLane = 0; nLane < MAX_HANDS; ++nLane)
+	{
+		last[nLane] = -1;
+	}
+	for (XnUInt32 i = 0; i < m_Samples.size(); ++i)
+	{
+		Sample& sample = m_Samples[i];
+		sample.nPrevious = last[sample.nLane];
+		sample.nNext = -1;
+		if (sample.nPrevious >= 0)
+			m_Samples[sample.nPrevious].nNext = i;
+		last[sample.nLane] = i;
+	}
+}
+
+// The reference of every sample: its hand's raw positions within three deviations of it on either side,
+// weighted by a Gaussian of their distance in time. Both sides alike, so it does not lag
+void HandTrajectories::SmoothReference()
+{
+	XnFloat fDeviation = REFERENCE_SMOOTHING_MS/1000.0f;
+	for (XnUInt32 i = 0; i < m_Samples.size(); ++i)
+	{
+		Sample& sample = m_Samples[i];
+		XnDouble fX = sample.ptRaw.X, fY = sample.ptRaw.Y, fZ = sample.ptRaw.Z, fWeights = 1;
+		for (XnUInt32 nSide = 0; nSide < 2; ++nSide)
+		{
+			XnInt32 n = nSide == 0 ? sample.nPrevious : sample.nNext;
+			while (n >= 0 && fabs(m_Samples[n].fTime - sample.fTime) <= 3*fDeviation)
+			{
+				const Sample& other = m_Samples[n];
+				XnFloat fDistance = (other.fTime - sample.fTime)/fDeviation;
+				XnDouble fWeight = exp(-0.5*fDistance*fDistance);
+				fX += fWeight*other.ptRaw.X;
+				fY += fWeight*other.ptRaw.Y;
+				fZ += fWeight*other.ptRaw.Z;
+				fWeights += fWeight;
+				n = nSide == 0 ? other.nPrevious : other.nNext;
+			}
+		}
+		sample.ptReference.X = (XnFloat)(fX/fWeights);
+		sample.ptReference.Y = (XnFloat)(fY/fWeights);
+		sample.ptReference.Z = (XnFloat)(fZ/fWeights);
+	}
+}
+
+// Reference position at fTime of the hand of sample i, between its samples. False outside of them
+XnBool HandTrajectories::ReferenceAt(XnUInt32 i, XnFloat fTime, XnPoint3D& pt) const
+{
+	XnInt32 nAfter = i;
+	while (m_Samples[nAfter].nPrevious >= 0 && m_Samples[m_Samples[nAfter].nPrevious].fTime >= fTime)
+		nAfter = m_Samples[nAfter].nPrevious;
+	while (nAfter >= 0 && m_Samples[nAfter].fTime < fTime)
+		nAfter = m_Samples[nAfter].nNext;
+	if (nAfter < 0)
+		return false;
+
+	const Sample& after = m_Samples[nAfter];
+	if (after.fTime == fTime)
+	{
+		pt = after.ptReference;
+		return true;
+	}
+	if (after.nPrevious < 0)
+		return false;
+
+	const Sample& before = m_Samples[after.nPrevious];
+	XnFloat f = (fTime - before.fTime)/(after.fTime - before.fTime);
+	pt.X = before.ptReference.X + f*(after.ptReference.X - before.ptReference.X);
+	pt.Y = before.ptReference.Y + f*(after.ptReference.Y - before.ptReference.Y);
+	pt.Z = before.ptReference.Z + f*(after.ptReference.Z - before.ptReference.Z);
+	return true;
+}
+
+HandTrajectories::Score HandTrajectories::Run(const HandFilter& filter)
+{
+	HandFilter copy = filter;
+	for (XnUInt32 nLane = 0; nLane < MAX_HANDS; ++nLane)
+	{
+		copy.Reset(nLane);
+	}
+	for (XnUInt32 i = 0; i < m_Samples.size(); ++i)
+	{
+		m_Samples[i].ptFiltered = m_Samples[i].ptRaw;
+		copy.Filter(1, &m_Samples[i].nLane, &m_Samples[i].ptFiltered, &m_Samples[i].fTime);
+	}
+
+	Score score;
+	XnFloat fBest = -1;
+	score.fLagMs = 0;
+	for (XnInt32 nLag = -150; nLag <= 300; nLag += 2)
+	{
+		XnDouble fSum = 0;
+		XnUInt32 nSum = 0;
+		for (XnUInt32 i = 0; i < m_Samples.size(); ++i)
+		{
+			XnPoint3D pt;
+			if (ReferenceAt(i, m_Samples[i].fTime - nLag/1000.0f, pt))
+			{
+				fSum += Distance2(m_Samples[i].ptFiltered, pt);
+				nSum++;
+			}
+		}
+		if (nSum > 0 && (fBest < 0 || fSum/nSum < fBest))
+		{
+			fBest = (XnFloat)(fSum/nSum);
+			score.fLagMs = (XnFloat)nLag;
+		}
+	}
+
+	XnDouble fJitterSum = 0, fErrorSum = 0;
+	XnUInt32 nJitter = 0;
+	for (XnUInt32 i = 0; i < m_Samples.size(); ++i)
+	{
+		const Sample& sample = m_Samples[i];
+		fErrorSum += Distance2(sample.ptFiltered, sample.ptReference);
+
+		if (sample.nPrevious < 0 || m_Samples[sample.nPrevious].nPrevious < 0)
+			continue;
+		const XnPoint3D& pt1 = m_Samples[sample.nPrevious].ptFiltered;
+		const XnPoint3D& pt2 = m_Samples[m_Samples[sample.nPrevious].nPrevious].ptFiltered;
+		XnFloat fX = sample.ptFiltered.X - 2*pt1.X + pt2.X;
+		XnFloat fY = sample.ptFiltered.Y - 2*pt1.Y + pt2.Y;
+		XnFloat fZ = sample.ptFiltered.Z - 2*pt1.Z + pt2.Z;
+		fJitterSum += fX*fX + fY*fY + fZ*fZ;
+		nJitter++;
+	}
+	score.fJitter = nJitter == 0 ? 0 : (XnFloat)sqrt(fJitterSum/nJitter);
+	score.fError = m_Samples.empty() ? 0 : (XnFloat)sqrt(fErrorSum/m_Samples.size());
+	return score;
+}
+
+void HandTrajectories::PrintScores(XnFloat fPredictionMs)
+{
+	printf("  %-10s %10s %8s %10s %10s\n", "filter", "predict", "lag", "jitter", "error");
+	HandFilter::Type types[] = {HandFilter::FILTER_NONE, HandFilter::FILTER_ONE_EURO, HandFilter::FILTER_KALMAN};
+	XnFloat predictions[] = {0, fPredictionMs};
+	for (XnUInt32 t = 0; t < 3; ++t)
+	{
+		for (XnUInt32 p = 0; p < 2; ++p)
+		{
+			HandFilter filter;
+			filter.SetType(types[t]);
+			filter.SetPrediction(predictions[p]);
+			Score score = Run(filter);
+			printf("  %-10s %7.0f ms %5.0f ms %7.2f mm %7.2f mm\n", HandFilter::GetTypeName(types[t]), predictions[p],
+				score.fLagMs, score.fJitter, score.fError);
+		}
+	}
+}
@@ -0,0 +1,76 @@
+#ifndef HAND_TRAJECTORIES_H_
+#define HAND_TRAJECTORIES_H_
+
+#include <vector>
+#include "HandFilter.h"
+
+// Deviation of the offline smoothing a recording's reference is made with, in ms
+#define REFERENCE_SMOOTHING_MS 50.0f
+
+/**
+ * Hand trajectories to score the hand filters on. Every sample has the position the sensor reported and a
+ * reference for it, where the hand was: for a synthetic hand its true path, for a recording the recording
+ * itself smoothed offline, centered on every sample so it neither lags nor leads.
+ * A recording's reference cannot tell how late the sensor was, so prediction is only scored fairly on the
+ * synthetic hand, whose lateness is known.
+ */
+class HandTrajectories
+{
+public:
+	/**
+	 * How a filter did: the delay of the reference its output follows closest, in ms, the RMS second difference
+	 * of its output, which white noise of deviation s raises by s*sqrt(6), and its RMS distance to the reference,
+	 * both in mm
+	 */
+	typedef struct
+	{
+		XnFloat fLagMs;
+		XnFloat fJitter;
+		XnFloat fError;
+	} Score;
+
+	HandTrajectories();
+
+	/**
+	 * Read the trajectories strFile holds, as written by XnVHandFilter's recording
+	 */
+	XnStatus Load(const XnChar* strFile);
+	/**
+	 * 20 s of one hand waving at 30 Hz, reported fLateMs late with fNoise mm of normal noise on every axis.
+	 * The noise is the same on every call
+	 */
+	void Synthesize(XnFloat fLateMs, XnFloat fNoise);
+
+	XnUInt32 GetSampleCount() const;
+	XnUInt32 GetHandCount() const;
+
+	/**
+	 * Run a copy of filter, every hand started over, over the trajectories
+	 */
+	Score Run(const HandFilter& filter);
+	/**
+	 * Print the score of every filter, without and with fPredictionMs of prediction
+	 */
+	void PrintScores(XnFloat fPredictionMs);
+protected:
+	// One sample, what a filter made of it, and its neighbours of the same hand
+	typedef struct
+	{
+		XnFloat fTime;
+		XnUInt32 nLane;
+		XnPoint3D ptRaw;
+		XnPoint3D ptReference;
+		XnPoint3D ptFiltered;
+		XnInt32 nPrevious;
+		XnInt32 nNext;
+	} Sample;
+
+	void Link();
+	void SmoothReference();
+	XnBool ReferenceAt(XnUInt32 i, XnFloat fTime, XnPoint3D& pt) const;
+
+	std::vector<Sample> m_Samples;
+	XnUInt32 m_nHands;
+};
+
+#endif
@@ -0,0 +1,50 @@
+#include "HandZoomControl.h"
+#include "Atomics.h"
+
+XnVHandZoom::XnVHandZoom(PlayerDispatcher& dispatcher) :
+	XnVPointControl("XnVHandZoom"), m_Dispatcher(dispatcher), m_nEnabled(0), m_nReanchor(1), m_fAnchorZ(0),
+	m_fAnchorZoom(ZOOM_DEFAULT)
+{
+}
+
+void XnVHandZoom::SetEnabled(XnBool bEnabled)
+{
+	// Anchored again on the next position, at whatever zoom the swipes left it
+	AtomicExchange(&m_nReanchor, 1);
+	AtomicExchange(&m_nEnabled, bEnabled ? 1 : 0);
+}
+
+XnBool XnVHandZoom::IsEnabled() const
+{
+	return AtomicLoad((volatile XnUInt32*)&m_nEnabled) != 0;
+}
+
+void XnVHandZoom::OnPrimaryPointCreate(const XnVHandPointContext* cxt, const XnPoint3D& ptFocus)
+{
+	AtomicExchange(&m_nReanchor, 1);
+	OnPrimaryPointUpdate(cxt);
+}
+
+void XnVHandZoom::OnPrimaryPointUpdate(const XnVHandPointContext* cxt)
+{
+	if (!IsEnabled())
+		return;
+
+	if (AtomicExchange(&m_nReanchor, 0) != 0)
+	{
+		PlayerState player;
+		m_Dispatcher.GetPlayerState(player);
+		m_fAnchorZ = cxt->ptPosition.Z;
+		// Within what the hand can reach, or its first target would jump there
+		m_fAnchorZoom = player.fZoom < ZOOM_MIN ? ZOOM_MIN : player.fZoom > ZOOM_MAX ? ZOOM_MAX : player.fZoom;
+		return;
+	}
+
+	m_Dispatcher.SetZoomTarget(ZoomStream::ForHandDepth(cxt->ptPosition.Z, m_fAnchorZ, m_fAnchorZoom));
+}
+
+void XnVHandZoom::OnPrimaryPointDestroy(XnUInt32 nID)
+{
+	// Whichever hand comes next starts where the zoom was left
+	AtomicExchange(&m_nReanchor, 1);
+}
@@ -0,0 +1,35 @@
+#ifndef HAND_ZOOM_CONTROL_H_
+#define HAND_ZOOM_CONTROL_H_
+
+#include <XnVPointControl.h>
+#include "PlayerDispatcher.h"
+
+/**
+ * The continuous zoom: while it is on, the primary hand's distance to the sensor sets the player's zoom, closer
+ * zooming in, with ZoomStream::ForHandDepth. The zoom the player was at when the hand was first seen, taken from
+ * the dispatcher's mirror and brought within ZOOM_MIN and ZOOM_MAX, is where the hand starts from, so the zoom
+ * never jumps when it is turned on or when the hand comes back. Pushes are the hand zooming in, not stops, while
+ * it is on. Every position becomes a target for the dispatcher, which decides what is sent.
+ * NITE updates it on its own thread, it can be turned on and off from any thread.
+ */
+class XnVHandZoom : public XnVPointControl
+{
+public:
+	XnVHandZoom(PlayerDispatcher& dispatcher);
+
+	void SetEnabled(XnBool bEnabled);
+	XnBool IsEnabled() const;
+
+	void OnPrimaryPointCreate(const XnVHandPointContext* cxt, const XnPoint3D& ptFocus);
+	void OnPrimaryPointUpdate(const XnVHandPointContext* cxt);
+	void OnPrimaryPointDestroy(XnUInt32 nID);
+protected:
+	PlayerDispatcher& m_Dispatcher;
+	volatile XnUInt32 m_nEnabled;
+	// Set when the hand has to start over from the zoom the player is at
+	volatile XnUInt32 m_nReanchor;
+	XnFloat m_fAnchorZ;
+	XnDouble m_fAnchorZoom;
+};
+
+#endif
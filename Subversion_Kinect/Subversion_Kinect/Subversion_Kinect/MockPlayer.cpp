@@ -0,0 +1,313 @@
+#include "MockPlayer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef _WIN32
+	#include <errno.h>
+	#include <sys/socket.h>
+	#include <sys/un.h>
+	#include <unistd.h>
+#endif
+
+// Most fields a request has
+#define MOCK_MAX_FIELDS 6
+
+MockPlayer::MockPlayer(XnUInt32 nLatencyMs, XnUInt32 nJitterMs) :
+	m_nLatencyMs(nLatencyMs), m_nJitterMs(nJitterMs),
+	m_bOpen(false), m_ePlayback(PLAYBACK_STOP), m_fZoom(ZOOM_DEFAULT), m_bFullScreen(false), m_bRepeat(false),
+	m_fPosition(0), m_nAdvanced(0), m_nRequests(0), m_nRefused(0), m_nDelaySum(0)
+{
+	m_strFile[0] = '\0';
+}
+
+const XnChar* MockPlayer::GetFile() const
+{
+	return m_strFile;
+}
+
+void MockPlayer::Answer(XnChar* strRequest, XnChar* strReply, XnUInt32 nReplySize)
+{
+	// Split on the tabs, in place
+	XnChar* fields[MOCK_MAX_FIELDS];
+	XnUInt32 nFields = 0;
+	for (XnChar* pField = strRequest; pField != NULL && nFields < MOCK_MAX_FIELDS; ++nFields)
+	{
+		fields[nFields] = pField;
+		pField = strchr(pField, '\t');
+		if (pField != NULL)
+			*pField++ = '\0';
+		SocketPlayerBackend::Unescape(fields[nFields]);
+	}
+
+	// As long as the player would take over it
+	XnUInt32 nDelay = m_nLatencyMs + (m_nJitterMs == 0 ? 0 : (XnUInt32)rand() % (m_nJitterMs + 1));
+	xnOSSleep(nDelay);
+	m_nDelaySum += nDelay;
+	m_nRequests++;
+	Advance();
+
+	const XnChar* strError = NULL;
+	const XnChar* strCommand = fields[0];
+	XnDouble fDuration = -1;
+	XnBool bState = false;
+	if (strcmp(strCommand, "OPEN") == 0 && nFields == 2)
+	{
+		xnOSStrCopy(m_strFile, fields[1], sizeof(m_strFile));
+		m_bOpen = true;
+		m_ePlayback = PLAYBACK_PLAY;
+		m_fPosition = 0;
+		m_fZoom = ZOOM_DEFAULT;
+		m_bFullScreen = false;
+	}
+	else if (strcmp(strCommand, "OPENLR") == 0 && (nFields == 4 || nFields == 5))
+	{
+		// As StereoPlayer: audio mode 1 is a separate audio file
+		if (atoi(fields[1]) == 1 && nFields == 4)
+		{
+			strError = "audio mode 1 needs an audio file";
+		}
+		else
+		{
+			// The left one names the pair
+			xnOSStrCopy(m_strFile, fields[2], sizeof(m_strFile));
+			m_bOpen = true;
+			m_ePlayback = PLAYBACK_PLAY;
+			m_fPosition = 0;
+			m_fZoom = ZOOM_DEFAULT;
+			m_bFullScreen = false;
+		}
+	}
+	else if (strcmp(strCommand, "CLOSE") == 0 && nFields == 1)
+	{
+		m_bOpen = false;
+		m_ePlayback = PLAYBACK_STOP;
+	}
+	else if (!m_bOpen && (strcmp(strCommand, "DURATION") == 0 || strcmp(strCommand, "PLAYBACK") == 0 ||
+		strcmp(strCommand, "ZOOM") == 0 || strcmp(strCommand, "FULLSCREEN") == 0 || strcmp(strCommand, "REPEAT") == 0 ||
+		strcmp(strCommand, "STATE") == 0))
+	{
+		strError = "no video open";
+	}
+	else if (strcmp(strCommand, "DURATION") == 0 && nFields == 1)
+	{
+		fDuration = MOCK_VIDEO_DURATION;
+	}
+	else if (strcmp(strCommand, "PLAYBACK") == 0 && nFields == 2)
+	{
+		if (strcmp(fields[1], "PLAY") == 0)
+			m_ePlayback = PLAYBACK_PLAY;
+		else if (strcmp(fields[1], "PAUSE") == 0)
+			m_ePlayback = PLAYBACK_PAUSE;
+		else if (strcmp(fields[1], "STOP") == 0)
+		{
+			m_ePlayback = PLAYBACK_STOP;
+			m_fPosition = 0;
+		}
+		else
+			strError = "unknown playback state";
+	}
+	else if (strcmp(strCommand, "ZOOM") == 0 && nFields == 2)
+	{
+		XnChar* pEnd;
+		XnDouble fZoom = strtod(fields[1], &pEnd);
+		// Written out in full, so a NaN, which fails every comparison, is out of range too
+		if (pEnd == fields[1] || *pEnd != '\0' || !(fZoom >= ZOOM_MIN && fZoom <= ZOOM_MAX))
+			strError = "zoom out of range";
+		else
+			m_fZoom = fZoom;
+	}
+	else if (strcmp(strCommand, "FULLSCREEN") == 0 && nFields == 2)
+	{
+		m_bFullScreen = atoi(fields[1]) != 0;
+	}
+	else if (strcmp(strCommand, "REPEAT") == 0 && nFields == 2)
+	{
+		m_bRepeat = atoi(fields[1]) != 0;
+	}
+	else if (strcmp(strCommand, "STATE") == 0 && nFields == 1)
+	{
+		bState = true;
+	}
+	else
+	{
+		strError = "unknown request";
+	}
+
+	XnUInt32 nWritten;
+	if (strError != NULL)
+	{
+		m_nRefused++;
+		xnOSStrFormat(strReply, nReplySize, &nWritten, "ERR\t%s", strError);
+	}
+	else if (fDuration >= 0)
+	{
+		xnOSStrFormat(strReply, nReplySize, &nWritten, "OK\t%.3f", fDuration);
+	}
+	else if (bState)
+	{
+		static const XnChar* states[] = {"PLAY", "PAUSE", "STOP"};
+		xnOSStrFormat(strReply, nReplySize, &nWritten, "OK\t%s\t%.3f\t%.3f\t%.3f\t%d", states[m_ePlayback],
+			m_fPosition, MOCK_VIDEO_DURATION, m_fZoom, m_bFullScreen ? 1 : 0);
+	}
+	else
+	{
+		xnOSStrCopy(strReply, "OK", nReplySize);
+	}
+}
+
+void MockPlayer::Advance()
+{
+	XnUInt64 nNow;
+	xnOSGetHighResTimeStamp(&nNow);
+	if (m_bOpen && m_ePlayback == PLAYBACK_PLAY && m_nAdvanced != 0)
+	{
+		m_fPosition += (nNow - m_nAdvanced)/1000000.0;
+		if (m_fPosition >= MOCK_VIDEO_DURATION)
+		{
+			if (m_bRepeat)
+			{
+				m_fPosition = fmod(m_fPosition, MOCK_VIDEO_DURATION);
+			}
+			else
+			{
+				m_fPosition = MOCK_VIDEO_DURATION;
+				m_ePlayback = PLAYBACK_STOP;
+			}
+		}
+	}
+	m_nAdvanced = nNow;
+}
+
+void MockPlayer::PrintStats() const
+{
+	static const XnChar* states[] = {"playing", "paused", "stopped"};
+	printf("Mock player: %u requests answered, %u refused, %.1f ms on average. Left %s %s, at %.0f%%%s%s\n",
+		m_nRequests, m_nRefused, m_nRequests == 0 ? 0 : (XnDouble)m_nDelaySum/m_nRequests,
+		m_bOpen ? m_strFile : "no video", states[m_ePlayback], m_fZoom, m_bFullScreen ? ", full screen" : "",
+		m_bRepeat ? ", repeating" : "");
+}
+
+#ifdef _WIN32
+
+int MockPlayer::Serve(const XnChar* strSocket, XnUInt32 nLatencyMs, XnUInt32 nJitterMs)
+{
+	printf("Mock player on %s: Unix sockets are not available here\n", strSocket);
+	return 1;
+}
+
+void MockPlayer::Converse(int nSocket)
+{
+}
+
+#else
+
+int MockPlayer::Serve(const XnChar* strSocket, XnUInt32 nLatencyMs, XnUInt32 nJitterMs)
+{
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (strlen(strSocket) >= sizeof(address.sun_path))
+	{
+		printf("Mock player on %s: the path is too long for a socket\n", strSocket);
+		return 1;
+	}
+	strcpy(address.sun_path, strSocket);
+
+	int nListener = socket(AF_UNIX, SOCK_STREAM, 0);
+	// A socket left by an earlier run would be in the way
+	unlink(strSocket);
+	if (nListener < 0 || bind(nListener, (sockaddr*)&address, sizeof(address)) != 0 || listen(nListener, 1) != 0)
+	{
+		printf("Mock player on %s: cannot listen: %s\n", strSocket, strerror(errno));
+		return 1;
+	}
+	printf("Mock player on %s: answering in %u ms, and up to %u ms more\n", strSocket, nLatencyMs, nJitterMs);
+	// It runs until killed, likely with its output in a file
+	fflush(stdout);
+
+	// The same jitter run after run
+	srand(1);
+	for (;;)
+	{
+		int nClient = accept(nListener, NULL, NULL);
+		if (nClient < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			printf("Mock player on %s: accept failed: %s\n", strSocket, strerror(errno));
+			close(nListener);
+			return 1;
+		}
+
+		// Each client finds a player just started
+		MockPlayer player(nLatencyMs, nJitterMs);
+		player.Converse(nClient);
+		close(nClient);
+		player.PrintStats();
+		fflush(stdout);
+	}
+}
+
+void MockPlayer::Converse(int nSocket)
+{
+	XnChar received[PLAYER_LINE_MAX];
+	XnUInt32 nReceived = 0;
+	XnChar strReply[PLAYER_LINE_MAX];
+	// Dropping the rest of a request too long to be taken
+	XnBool bDropping = false;
+
+	for (;;)
+	{
+		XnChar* pEnd = (XnChar*)memchr(received, '\n', nReceived);
+		if (pEnd == NULL)
+		{
+			// Not a request the protocol has: dropped up to its newline, and refused there
+			if (nReceived == sizeof(received))
+			{
+				nReceived = 0;
+				bDropping = true;
+			}
+			ssize_t nRead = recv(nSocket, received + nReceived, sizeof(received) - nReceived, 0);
+			if (nRead < 0 && errno == EINTR)
+				continue;
+			if (nRead <= 0)
+				return;
+			nReceived += (XnUInt32)nRead;
+			continue;
+		}
+
+		*pEnd = '\0';
+		if (bDropping)
+		{
+			bDropping = false;
+			m_nRequests++;
+			m_nRefused++;
+			xnOSStrCopy(strReply, "ERR\trequest too long", sizeof(strReply) - 1);
+		}
+		else
+			Answer(received, strReply, sizeof(strReply) - 1);
+		XnUInt32 nLength = (XnUInt32)strlen(strReply);
+		strReply[nLength++] = '\n';
+		nReceived -= (XnUInt32)(pEnd + 1 - received);
+		memmove(received, pEnd + 1, nReceived);
+
+		for (XnUInt32 nSent = 0; nSent < nLength; )
+		{
+			// A client that left is the end of the conversation, not a SIGPIPE
+#ifdef MSG_NOSIGNAL
+			ssize_t nWritten = send(nSocket, strReply + nSent, nLength - nSent, MSG_NOSIGNAL);
+#else
+			ssize_t nWritten = send(nSocket, strReply + nSent, nLength - nSent, 0);
+#endif
+			if (nWritten < 0 && errno == EINTR)
+				continue;
+			if (nWritten <= 0)
+				return;
+			nSent += (XnUInt32)nWritten;
+		}
+	}
+}
+
+#endif
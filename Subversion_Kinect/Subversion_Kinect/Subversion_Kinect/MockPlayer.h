@@ -0,0 +1,58 @@
+#ifndef MOCK_PLAYER_H_
+#define MOCK_PLAYER_H_
+
+#include "SocketPlayerBackend.h"
+
+// How long the videos the mock player opens are, in seconds
+#define MOCK_VIDEO_DURATION 60.0
+
+/**
+ * Stands in for StereoPlayer behind a Unix socket, speaking SocketPlayerBackend's protocol, so the gestures' commands
+ * can be driven end to end, and timed, without Windows. Keeps the state a player would, and refuses what StereoPlayer
+ * would, such as a command with no video open. Every answer takes the given latency, plus up to the given jitter.
+ * Its videos play in real time, and without repeat stop by themselves at the end, as StereoPlayer's do.
+ */
+class MockPlayer
+{
+public:
+	MockPlayer(XnUInt32 nLatencyMs, XnUInt32 nJitterMs);
+
+	/**
+	 * Answer one request line, without its newline. strReply gets the reply line, without its newline
+	 */
+	void Answer(XnChar* strRequest, XnChar* strReply, XnUInt32 nReplySize);
+	/**
+	 * The video last opened, the left one of a pair
+	 */
+	const XnChar* GetFile() const;
+
+	/**
+	 * Listen on strSocket and serve one client at a time, until killed. A request too long for the protocol is
+	 * refused, and the ones after it answered. Returns the process' exit code
+	 */
+	static int Serve(const XnChar* strSocket, XnUInt32 nLatencyMs, XnUInt32 nJitterMs);
+protected:
+	// Answer one client until it leaves
+	void Converse(int nSocket);
+	void PrintStats() const;
+	// Move the position on to now, while playing
+	void Advance();
+
+	XnUInt32 m_nLatencyMs;
+	XnUInt32 m_nJitterMs;
+
+	XnBool m_bOpen;
+	XnChar m_strFile[PLAYER_LINE_MAX];
+	PlaybackState m_ePlayback;
+	XnDouble m_fZoom;
+	XnBool m_bFullScreen;
+	XnBool m_bRepeat;
+	XnDouble m_fPosition;
+	XnUInt64 m_nAdvanced;
+
+	XnUInt32 m_nRequests;
+	XnUInt32 m_nRefused;
+	XnUInt64 m_nDelaySum;
+};
+
+#endif
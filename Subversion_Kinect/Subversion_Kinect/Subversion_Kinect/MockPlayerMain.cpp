@@ -0,0 +1,51 @@
+//The mock player, out of the viewer: stands in for StereoPlayer on a Unix socket, and drives gestures' commands
+//through it the way the viewer does, timed. Needs no sensor, NITE, window or Windows
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+//local headers
+#include "PlayerDispatcher.h"
+#include "SocketPlayerBackend.h"
+#include "MockPlayer.h"
+
+//how often the benchmark reads the player's state back, in ms, as the viewer does
+#define BENCHMARK_POLL_MS 250
+
+static void PrintUsage()
+{
+	printf("Usage: MockPlayer serve [socket] [latency ms] [jitter ms]\n");
+	printf("       MockPlayer benchmark [socket] [gestures] [per s] [poll ms]\n");
+}
+
+int main(int argc, char ** argv)
+{
+	if (argc < 2)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	// A number where the socket goes is the first of the numbers, on the default socket
+	XnBool bSocket = argc > 2 && !isdigit((unsigned char)argv[2][0]);
+	const XnChar* strSocket = bSocket ? argv[2] : PLAYER_SOCKET;
+	XnInt32 nArg = bSocket ? 3 : 2;
+
+	//answer in a given latency plus jitter, until killed
+	if (strcmp(argv[1], "serve") == 0)
+	{
+		return MockPlayer::Serve(strSocket, argc > nArg ? atoi(argv[nArg]) : 5, argc > nArg + 1 ? atoi(argv[nArg + 1]) : 5);
+	}
+	//how many gestures go through a second and how long they take, with the state read back every so many ms
+	if (strcmp(argv[1], "benchmark") == 0)
+	{
+		SocketPlayerBackend player(strSocket);
+		return PlayerDispatcher::Benchmark(&player, "benchmark.mov", argc > nArg ? atoi(argv[nArg]) : 1000,
+			argc > nArg + 1 ? atoi(argv[nArg + 1]) : 100, argc > nArg + 2 ? atoi(argv[nArg + 2]) : BENCHMARK_POLL_MS);
+	}
+
+	PrintUsage();
+	return 1;
+}
@@ -0,0 +1,144 @@
+#include "NiteWorker.h"
+#include "Atomics.h"
+#include <stdio.h>
+
+// How long the worker waits for a frame before checking whether it should stop
+#define NEW_FRAME_TIMEOUT 100
+
+NiteWorker::NiteWorker() :
+	m_pSessionManager(NULL), m_pAcquirer(NULL), m_pUpdateHandler(NULL), m_pUpdateCookie(NULL), m_hThread(NULL), m_bStop(false), m_bRunning(false), m_bPaused(false),
+	m_nEndSession(0), m_nPending(0), m_nUpdates(0), m_nCoalesced(0), m_nMaxUpdateTime(0)
+{
+	xnOSCreateEvent(&m_hNewFrame, false);
+}
+
+NiteWorker::~NiteWorker()
+{
+	Stop();
+	xnOSCloseEvent(&m_hNewFrame);
+}
+
+void NiteWorker::AddListener(XnVMessageListener* pListener)
+{
+	m_Listeners.push_back(pListener);
+}
+
+void NiteWorker::SetUpdateHandler(FrameAcquirer::FrameHandler pHandler, void* pCookie)
+{
+	m_pUpdateHandler = pHandler;
+	m_pUpdateCookie = pCookie;
+}
+
+XnStatus NiteWorker::Start(XnVSessionManager* pSessionManager, FrameAcquirer& acquirer)
+{
+	m_pSessionManager = pSessionManager;
+	m_pAcquirer = &acquirer;
+	m_pAcquirer->SetFrameHandler(OnNewFrame, this);
+
+	m_bStop = false;
+	XnStatus rc = xnOSCreateThread(WorkerThread, this, &m_hThread);
+	if (rc != XN_STATUS_OK)
+	{
+		m_pAcquirer->SetFrameHandler(NULL, NULL);
+		printf("NITE thread creation failed: %s\n", xnGetStatusString(rc));
+		return rc;
+	}
+
+	m_bRunning = true;
+	return XN_STATUS_OK;
+}
+
+void NiteWorker::Stop()
+{
+	if (!m_bRunning)
+		return;
+
+	m_bStop = true;
+	xnOSSetEvent(m_hNewFrame);
+	xnOSWaitForThreadExit(m_hThread, XN_WAIT_INFINITE);
+	xnOSCloseThread(&m_hThread);
+	m_bRunning = false;
+}
+
+void NiteWorker::SetPaused(XnBool bPaused)
+{
+	m_bPaused = bPaused;
+}
+
+void NiteWorker::RequestEndSession()
+{
+	AtomicExchange(&m_nEndSession, 1);
+	xnOSSetEvent(m_hNewFrame);
+}
+
+XnUInt32 NiteWorker::GetUpdateCount() const
+{
+	return m_nUpdates;
+}
+XnUInt32 NiteWorker::GetCoalescedCount() const
+{
+	return m_nCoalesced;
+}
+XnDouble NiteWorker::GetMaxUpdateMs() const
+{
+	return m_nMaxUpdateTime/1000.0;
+}
+void NiteWorker::ResetStats()
+{
+	m_nUpdates = 0;
+	m_nCoalesced = 0;
+	m_nMaxUpdateTime = 0;
+}
+
+// Called on the acquisition thread
+void NiteWorker::OnNewFrame(void* pCookie)
+{
+	NiteWorker* pWorker = (NiteWorker*)pCookie;
+	if (AtomicExchange(&pWorker->m_nPending, 1) != 0)
+		AtomicIncrement(&pWorker->m_nCoalesced);
+	xnOSSetEvent(pWorker->m_hNewFrame);
+}
+
+XN_THREAD_PROC NiteWorker::WorkerThread(XN_THREAD_PARAM pParam)
+{
+	((NiteWorker*)pParam)->WorkerLoop();
+	XN_THREAD_PROC_RETURN(XN_STATUS_OK);
+}
+
+void NiteWorker::WorkerLoop()
+{
+	// From now on the listeners only run here
+	for (std::list<XnVMessageListener*>::iterator iter = m_Listeners.begin(); iter != m_Listeners.end(); ++iter)
+	{
+		(*iter)->SetCurrentThread();
+	}
+
+	while (!m_bStop)
+	{
+		xnOSWaitEvent(m_hNewFrame, NEW_FRAME_TIMEOUT);
+		if (m_bStop)
+			break;
+
+		if (AtomicExchange(&m_nEndSession, 0) != 0)
+			m_pSessionManager->EndSession();
+
+		if (AtomicExchange(&m_nPending, 0) == 0 || m_bPaused)
+			continue;
+
+		XnUInt64 nStart, nEnd;
+		xnOSGetHighResTimeStamp(&nStart);
+
+		// The acquisition thread keeps off the context while NITE reads it
+		m_pAcquirer->LockContext();
+		m_pSessionManager->Update(m_pAcquirer->GetContext());
+		m_pAcquirer->UnlockContext();
+
+		xnOSGetHighResTimeStamp(&nEnd);
+		if (nEnd - nStart > m_nMaxUpdateTime)
+			m_nMaxUpdateTime = nEnd - nStart;
+		m_nUpdates++;
+
+		if (m_pUpdateHandler != NULL)
+			m_pUpdateHandler(m_pUpdateCookie);
+	}
+}
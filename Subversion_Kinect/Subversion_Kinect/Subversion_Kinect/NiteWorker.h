@@ -0,0 +1,74 @@
+#ifndef NITE_WORKER_H_
+#define NITE_WORKER_H_
+
+#include <list>
+#include <XnVNite.h>
+#include "FrameAcquirer.h"
+
+/**
+ * Runs the session manager, and with it every gesture detector and point control listening to it,
+ * on a thread of its own, once for every frame the acquirer publishes.
+ * Frames that arrive while an update is running are coalesced: the context only holds the newest one anyway.
+ */
+class NiteWorker
+{
+public:
+	NiteWorker();
+	~NiteWorker();
+
+	/**
+	 * Declare a listener of the session manager, before Start. Its NITE activity thread becomes the worker,
+	 * so it is updated in place rather than through NITE's message queue
+	 */
+	void AddListener(XnVMessageListener* pListener);
+	/**
+	 * Set before Start, called on the worker thread after every update, once the listeners have seen the frame
+	 */
+	void SetUpdateHandler(FrameAcquirer::FrameHandler pHandler, void* pCookie);
+
+	XnStatus Start(XnVSessionManager* pSessionManager, FrameAcquirer& acquirer);
+	void Stop();
+
+	/**
+	 * Skip the updates while paused
+	 */
+	void SetPaused(XnBool bPaused);
+	/**
+	 * End the current session on the worker thread, before its next update
+	 */
+	void RequestEndSession();
+
+	/**
+	 * Updates run and frames coalesced since the last reset, and the longest update, in ms
+	 */
+	XnUInt32 GetUpdateCount() const;
+	XnUInt32 GetCoalescedCount() const;
+	XnDouble GetMaxUpdateMs() const;
+	void ResetStats();
+protected:
+	static void OnNewFrame(void* pCookie);
+	static XN_THREAD_PROC WorkerThread(XN_THREAD_PARAM pParam);
+	void WorkerLoop();
+
+	XnVSessionManager* m_pSessionManager;
+	FrameAcquirer* m_pAcquirer;
+	std::list<XnVMessageListener*> m_Listeners;
+	FrameAcquirer::FrameHandler m_pUpdateHandler;
+	void* m_pUpdateCookie;
+
+	XN_THREAD_HANDLE m_hThread;
+	XN_EVENT_HANDLE m_hNewFrame;
+	volatile XnBool m_bStop;
+	XnBool m_bRunning;
+	volatile XnBool m_bPaused;
+	volatile XnUInt32 m_nEndSession;
+
+	// Set by the acquisition thread, cleared by the worker. Setting it while still set coalesces a frame
+	volatile XnUInt32 m_nPending;
+
+	volatile XnUInt32 m_nUpdates;
+	volatile XnUInt32 m_nCoalesced;
+	XnUInt64 m_nMaxUpdateTime;
+};
+
+#endif
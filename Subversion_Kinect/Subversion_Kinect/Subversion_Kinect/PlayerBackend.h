@@ -0,0 +1,86 @@
+#ifndef PLAYER_BACKEND_H_
+#define PLAYER_BACKEND_H_
+
+#include <XnOS.h>
+
+// One zoom gesture, in percent of the video's size
+#define ZOOM_STEP 10.0
+// The zoom a video opens at
+#define ZOOM_DEFAULT 100.0
+// The zooms the gestures can reach, in percent
+#define ZOOM_MIN 25.0
+#define ZOOM_MAX 400.0
+
+typedef enum
+{
+	PLAYBACK_PLAY,
+	PLAYBACK_PAUSE,
+	PLAYBACK_STOP
+} PlaybackState;
+
+// Which of a player state's fields the player itself reported
+#define PLAYER_STATE_PLAYBACK	0x01
+#define PLAYER_STATE_POSITION	0x02
+#define PLAYER_STATE_DURATION	0x04
+#define PLAYER_STATE_ZOOM		0x08
+#define PLAYER_STATE_FULLSCREEN	0x10
+#define PLAYER_STATE_ALL		0x1F
+
+/**
+ * What the player is doing. Times in seconds, the zoom in percent
+ */
+typedef struct
+{
+	PlaybackState ePlayback;
+	XnDouble fPosition;
+	XnDouble fDuration;
+	XnDouble fZoom;
+	XnBool bFullScreen;
+	// PLAYER_STATE_ flags of the fields read from the player. The others are what it was last set to
+	XnUInt32 nReported;
+} PlayerState;
+
+/**
+ * The video player the gestures drive: the operations StereoPlayer's automation offers, whatever carries them.
+ * The player dispatcher makes every call, one at a time, on its own thread, so a backend is free to block, and to
+ * tie its connection to that thread.
+ * Every call returns XN_STATUS_OK, or reports why it failed and returns an error.
+ */
+class PlayerBackend
+{
+public:
+	virtual ~PlayerBackend() {}
+
+	/**
+	 * Reach the player, before any other call
+	 */
+	virtual XnStatus Connect() = 0;
+	/**
+	 * Close the player and let go of it, after the last call
+	 */
+	virtual void Disconnect() = 0;
+
+	virtual XnStatus OpenFile(const XnChar* strFile) = 0;
+	/**
+	 * Open a stereo pair held as two videos. strAudio is NULL when the sound is in the videos
+	 */
+	virtual XnStatus OpenLeftRightFiles(const XnChar* strLeft, const XnChar* strRight, const XnChar* strAudio,
+		XnInt32 nAudioMode) = 0;
+	virtual XnStatus GetDuration(XnDouble& fSeconds) = 0;
+
+	virtual XnStatus SetPlaybackState(PlaybackState eState) = 0;
+	/**
+	 * Zoom straight to fPercent of the video's size
+	 */
+	virtual XnStatus SetZoom(XnDouble fPercent) = 0;
+	virtual XnStatus SetFullScreen(XnBool bFullScreen) = 0;
+	virtual XnStatus SetRepeat(XnBool bRepeat) = 0;
+
+	/**
+	 * Read what the player is doing now, into state: the fields it can tell are overwritten and flagged in
+	 * nReported, the others are left as they are
+	 */
+	virtual XnStatus GetState(PlayerState& state) = 0;
+};
+
+#endif
@@ -0,0 +1,613 @@
+#include "PlayerDispatcher.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+PlayerDispatcher::PlayerDispatcher() :
+	m_pBackend(NULL), m_hThread(NULL), m_nOpenStatus(XN_STATUS_OK), m_bStop(false), m_bRunning(false), m_nUrgent(0),
+	m_nStopOverflow(0), m_nOverflowQueued(0), m_nResetRequested(0),
+	m_nZoomSteps(0), m_bSwitchFullscreen(false), m_bTogglePlay(false), m_nZoomTargetSeen(0),
+	m_pStateHandler(NULL), m_pStateCookie(NULL), m_nPollInterval(0), m_nLastPoll(0)
+{
+	m_strFile[0] = '\0';
+	memset(&m_State, 0, sizeof(m_State));
+	m_State.ePlayback = PLAYBACK_STOP;
+	m_State.fZoom = ZOOM_DEFAULT;
+	m_Mirror.Publish(m_State);
+	xnOSCreateEvent(&m_hWake, false);
+	xnOSCreateEvent(&m_hStarted, false);
+	memset(&m_Stop, 0, sizeof(m_Stop));
+	memset(&m_Zoom, 0, sizeof(m_Zoom));
+	memset(&m_Fullscreen, 0, sizeof(m_Fullscreen));
+	memset(&m_Play, 0, sizeof(m_Play));
+	ClearStats();
+}
+
+PlayerDispatcher::~PlayerDispatcher()
+{
+	Stop();
+	xnOSCloseEvent(&m_hStarted);
+	xnOSCloseEvent(&m_hWake);
+}
+
+XnStatus PlayerDispatcher::Start(PlayerBackend* pBackend, const XnChar* strFile)
+{
+	m_pBackend = pBackend;
+	xnOSStrCopy(m_strFile, strFile, sizeof(m_strFile));
+	m_bStop = false;
+	XnStatus rc = xnOSCreateThread(DispatchThread, this, &m_hThread);
+	if (rc != XN_STATUS_OK)
+	{
+		printf("Player thread creation failed: %s\n", xnGetStatusString(rc));
+		return rc;
+	}
+
+	// The backend connects on the thread it will be used from
+	xnOSWaitEvent(m_hStarted, XN_WAIT_INFINITE);
+	if (m_nOpenStatus != XN_STATUS_OK)
+	{
+		xnOSWaitForThreadExit(m_hThread, XN_WAIT_INFINITE);
+		xnOSCloseThread(&m_hThread);
+		return m_nOpenStatus;
+	}
+
+	m_bRunning = true;
+	return XN_STATUS_OK;
+}
+
+void PlayerDispatcher::Stop()
+{
+	if (!m_bRunning)
+		return;
+
+	m_bStop = true;
+	xnOSSetEvent(m_hWake);
+	xnOSWaitForThreadExit(m_hThread, XN_WAIT_INFINITE);
+	xnOSCloseThread(&m_hThread);
+	m_bRunning = false;
+}
+
+XnBool PlayerDispatcher::Push(PlayerCommand eCommand)
+{
+	Request request;
+	request.eCommand = eCommand;
+	xnOSGetHighResTimeStamp(&request.nQueued);
+	AtomicIncrement(&m_nRequests);
+
+	if (m_Queue.Push(request))
+	{
+		XnUInt32 nDepth = m_Queue.GetDepth();
+		if (nDepth > m_nMaxDepth)
+			AtomicExchange(&m_nMaxDepth, nDepth);
+	}
+	else if (eCommand == PLAYER_STOP)
+	{
+		// A stop is never lost: with the queue full, it goes in after everything queued
+		m_nOverflowQueued = request.nQueued;
+		AtomicExchange(&m_nStopOverflow, 1);
+	}
+	else
+	{
+		AtomicIncrement(&m_nRejected);
+		return false;
+	}
+
+	if (eCommand == PLAYER_STOP)
+		AtomicExchange(&m_nUrgent, 1);
+	xnOSSetEvent(m_hWake);
+	return true;
+}
+
+void PlayerDispatcher::SetZoomTarget(XnDouble fZoom)
+{
+	m_ZoomTarget.Publish(fZoom);
+	AtomicIncrement(&m_nZoomTargets);
+	// Sent on the next tick, not now
+	xnOSSetEvent(m_hWake);
+}
+
+void PlayerDispatcher::SetPollInterval(XnUInt32 nMilliseconds)
+{
+	AtomicExchange(&m_nPollInterval, nMilliseconds);
+	// The dispatch thread may be waiting on the old one
+	xnOSSetEvent(m_hWake);
+}
+
+void PlayerDispatcher::GetPlayerState(PlayerState& state) const
+{
+	m_Mirror.Read(state);
+}
+
+XnUInt32 PlayerDispatcher::GetPlayerStateVersion() const
+{
+	return m_Mirror.GetVersion();
+}
+
+void PlayerDispatcher::SetStateHandler(void (*pHandler)(void* pCookie), void* pCookie)
+{
+	m_pStateHandler = pHandler;
+	m_pStateCookie = pCookie;
+}
+
+XnUInt32 PlayerDispatcher::GetDepth() const
+{
+	return m_Queue.GetDepth();
+}
+XnUInt32 PlayerDispatcher::GetMaxDepth() const
+{
+	return m_nMaxDepth;
+}
+
+XnBool PlayerDispatcher::IsIdle() const
+{
+	return AtomicLoad((volatile XnUInt32*)&m_nCompleted) + AtomicLoad((volatile XnUInt32*)&m_nRejected) ==
+		AtomicLoad((volatile XnUInt32*)&m_nRequests);
+}
+
+void PlayerDispatcher::PrintStats() const
+{
+	printf("Player: %u commands asked for, %u sent, %u failed, %u rejected. Queue depth %u, %u at most. "
+		"%.1f ms average, %.1f ms median, %.1f ms at the 99th percentile, %.1f ms worst from queued to done\n",
+		m_nRequests, m_nSent, m_nFailed, m_nRejected, GetDepth(), m_nMaxDepth,
+		m_nCompleted == 0 ? 0 : m_nLatencySum/1000.0/m_nCompleted, GetLatencyPercentile(0.5),
+		GetLatencyPercentile(0.99), m_nMaxLatency/1000.0);
+	printf("Player state: read back every %u ms, %u times, %u failed, %u times not what it was last set to\n",
+		m_nPollInterval, m_nPolls, m_nPollsFailed, m_nCorrections);
+	if (m_nZoomTargets == 0)
+		return;
+
+	XnUInt64 nNow;
+	xnOSGetHighResTimeStamp(&nNow);
+	XnDouble fSeconds = (nNow - m_nStatsStart)/1000000.0 + 1e-6;
+	printf("Zoom stream: %u targets, %.1f commands/s if sent every frame; %u zooms sent, %.1f commands/s, at most %.0f/s\n",
+		m_nZoomTargets, m_nZoomTargets/fSeconds, m_nZoomsStreamed, m_nZoomsStreamed/fSeconds, m_ZoomStream.GetRate());
+}
+
+void PlayerDispatcher::ResetStats()
+{
+	if (!m_bRunning)
+	{
+		ClearStats();
+		return;
+	}
+
+	// The latencies are the dispatch thread's to write, so it clears them itself
+	AtomicExchange(&m_nResetRequested, 1);
+	xnOSSetEvent(m_hWake);
+}
+
+void PlayerDispatcher::ClearStats()
+{
+	AtomicExchange(&m_nMaxDepth, 0);
+	AtomicExchange(&m_nRequests, 0);
+	AtomicExchange(&m_nSent, 0);
+	AtomicExchange(&m_nFailed, 0);
+	AtomicExchange(&m_nRejected, 0);
+	AtomicExchange(&m_nCompleted, 0);
+	m_nLatencySum = 0;
+	m_nMaxLatency = 0;
+	memset(m_LatencyHistogram, 0, sizeof(m_LatencyHistogram));
+	AtomicExchange(&m_nPolls, 0);
+	AtomicExchange(&m_nPollsFailed, 0);
+	AtomicExchange(&m_nCorrections, 0);
+	AtomicExchange(&m_nZoomTargets, 0);
+	AtomicExchange(&m_nZoomsStreamed, 0);
+	xnOSGetHighResTimeStamp(&m_nStatsStart);
+}
+
+XN_THREAD_PROC PlayerDispatcher::DispatchThread(XN_THREAD_PARAM pParam)
+{
+	((PlayerDispatcher*)pParam)->DispatchLoop();
+	XN_THREAD_PROC_RETURN(XN_STATUS_OK);
+}
+
+void PlayerDispatcher::DispatchLoop()
+{
+	m_nOpenStatus = OpenPlayer();
+	xnOSSetEvent(m_hStarted);
+	if (m_nOpenStatus != XN_STATUS_OK)
+		return;
+
+	while (!m_bStop)
+	{
+		// Woken by a command or a zoom target, or when the zoom or the state is due
+		XnUInt32 nPoll = GetTimeToPoll();
+		XnUInt32 nZoom = GetTimeToZoom();
+		xnOSWaitEvent(m_hWake, nZoom < nPoll ? nZoom : nPoll);
+		if (AtomicExchange(&m_nResetRequested, 0) != 0)
+			ClearStats();
+		while (!m_bStop && Fold())
+		{
+			// Commands are worked out from what the player does, unless a stop has to go first
+			if (m_Stop.nRequests == 0 && GetTimeToPoll() == 0)
+				Poll();
+			SendPending();
+		}
+		if (!m_bStop && AtomicLoad(&m_nUrgent) == 0)
+			StreamZoom();
+		if (!m_bStop && GetTimeToPoll() == 0)
+			Poll();
+	}
+
+	m_pBackend->Disconnect();
+}
+
+XnStatus PlayerDispatcher::OpenPlayer()
+{
+	XnStatus rc = m_pBackend->Connect();
+	if (rc != XN_STATUS_OK)
+		return rc;
+
+	rc = m_pBackend->OpenFile(m_strFile);
+	XnDouble fDuration = 0;
+	if (rc == XN_STATUS_OK)
+		rc = m_pBackend->GetDuration(fDuration);
+	if (rc != XN_STATUS_OK)
+	{
+		m_pBackend->Disconnect();
+		return rc;
+	}
+	printf("Playing %s, %.1f s long\n", m_strFile, fDuration);
+
+	// A video opens playing, at its own size, in a window
+	m_State.ePlayback = PLAYBACK_PLAY;
+	m_State.fPosition = 0;
+	m_State.fDuration = fDuration;
+	m_State.fZoom = ZOOM_DEFAULT;
+	m_State.bFullScreen = false;
+	m_State.nReported = PLAYER_STATE_DURATION;
+	Publish();
+
+	// Eventually only for videos under a minute. Not being able to loop is no reason to give up
+	m_pBackend->SetRepeat(true);
+	return XN_STATUS_OK;
+}
+
+XnUInt32 PlayerDispatcher::GetTimeToPoll() const
+{
+	XnUInt32 nInterval = m_nPollInterval;
+	if (nInterval == 0)
+		return XN_WAIT_INFINITE;
+
+	XnUInt64 nNow;
+	xnOSGetHighResTimeStamp(&nNow);
+	XnUInt64 nDue = m_nLastPoll + (XnUInt64)nInterval*1000;
+	// Rounded up, so the wait does not end just before it is due
+	return nNow >= nDue ? 0 : (XnUInt32)((nDue - nNow + 999)/1000);
+}
+
+XnUInt32 PlayerDispatcher::GetTimeToZoom() const
+{
+	if (!m_ZoomStream.IsActive() && m_ZoomTarget.GetVersion() == m_nZoomTargetSeen)
+		return XN_WAIT_INFINITE;
+
+	XnUInt64 nNow;
+	xnOSGetHighResTimeStamp(&nNow);
+	XnUInt64 nDue = m_ZoomStream.GetNextTick();
+	return nNow >= nDue ? 0 : (XnUInt32)((nDue - nNow + 999)/1000);
+}
+
+void PlayerDispatcher::StreamZoom()
+{
+	// Only the latest target counts, however many came in since the last tick
+	XnUInt32 nVersion = m_ZoomTarget.GetVersion();
+	if (nVersion != m_nZoomTargetSeen)
+	{
+		XnDouble fTarget;
+		m_ZoomTarget.Read(fTarget);
+		m_ZoomStream.SetTarget(fTarget);
+		m_nZoomTargetSeen = nVersion;
+	}
+
+	XnUInt64 nNow;
+	xnOSGetHighResTimeStamp(&nNow);
+	XnDouble fZoom;
+	if (!m_ZoomStream.IsActive() || nNow < m_ZoomStream.GetNextTick() || !m_ZoomStream.Tick(nNow, m_State.fZoom, fZoom))
+		return;
+
+	XnStatus rc = m_pBackend->SetZoom(fZoom);
+	AtomicIncrement(&m_nSent);
+	AtomicIncrement(&m_nZoomsStreamed);
+	if (rc != XN_STATUS_OK)
+	{
+		// Still off by as much, so sent again on the next tick
+		AtomicIncrement(&m_nFailed);
+		return;
+	}
+	m_State.fZoom = fZoom;
+	Publish();
+}
+
+void PlayerDispatcher::Poll()
+{
+	PlayerState state = m_State;
+	state.nReported = 0;
+	XnStatus rc = m_pBackend->GetState(state);
+	xnOSGetHighResTimeStamp(&m_nLastPoll);
+	AtomicIncrement(&m_nPolls);
+	if (rc != XN_STATUS_OK)
+	{
+		// Still what it was last set to
+		AtomicIncrement(&m_nPollsFailed);
+		return;
+	}
+
+	// The position moves by itself, the rest only when someone else drives the player
+	if (((state.nReported & PLAYER_STATE_PLAYBACK) && state.ePlayback != m_State.ePlayback) ||
+		((state.nReported & PLAYER_STATE_ZOOM) && fabs(state.fZoom - m_State.fZoom) > 0.01) ||
+		((state.nReported & PLAYER_STATE_FULLSCREEN) && state.bFullScreen != m_State.bFullScreen))
+	{
+		AtomicIncrement(&m_nCorrections);
+	}
+
+	m_State = state;
+	Publish();
+}
+
+void PlayerDispatcher::Publish()
+{
+	m_Mirror.Publish(m_State);
+	if (m_pStateHandler != NULL)
+		m_pStateHandler(m_pStateCookie);
+}
+
+XnBool PlayerDispatcher::Fold()
+{
+	// In the order they were queued, so a stop only drops the toggles before it
+	Request request;
+	while (m_Queue.Pop(request))
+	{
+		Fold(request);
+	}
+	if (AtomicExchange(&m_nStopOverflow, 0) != 0)
+	{
+		request.eCommand = PLAYER_STOP;
+		request.nQueued = m_nOverflowQueued;
+		Fold(request);
+	}
+
+	return m_Stop.nRequests + m_Zoom.nRequests + m_Fullscreen.nRequests + m_Play.nRequests > 0;
+}
+
+void PlayerDispatcher::Fold(const Request& request)
+{
+	switch (request.eCommand)
+	{
+	case PLAYER_ZOOM_IN:
+		m_nZoomSteps++;
+		Add(m_Zoom, request.nQueued);
+		break;
+	case PLAYER_ZOOM_OUT:
+		m_nZoomSteps--;
+		Add(m_Zoom, request.nQueued);
+		break;
+	case PLAYER_SWITCH_FULLSCREEN:
+		m_bSwitchFullscreen = !m_bSwitchFullscreen;
+		Add(m_Fullscreen, request.nQueued);
+		break;
+	case PLAYER_TOGGLE_PLAY:
+		m_bTogglePlay = !m_bTogglePlay;
+		Add(m_Play, request.nQueued);
+		break;
+	case PLAYER_STOP:
+		// Playing or not before, stopped after: the toggles are done when the stop is
+		m_bTogglePlay = false;
+		Merge(m_Stop, m_Play);
+		Add(m_Stop, request.nQueued);
+		break;
+	}
+}
+
+void PlayerDispatcher::Add(Folded& folded, XnUInt64 nQueued)
+{
+	if (folded.nRequests == 0 || nQueued < folded.nOldest)
+		folded.nOldest = nQueued;
+	if (folded.nRequests < MAX_FOLDED_TIMES)
+		folded.aQueued[folded.nRequests] = nQueued;
+	folded.nRequests++;
+}
+
+void PlayerDispatcher::Merge(Folded& into, Folded& from)
+{
+	XnUInt32 nKept = from.nRequests < MAX_FOLDED_TIMES ? from.nRequests : MAX_FOLDED_TIMES;
+	for (XnUInt32 i = 0; i < nKept; ++i)
+	{
+		Add(into, from.aQueued[i]);
+	}
+	for (XnUInt32 i = nKept; i < from.nRequests; ++i)
+	{
+		Add(into, from.nOldest);
+	}
+	from.nRequests = 0;
+}
+
+void PlayerDispatcher::Complete(Folded& folded)
+{
+	if (folded.nRequests == 0)
+		return;
+
+	XnUInt64 nNow;
+	xnOSGetHighResTimeStamp(&nNow);
+	for (XnUInt32 i = 0; i < folded.nRequests; ++i)
+	{
+		AddLatency(nNow - (i < MAX_FOLDED_TIMES ? folded.aQueued[i] : folded.nOldest));
+	}
+	folded.nRequests = 0;
+}
+
+void PlayerDispatcher::AddLatency(XnUInt64 nLatency)
+{
+	m_nLatencySum += nLatency;
+	if (nLatency > m_nMaxLatency)
+		m_nMaxLatency = nLatency;
+	XnUInt64 nBucket = nLatency/LATENCY_BUCKET_US;
+	m_LatencyHistogram[nBucket < LATENCY_BUCKETS ? nBucket : LATENCY_BUCKETS - 1]++;
+	AtomicIncrement(&m_nCompleted);
+}
+
+XnDouble PlayerDispatcher::GetLatencyPercentile(XnDouble fFraction) const
+{
+	XnUInt32 nCompleted = m_nCompleted;
+	if (nCompleted == 0)
+		return 0;
+
+	// The upper end of the bucket the request at that rank fell in
+	XnUInt32 nRank = (XnUInt32)(fFraction*nCompleted + 0.5);
+	XnUInt32 nSeen = 0;
+	for (XnUInt32 i = 0; i < LATENCY_BUCKETS; ++i)
+	{
+		nSeen += m_LatencyHistogram[i];
+		if (nSeen >= nRank && nSeen > 0)
+			return (i + 1)*LATENCY_BUCKET_US/1000.0;
+	}
+	return m_nMaxLatency/1000.0;
+}
+
+void PlayerDispatcher::SendPending()
+{
+	AtomicExchange(&m_nUrgent, 0);
+
+	if (m_Stop.nRequests > 0)
+	{
+		Send(PLAYER_STOP);
+		Complete(m_Stop);
+	}
+
+	// Between commands, a new stop goes first
+	if (m_Zoom.nRequests > 0 && AtomicLoad(&m_nUrgent) == 0)
+	{
+		if (m_nZoomSteps != 0)
+			Send(PLAYER_ZOOM_IN);
+		m_nZoomSteps = 0;
+		Complete(m_Zoom);
+	}
+
+	if (m_Fullscreen.nRequests > 0 && AtomicLoad(&m_nUrgent) == 0)
+	{
+		if (m_bSwitchFullscreen)
+			Send(PLAYER_SWITCH_FULLSCREEN);
+		m_bSwitchFullscreen = false;
+		Complete(m_Fullscreen);
+	}
+
+	if (m_Play.nRequests > 0 && AtomicLoad(&m_nUrgent) == 0)
+	{
+		if (m_bTogglePlay)
+			Send(PLAYER_TOGGLE_PLAY);
+		m_bTogglePlay = false;
+		Complete(m_Play);
+	}
+}
+
+XnStatus PlayerDispatcher::Send(PlayerCommand eCommand)
+{
+	// Each command sets the player outright, from the mirrored state, and only a command that went through
+	// changes that
+	XnStatus rc = XN_STATUS_OK;
+	switch (eCommand)
+	{
+	case PLAYER_ZOOM_IN:
+	case PLAYER_ZOOM_OUT:
+		{
+			// Every pending step at once, as far as the zoom goes
+			XnDouble fZoom = m_State.fZoom + m_nZoomSteps*ZOOM_STEP;
+			if (fZoom < ZOOM_MIN)
+				fZoom = ZOOM_MIN;
+			if (fZoom > ZOOM_MAX)
+				fZoom = ZOOM_MAX;
+			if (fabs(fZoom - m_State.fZoom) < 0.01)
+				return XN_STATUS_OK;
+			rc = m_pBackend->SetZoom(fZoom);
+			if (rc == XN_STATUS_OK)
+				m_State.fZoom = fZoom;
+		}
+		break;
+	case PLAYER_SWITCH_FULLSCREEN:
+		rc = m_pBackend->SetFullScreen(!m_State.bFullScreen);
+		if (rc == XN_STATUS_OK)
+			m_State.bFullScreen = !m_State.bFullScreen;
+		break;
+	case PLAYER_TOGGLE_PLAY:
+		{
+			PlaybackState eState = m_State.ePlayback == PLAYBACK_PLAY ? PLAYBACK_PAUSE : PLAYBACK_PLAY;
+			rc = m_pBackend->SetPlaybackState(eState);
+			if (rc == XN_STATUS_OK)
+				m_State.ePlayback = eState;
+		}
+		break;
+	case PLAYER_STOP:
+		rc = m_pBackend->SetPlaybackState(PLAYBACK_STOP);
+		if (rc == XN_STATUS_OK)
+		{
+			m_State.ePlayback = PLAYBACK_STOP;
+			m_State.fPosition = 0;
+		}
+		break;
+	}
+
+	AtomicIncrement(&m_nSent);
+	if (rc != XN_STATUS_OK)
+		AtomicIncrement(&m_nFailed);
+	else
+		Publish();
+	return rc;
+}
+
+int PlayerDispatcher::Benchmark(PlayerBackend* pBackend, const XnChar* strFile, XnUInt32 nGestures, XnUInt32 nRate,
+	XnUInt32 nPollMs)
+{
+	// What a session looks like: mostly zooming up and down, now and then a pause, fullscreen or stop
+	static const PlayerCommand gestures[] =
+	{
+		PLAYER_ZOOM_IN, PLAYER_ZOOM_IN, PLAYER_ZOOM_OUT, PLAYER_TOGGLE_PLAY, PLAYER_ZOOM_IN,
+		PLAYER_ZOOM_OUT, PLAYER_SWITCH_FULLSCREEN, PLAYER_ZOOM_OUT, PLAYER_TOGGLE_PLAY, PLAYER_ZOOM_IN,
+		PLAYER_ZOOM_OUT, PLAYER_SWITCH_FULLSCREEN, PLAYER_ZOOM_IN, PLAYER_ZOOM_OUT, PLAYER_STOP,
+		PLAYER_TOGGLE_PLAY
+	};
+	const XnUInt32 nGestureCount = sizeof(gestures)/sizeof(gestures[0]);
+
+	if (nRate == 0)
+		nRate = 1;
+	printf("Player benchmark: %u gestures at %u a second, the state read back every %u ms\n", nGestures, nRate, nPollMs);
+
+	PlayerDispatcher* pDispatcher = new PlayerDispatcher;
+	pDispatcher->SetPollInterval(nPollMs);
+	if (pDispatcher->Start(pBackend, strFile) != XN_STATUS_OK)
+	{
+		printf("The player could not be opened\n");
+		delete pDispatcher;
+		return 1;
+	}
+
+	// Stand in for the NITE thread: a gesture when it is due, never waiting for the player
+	XnUInt64 nStart, nNow;
+	xnOSGetHighResTimeStamp(&nStart);
+	for (XnUInt32 i = 0; i < nGestures; ++i)
+	{
+		XnUInt64 nDue = nStart + (XnUInt64)i*1000000/nRate;
+		xnOSGetHighResTimeStamp(&nNow);
+		if (nDue > nNow)
+			xnOSSleep((XnUInt32)((nDue - nNow)/1000));
+		pDispatcher->Push(gestures[i % nGestureCount]);
+	}
+	XnUInt64 nPushed;
+	xnOSGetHighResTimeStamp(&nPushed);
+
+	// Then let the player catch up, for as long as the gestures took and ten seconds more
+	XnUInt64 nDeadline = nPushed + (nPushed - nStart) + 10000000;
+	for (xnOSGetHighResTimeStamp(&nNow); !pDispatcher->IsIdle() && nNow < nDeadline; xnOSGetHighResTimeStamp(&nNow))
+	{
+		xnOSSleep(1);
+	}
+	XnBool bDone = pDispatcher->IsIdle();
+	XnDouble fSeconds = (nNow - nStart)/1000000.0;
+
+	printf("  %.1f gestures/s asked for, %.1f gestures/s done, %.1f commands/s sent, over %.2f s%s\n  ",
+		nGestures/((nPushed - nStart)/1000000.0 + 1e-6), pDispatcher->m_nCompleted/fSeconds,
+		pDispatcher->m_nSent/fSeconds, fSeconds, bDone ? "" : ", the player never caught up");
+	pDispatcher->PrintStats();
+
+	pDispatcher->Stop();
+	delete pDispatcher;
+	return bDone ? 0 : 1;
+}
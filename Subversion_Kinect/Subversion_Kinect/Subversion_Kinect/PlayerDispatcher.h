@@ -0,0 +1,217 @@
+#ifndef PLAYER_DISPATCHER_H_
+#define PLAYER_DISPATCHER_H_
+
+#include <XnOS.h>
+#include "SpscQueue.h"
+#include "Snapshot.h"
+#include "PlayerBackend.h"
+#include "ZoomStream.h"
+
+#define MAX_PENDING_PLAYER_COMMANDS 32
+// Requests folded into one command whose queued times are kept one by one. Past that, they count as old as the oldest
+#define MAX_FOLDED_TIMES 64
+// Latency from queued to done is counted in buckets of 0.1 ms, up to 1 s
+#define LATENCY_BUCKET_US 100
+#define LATENCY_BUCKETS 10000
+
+/**
+ * What the gestures ask of the player
+ */
+typedef enum
+{
+	PLAYER_ZOOM_IN,
+	PLAYER_ZOOM_OUT,
+	PLAYER_SWITCH_FULLSCREEN,
+	PLAYER_TOGGLE_PLAY,
+	PLAYER_STOP
+} PlayerCommand;
+
+/**
+ * Sends the gestures' commands to the player on a thread of its own, so a slow player never holds up the sensor
+ * or the display. The commands come in through a lock free queue, and are folded before being sent:
+ * pending zoom steps become one zoom, kept within ZOOM_MIN and ZOOM_MAX, toggles that undo each other are
+ * dropped, and a stop drops the play toggles before it. A stop also jumps the queue: it is sent before anything
+ * else pending, as soon as the command being sent returns.
+ * Every command it sends is absolute, worked out from what the player is doing: the dispatcher mirrors the
+ * player's state, from what it last set it to and from reading it back, when it has nothing to send and at least
+ * once per poll interval. The mirror is published for any thread to read without a round trip to the player.
+ * A zoom driven continuously, by the hand, does not go through the queue: only its latest target is kept, and a
+ * ZoomStream sends it on a tick of its own, at most ZOOM_STREAM_RATE times a second and only past its deadband.
+ */
+class PlayerDispatcher
+{
+public:
+	PlayerDispatcher();
+	~PlayerDispatcher();
+
+	/**
+	 * Connect to the player and open strFile on the dispatch thread, and wait for it. Fails, with no thread left,
+	 * when either cannot be done
+	 */
+	XnStatus Start(PlayerBackend* pBackend, const XnChar* strFile);
+	/**
+	 * Drop whatever is still pending, and disconnect from the player
+	 */
+	void Stop();
+
+	/**
+	 * Queue a command, from one thread only (NITE's). Never blocks. False when the queue is full, except for a stop,
+	 * which is always taken
+	 */
+	XnBool Push(PlayerCommand eCommand);
+	/**
+	 * Where the continuous zoom should be now, in percent, from one thread only (NITE's). Never blocks.
+	 * Replaces the target before it if that was not looked at yet
+	 */
+	void SetZoomTarget(XnDouble fZoom);
+
+	/**
+	 * How often to read the player's state back, in ms. 0 never reads it, the mirror is then only what the player
+	 * was set to. Takes effect by the next poll
+	 */
+	void SetPollInterval(XnUInt32 nMilliseconds);
+	/**
+	 * The player's state as last mirrored, from any thread. Never waits for the player
+	 */
+	void GetPlayerState(PlayerState& state) const;
+	/**
+	 * Changes whenever the mirrored state may have
+	 */
+	XnUInt32 GetPlayerStateVersion() const;
+	/**
+	 * Called on the dispatch thread whenever the mirrored state changed
+	 */
+	void SetStateHandler(void (*pHandler)(void* pCookie), void* pCookie);
+
+	/**
+	 * Commands waiting now, and the most that waited since the last reset
+	 */
+	XnUInt32 GetDepth() const;
+	XnUInt32 GetMaxDepth() const;
+	/**
+	 * Whether every command asked for since the last reset is done, sent, folded away or rejected
+	 */
+	XnBool IsIdle() const;
+	/**
+	 * Print the commands asked for, those sent, and how long they took from queued to done, since the last reset.
+	 * With the zoom streamed, also the targets it was given, each of which a command when sent every frame, against
+	 * the zooms it sent
+	 */
+	void PrintStats() const;
+	/**
+	 * Start the stats over. From any thread: the dispatch thread clears them before its next command
+	 */
+	void ResetStats();
+
+	/**
+	 * Offline: push nGestures gestures, nRate a second, through a dispatcher to pBackend, the way the NITE thread
+	 * would, with the player's state read back every nPollMs, then report how many went through and how long they
+	 * took. Returns the process' exit code
+	 */
+	static int Benchmark(PlayerBackend* pBackend, const XnChar* strFile, XnUInt32 nGestures, XnUInt32 nRate,
+		XnUInt32 nPollMs);
+protected:
+	typedef struct
+	{
+		PlayerCommand eCommand;
+		XnUInt64 nQueued;
+	} Request;
+
+	// Requests folded into one command, not sent yet
+	typedef struct
+	{
+		XnUInt32 nRequests;
+		XnUInt64 nOldest;
+		XnUInt64 aQueued[MAX_FOLDED_TIMES];
+	} Folded;
+
+	static XN_THREAD_PROC DispatchThread(XN_THREAD_PARAM pParam);
+	void DispatchLoop();
+	// Connect, open the video, and start from what the player does with it
+	XnStatus OpenPlayer();
+	// How long until the next poll is due, in ms
+	XnUInt32 GetTimeToPoll() const;
+	// How long until the next zoom tick is due, in ms
+	XnUInt32 GetTimeToZoom() const;
+	// Take the latest zoom target, and send it if the tick is due and it is past the deadband
+	void StreamZoom();
+	// Read the player's state back into the mirror
+	void Poll();
+	// The mirror changed
+	void Publish();
+	// Fold every queued request into the pending commands. Returns whether any command is pending
+	XnBool Fold();
+	void Fold(const Request& request);
+	void Add(Folded& folded, XnUInt64 nQueued);
+	// Move the requests of one command into another, when the other makes it moot
+	void Merge(Folded& into, Folded& from);
+	// The requests of a command are done
+	void Complete(Folded& folded);
+	void AddLatency(XnUInt64 nLatency);
+	// Zero the stats, on the dispatch thread, or before it runs
+	void ClearStats();
+	// Latency under which fFraction of the requests were done, in ms
+	XnDouble GetLatencyPercentile(XnDouble fFraction) const;
+	// Send the pending commands, the stop first. Leaves the rest pending when a new stop comes in
+	void SendPending();
+	XnStatus Send(PlayerCommand eCommand);
+
+	PlayerBackend* m_pBackend;
+	XnChar m_strFile[XN_FILE_MAX_PATH];
+	SpscQueue<Request, MAX_PENDING_PLAYER_COMMANDS> m_Queue;
+
+	XN_THREAD_HANDLE m_hThread;
+	XN_EVENT_HANDLE m_hWake;
+	XN_EVENT_HANDLE m_hStarted;
+	XnStatus m_nOpenStatus;
+	volatile XnBool m_bStop;
+	XnBool m_bRunning;
+	// Set when a stop is queued, so the dispatch thread looks at the queue before its next command
+	volatile XnUInt32 m_nUrgent;
+	// A stop that found the queue full
+	volatile XnUInt32 m_nStopOverflow;
+	XnUInt64 m_nOverflowQueued;
+	// Set when the stats are to be cleared, by the dispatch thread
+	volatile XnUInt32 m_nResetRequested;
+
+	// Pending, on the dispatch thread: a stop, net zoom steps, and whether fullscreen and play are to be switched
+	Folded m_Stop;
+	Folded m_Zoom;
+	XnInt32 m_nZoomSteps;
+	Folded m_Fullscreen;
+	XnBool m_bSwitchFullscreen;
+	Folded m_Play;
+	XnBool m_bTogglePlay;
+
+	// The continuous zoom: its latest target, as published, and streamed on the dispatch thread
+	Snapshot<XnDouble> m_ZoomTarget;
+	XnUInt32 m_nZoomTargetSeen;
+	ZoomStream m_ZoomStream;
+
+	// The player's state, on the dispatch thread, and as published
+	PlayerState m_State;
+	Snapshot<PlayerState> m_Mirror;
+	void (*m_pStateHandler)(void* pCookie);
+	void* m_pStateCookie;
+	volatile XnUInt32 m_nPollInterval;
+	XnUInt64 m_nLastPoll;
+
+	volatile XnUInt32 m_nMaxDepth;
+	volatile XnUInt32 m_nRequests;
+	volatile XnUInt32 m_nSent;
+	volatile XnUInt32 m_nFailed;
+	volatile XnUInt32 m_nRejected;
+	volatile XnUInt32 m_nCompleted;
+	XnUInt64 m_nLatencySum;
+	XnUInt64 m_nMaxLatency;
+	XnUInt32 m_LatencyHistogram[LATENCY_BUCKETS];
+	volatile XnUInt32 m_nPolls;
+	volatile XnUInt32 m_nPollsFailed;
+	// Polls that found the player not doing what it was last set to
+	volatile XnUInt32 m_nCorrections;
+	volatile XnUInt32 m_nZoomTargets;
+	volatile XnUInt32 m_nZoomsStreamed;
+	XnUInt64 m_nStatsStart;
+};
+
+#endif
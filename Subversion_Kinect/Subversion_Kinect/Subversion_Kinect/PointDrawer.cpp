@@ -1,404 +1,238 @@
-/*******************************************************************************
-*                                                                              *
-*   PrimeSense NITE 1.3 - Point Viewer Sample                                  *
-*   Copyright (C) 2010 PrimeSense Ltd.                                         *
-*                                                                              *
-*******************************************************************************/
-
-#include "PointDrawer.h"
-#include "XnVDepthMessage.h"
-#include <XnVHandPointContext.h>
-
-#ifdef USE_GLUT
-	#if (XN_PLATFORM == XN_PLATFORM_MACOSX)
-		#include <GLUT/glut.h>
-	#else
-		#include <glut.h>
-	#endif
-#elif defined(USE_GLES)
-	#include "opengles.h"
-#endif
-
-// Constructor. Receives the number of previous positions to store per hand,
-// and a source for depth map
-XnVPointDrawer::XnVPointDrawer(XnUInt32 nHistory, xn::DepthGenerator depthGenerator) :
-	XnVPointControl("XnVPointDrawer"),
-	m_nHistorySize(nHistory), m_DepthGenerator(depthGenerator), m_bDrawDM(false), m_bFrameID(false)
-{
-	m_pfPositionBuffer = new XnFloat[nHistory*3];
-}
-
-// Destructor. Clear all data structures
-XnVPointDrawer::~XnVPointDrawer()
-{
-	std::map<XnUInt32, std::list<XnPoint3D> >::iterator iter;
-	for (iter = m_History.begin(); iter != m_History.end(); ++iter)
-	{
-		iter->second.clear();
-	}
-	m_History.clear();
-
-	delete []m_pfPositionBuffer;
-}
-
-// Change whether or not to draw the depth map
-void XnVPointDrawer::SetDepthMap(XnBool bDrawDM)
-{
-	m_bDrawDM = bDrawDM;
-}
-// Change whether or not to print the frame ID
-void XnVPointDrawer::SetFrameID(XnBool bFrameID)
-{
-	m_bFrameID = bFrameID;
-}
-
-// Handle creation of a new hand
-static XnBool bShouldPrint = false;
-void XnVPointDrawer::OnPointCreate(const XnVHandPointContext* cxt)
-{
-	printf("** %d\n", cxt->nID);
-	// Create entry for the hand
-	m_History[cxt->nID].clear();
-	bShouldPrint = true;
-	OnPointUpdate(cxt);
-	bShouldPrint = true;
-}
-// Handle new position of an existing hand
-void XnVPointDrawer::OnPointUpdate(const XnVHandPointContext* cxt)
-{
-	// positions are kept in projective coordinates, since they are only used for drawing
-	XnPoint3D ptProjective(cxt->ptPosition);
-
-	if (bShouldPrint)printf("Point (%f,%f,%f)", ptProjective.X, ptProjective.Y, ptProjective.Z);
-	m_DepthGenerator.ConvertRealWorldToProjective(1, &ptProjective, &ptProjective);
-	if (bShouldPrint)printf(" -> (%f,%f,%f)\n", ptProjective.X, ptProjective.Y, ptProjective.Z);
-
-	// Add new position to the history buffer
-	m_History[cxt->nID].push_front(ptProjective);
-	// Keep size of history buffer
-	if (m_History[cxt->nID].size() > m_nHistorySize)
-		m_History[cxt->nID].pop_back();
-	bShouldPrint = false;
-}
-
-// Handle destruction of an existing hand
-void XnVPointDrawer::OnPointDestroy(XnUInt32 nID)
-{
-	// No need for the history buffer
-	m_History.erase(nID);
-}
-
-#define MAX_DEPTH 10000
-float g_pDepthHist[MAX_DEPTH];
-unsigned int getClosestPowerOfTwo(unsigned int n)
-{
-	unsigned int m = 2;
-	while(m < n) m<<=1;
-
-	return m;
-}
-GLuint initTexture(void** buf, int& width, int& height)
-{
-	GLuint texID = 0;
-	glGenTextures(1,&texID);
-
-	width = getClosestPowerOfTwo(width);
-	height = getClosestPowerOfTwo(height); 
-	*buf = new unsigned char[width*height*4];
-	glBindTexture(GL_TEXTURE_2D,texID);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-	return texID;
-}
-
-GLfloat texcoords[8];
-void DrawRectangle(float topLeftX, float topLeftY, float bottomRightX, float bottomRightY)
-{
-	GLfloat verts[8] = {	topLeftX, topLeftY,
-		topLeftX, bottomRightY,
-		bottomRightX, bottomRightY,
-		bottomRightX, topLeftY
-	};
-	glVertexPointer(2, GL_FLOAT, 0, verts);
-	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-
-	glFlush();
-}
-void DrawTexture(float topLeftX, float topLeftY, float bottomRightX, float bottomRightY)
-{
-	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-	glTexCoordPointer(2, GL_FLOAT, 0, texcoords);
-
-	DrawRectangle(topLeftX, topLeftY, bottomRightX, bottomRightY);
-
-	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-}
-
-void DrawDepthMap(const xn::DepthMetaData& dm)
-{
-	static bool bInitialized = false;	
-	static GLuint depthTexID;
-	static unsigned char* pDepthTexBuf;
-	static int texWidth, texHeight;
-
-	 float topLeftX;
-	 float topLeftY;
-	 float bottomRightY;
-	 float bottomRightX;
-	float texXpos;
-	float texYpos;
-
-	if(!bInitialized)
-	{
-		XnUInt16 nXRes = dm.XRes();
-		XnUInt16 nYRes = dm.YRes();
-		texWidth =  getClosestPowerOfTwo(nXRes);
-		texHeight = getClosestPowerOfTwo(nYRes);
-
-		depthTexID = initTexture((void**)&pDepthTexBuf,texWidth, texHeight) ;
-
-		bInitialized = true;
-
-		topLeftX = nXRes;
-		topLeftY = 0;
-		bottomRightY = nYRes;
-		bottomRightX = 0;
-		texXpos =(float)nXRes/texWidth;
-		texYpos  =(float)nYRes/texHeight;
-
-		memset(texcoords, 0, 8*sizeof(float));
-		texcoords[0] = texXpos, texcoords[1] = texYpos, texcoords[2] = texXpos, texcoords[7] = texYpos;
-
-	}
-	unsigned int nValue = 0;
-	unsigned int nHistValue = 0;
-	unsigned int nIndex = 0;
-	unsigned int nX = 0;
-	unsigned int nY = 0;
-	unsigned int nNumberOfPoints = 0;
-	XnUInt16 g_nXRes = dm.XRes();
-	XnUInt16 g_nYRes = dm.YRes();
-
-	unsigned char* pDestImage = pDepthTexBuf;
-
-	const XnUInt16* pDepth = dm.Data();
-
-	// Calculate the accumulative histogram
-	memset(g_pDepthHist, 0, MAX_DEPTH*sizeof(float));
-	for (nY=0; nY<g_nYRes; nY++)
-	{
-		for (nX=0; nX<g_nXRes; nX++)
-		{
-			nValue = *pDepth;
-
-			if (nValue != 0)
-			{
-				g_pDepthHist[nValue]++;
-				nNumberOfPoints++;
-			}
-
-			pDepth++;
-		}
-	}
-
-	for (nIndex=1; nIndex<MAX_DEPTH; nIndex++)
-	{
-		g_pDepthHist[nIndex] += g_pDepthHist[nIndex-1];
-	}
-	if (nNumberOfPoints)
-	{
-		for (nIndex=1; nIndex<MAX_DEPTH; nIndex++)
-		{
-			g_pDepthHist[nIndex] = (unsigned int)(256 * (1.0f - (g_pDepthHist[nIndex] / nNumberOfPoints)));
-		}
-	}
-
-	pDepth = dm.Data();
-	{
-		XnUInt32 nIndex = 0;
-		// Prepare the texture map
-		for (nY=0; nY<g_nYRes; nY++)
-		{
-			for (nX=0; nX < g_nXRes; nX++, nIndex++)
-			{
-				nValue = *pDepth;
-
-				if (nValue != 0)
-				{
-					nHistValue = g_pDepthHist[nValue];
-
-					pDestImage[0] = nHistValue; 
-					pDestImage[1] = nHistValue;
-					pDestImage[2] = nHistValue;
-				}
-				else
-				{
-					pDestImage[0] = 0;
-					pDestImage[1] = 0;
-					pDestImage[2] = 0;
-				}
-
-				pDepth++;
-				pDestImage+=3;
-			}
-
-			pDestImage += (texWidth - g_nXRes) *3;
-		}
-	}
-	glBindTexture(GL_TEXTURE_2D, depthTexID);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, texWidth, texHeight, 0, GL_RGB, GL_UNSIGNED_BYTE, pDepthTexBuf);
-
-	// Display the OpenGL texture map
-	glColor4f(0.5,0.5,0.5,1);
-
-	glEnable(GL_TEXTURE_2D);
-	DrawTexture(dm.XRes(),dm.YRes(),0,0);	
-	glDisable(GL_TEXTURE_2D);
-}
-#ifdef USE_GLUT
-void glPrintString(void *font, char *str)
-{
-	size_t i,l = strlen(str);
-
-	for(i=0; i<l; i++)
-	{
-		glutBitmapCharacter(font,*str++);
-	}
-}
-void DrawFrameID(XnUInt32 nFrameID)
-{
-	glColor4f(1,0,0,1);
-	glRasterPos2i(20, 50);
-	XnChar strLabel[20];
-	sprintf(strLabel, "%d", nFrameID);
-	glPrintString(GLUT_BITMAP_HELVETICA_18, strLabel);
-}
-#endif
-
-// Colors for the points
-XnFloat Colors[][3] =
-{
-	{0.5,0.5,0.5},	// Grey
-	{0,1,0},	// Green
-	{0,0.5,1},	// Light blue
-	{1,1,0},	// Yellow
-	{1,0.5,0},	// Orange
-	{1,0,1},	// Purple
-	{1,1,1}		// White. reserved for the primary point
-};
-XnUInt32 nColors = 6;
-
-XnBool XnVPointDrawer::IsTouching(XnUInt32 id) const
-{
-	for (std::list<XnUInt32>::const_iterator iter = m_TouchingFOVEdge.begin(); iter != m_TouchingFOVEdge.end(); ++iter)
-	{
-		if (*iter == id)
-			return TRUE;
-	}
-	return FALSE;
-}
-
-void XnVPointDrawer::Draw() const
-{
-	std::map<XnUInt32, std::list<XnPoint3D> >::const_iterator PointIterator;
-
-	// Go over each existing hand
-	for (PointIterator = m_History.begin();
-		PointIterator != m_History.end();
-		++PointIterator)
-	{
-		// Clear buffer
-		XnUInt32 nPoints = 0;
-		XnUInt32 i = 0;
-		XnUInt32 Id = PointIterator->first;
-
-		// Go over all previous positions of current hand
-		std::list<XnPoint3D>::const_iterator PositionIterator;
-		for (PositionIterator = PointIterator->second.begin();
-			PositionIterator != PointIterator->second.end();
-			++PositionIterator, ++i)
-		{
-			// Add position to buffer
-			XnPoint3D pt(*PositionIterator);
-			m_pfPositionBuffer[3*i] = pt.X;
-			m_pfPositionBuffer[3*i + 1] = pt.Y;
-			m_pfPositionBuffer[3*i + 2] = 0;//pt.Z();
-		}
-		
-		// Set color
-		XnUInt32 nColor = Id % nColors;
-		XnUInt32 nSingle = GetPrimaryID();
-		if (Id == GetPrimaryID())
-			nColor = 6;
-		// Draw buffer:
-		glColor4f(Colors[nColor][0],
-				Colors[nColor][1],
-				Colors[nColor][2],
-				1.0f);
-		glPointSize(2);
-		glVertexPointer(3, GL_FLOAT, 0, m_pfPositionBuffer);
-		glDrawArrays(GL_LINE_STRIP, 0, i);
-
-		
-		if (IsTouching(Id))
-		{
-			glColor4f(1.0f, 0.0f, 0.0f, 1.0f);
-		}
-		glPointSize(8);
-		glDrawArrays(GL_POINTS, 0, 1);
-		glFlush();
-	}
-}
-void XnVPointDrawer::SetTouchingFOVEdge(XnUInt32 nID)
-{
-	m_TouchingFOVEdge.push_front(nID);
-}
-
-// Handle a new Message
-void XnVPointDrawer::Update(XnVMessage* pMessage)
-{
-	// PointControl's Update calls all callbacks for each hand
-	XnVPointControl::Update(pMessage);
-
-	if (m_bDrawDM)
-	{
-		// Draw depth map
-		xn::DepthMetaData depthMD;
-		m_DepthGenerator.GetMetaData(depthMD);
-		DrawDepthMap(depthMD);
-	}
-#ifdef USE_GLUT
-	if (m_bFrameID)
-	{
-		// Print out frame ID
-		xn::DepthMetaData depthMD;
-		m_DepthGenerator.GetMetaData(depthMD);
-		DrawFrameID(depthMD.FrameID());
-	}
-#endif
-	// Draw hands
-	Draw();
-	m_TouchingFOVEdge.clear();
-}
-#ifdef USE_GLUT
-void PrintSessionState(SessionState eState)
-{
-	glColor4f(1,0,1,1);
-	glRasterPos2i(20, 20);
-	XnChar strLabel[200];
-
-	switch (eState)
-	{
-	case IN_SESSION:
-		sprintf(strLabel, "Tracking hands"); break;
-	case NOT_IN_SESSION:
-		sprintf(strLabel, "Perform click or wave gestures to track hand"); break;
-	case QUICK_REFOCUS:
-		sprintf(strLabel, "Raise your hand for it to be identified, or perform click or wave gestures"); break;
-	}
-
-	glPrintString(GLUT_BITMAP_HELVETICA_18, strLabel);
-}
-#endif
+/*******************************************************************************
+*                                                                              *
+*   PrimeSense NITE 1.3 - Point Viewer Sample                                  *
+*   Copyright (C) 2010 PrimeSense Ltd.                                         *
+*                                                                              *
+*******************************************************************************/
+
+#include "PointDrawer.h"
+#include "TextOverlay.h"
+#include "XnVDepthMessage.h"
+
+#ifdef USE_GLUT
+	#if (XN_PLATFORM == XN_PLATFORM_MACOSX)
+		#include <GLUT/glut.h>
+	#else
+		#include <glut.h>
+	#endif
+#elif defined(USE_GLES)
+	#include "opengles.h"
+#endif
+
+// Constructor. Receives the number of previous positions to store per hand,
+// and a source for depth map
+XnVPointDrawerBase::XnVPointDrawerBase(XnUInt32 nHistory, xn::DepthGenerator depthGenerator) :
+	XnVPointControl("XnVPointDrawer"),
+	m_nHistorySize(nHistory), m_nPrimaryFOVEdge(XN_DIRECTION_ILLEGAL),
+	m_DepthGenerator(depthGenerator), m_nPendingPositions(0), m_bShouldPrint(false),
+	m_nDepthXRes(0), m_nDepthYRes(0), m_bDrawDM(false), m_bFrameID(false)
+{
+	// The field of view for the native projection, read now and again when the output mode changes
+	m_Projection.Init(depthGenerator);
+}
+
+// Destructor. Clear all data structures
+XnVPointDrawerBase::~XnVPointDrawerBase()
+{
+}
+
+// Change whether or not to draw the depth map
+void XnVPointDrawerBase::SetDepthMap(XnBool bDrawDM)
+{
+	m_bDrawDM = bDrawDM;
+}
+// Change how often the depth histogram is rebuilt
+void XnVPointDrawerBase::SetDepthHistogramPolicy(DepthColorizer::HistogramPolicy ePolicy)
+{
+	m_DepthColorizer.SetHistogramPolicy(ePolicy);
+}
+// Change whether the whole depth map is uploaded, or only its rows that changed
+void XnVPointDrawerBase::SetDepthUpload(TextureStream::UploadMode eMode)
+{
+	m_DepthTexture.SetUploadMode(eMode);
+}
+// Change the colors of the depth map
+void XnVPointDrawerBase::SetColormap(DepthColorizer::Colormap eColormap)
+{
+	m_DepthColorizer.SetColormap(eColormap);
+}
+// Change whether or not to print the frame ID
+void XnVPointDrawerBase::SetFrameID(XnBool bFrameID)
+{
+	m_bFrameID = bFrameID;
+}
+// Access the depth colorizer, to tune or benchmark it
+DepthColorizer& XnVPointDrawerBase::GetDepthColorizer()
+{
+	return m_DepthColorizer;
+}
+// Stats gathered while colorizing, so nobody needs another pass over the frame
+const DepthFrameStats& XnVPointDrawerBase::GetDepthStats() const
+{
+	return m_DepthColorizer.GetFrameStats();
+}
+// Access the depth map's texture, to choose how it is sized
+TextureStream& XnVPointDrawerBase::GetDepthTexture()
+{
+	return m_DepthTexture;
+}
+
+// Access the projection, to choose how it is done or benchmark it
+ProjectiveConverter& XnVPointDrawerBase::GetProjection()
+{
+	return m_Projection;
+}
+
+void XnVPointDrawerBase::QueuePosition(const XnVHandPointContext* cxt)
+{
+	// positions are kept in projective coordinates, since they are only used for drawing.
+	// They are converted all together once the update is over
+	m_PendingPositions[m_nPendingPositions] = cxt->ptPosition;
+	m_PendingIDs[m_nPendingPositions] = cxt->nID;
+	// When the sensor saw it, for the display to place the hand between samples
+	m_PendingTimes[m_nPendingPositions] = cxt->fTime;
+	m_PendingPrint[m_nPendingPositions] = m_bShouldPrint;
+	m_nPendingPositions++;
+	m_bShouldPrint = false;
+}
+
+// Convert the queued positions in one call, in place
+void XnVPointDrawerBase::ConvertPositions()
+{
+	XnPoint3D realWorld[MAX_HANDS];
+	memcpy(realWorld, m_PendingPositions, m_nPendingPositions*sizeof(XnPoint3D));
+	m_Projection.Convert(m_nPendingPositions, m_PendingPositions);
+
+	for (XnUInt32 i = 0; i < m_nPendingPositions; ++i)
+	{
+		const XnPoint3D& ptProjective = m_PendingPositions[i];
+		if (m_PendingPrint[i])
+			printf("Point (%f,%f,%f) -> (%f,%f,%f)\n", realWorld[i].X, realWorld[i].Y, realWorld[i].Z, ptProjective.X, ptProjective.Y, ptProjective.Z);
+	}
+}
+
+GLfloat texcoords[8];
+void DrawRectangle(RenderState& state, float topLeftX, float topLeftY, float bottomRightX, float bottomRightY)
+{
+	GLfloat verts[8] = {	topLeftX, topLeftY,
+		topLeftX, bottomRightY,
+		bottomRightX, bottomRightY,
+		bottomRightX, topLeftY
+	};
+	glVertexPointer(2, GL_FLOAT, 0, verts);
+	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+	state.Count(2);
+}
+void DrawTexture(RenderState& state, float topLeftX, float topLeftY, float bottomRightX, float bottomRightY)
+{
+	state.EnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glTexCoordPointer(2, GL_FLOAT, 0, texcoords);
+	state.Count();
+
+	DrawRectangle(state, topLeftX, topLeftY, bottomRightX, bottomRightY);
+}
+
+void UploadDepthMap(const DepthFrame& frame, DepthColorizer& colorizer, TextureStream& texture)
+{
+	// Grey colormaps only need their intensity, a third of the bytes to write and upload of RGB
+	XnUInt32 nBytesPerPixel = colorizer.IsGreyColormap() ? 1 : 3;
+	GLenum format = colorizer.IsGreyColormap() ? GL_LUMINANCE : GL_RGB;
+
+	// Look the depth up in the current colormap, straight into the texture's upload buffer
+	XnUChar* pBuffer = texture.BeginFrame(frame.nXRes, frame.nYRes, format);
+	colorizer.Colorize(frame.pDepth, frame.nXRes, frame.nYRes, pBuffer, nBytesPerPixel, frame.nXRes*nBytesPerPixel, texture.GetDirtyRows());
+	texture.EndFrame();
+}
+
+// Draw the depth map queued by DrawFrame
+void XnVPointDrawerBase::Render(RenderState& state, XnUInt32 nParam)
+{
+	// Display the OpenGL texture map
+	state.Color(0.5,0.5,0.5,1);
+
+	XnFloat fMaxS, fMaxT;
+	m_DepthTexture.Enable(state, fMaxS, fMaxT);
+	state.Disable(GL_BLEND);
+	state.EnableClientState(GL_VERTEX_ARRAY);
+	state.DisableClientState(GL_COLOR_ARRAY);
+	memset(texcoords, 0, 8*sizeof(float));
+	texcoords[0] = fMaxS, texcoords[1] = fMaxT, texcoords[2] = fMaxS, texcoords[7] = fMaxT;
+	DrawTexture(state, m_nDepthXRes, m_nDepthYRes, 0, 0);
+}
+// All the text on screen, laid out once per different string, from one atlas
+static TextOverlay g_Text;
+void DrawFrameID(RenderQueue& queue, XnUInt32 nFrameID)
+{
+	XnChar strLabel[20];
+	sprintf(strLabel, "%d", nFrameID);
+	g_Text.Draw(queue, 20, 50, strLabel, 1, 0, 0);
+}
+
+XnDirection XnVPointDrawerBase::GetPrimaryFOVEdge() const
+{
+	return (XnDirection)m_nPrimaryFOVEdge;
+}
+
+// Draw the latest frame's depth map. Called on every display, whether a new frame arrived or not
+void XnVPointDrawerBase::DrawDepthMap(RenderQueue& queue, const DepthFrame* pFrame, XnBool bNewFrame)
+{
+	if (m_bDrawDM && pFrame != NULL)
+	{
+		// Colorize a new depth map now, draw it with everything else
+		if (bNewFrame)
+		{
+			UploadDepthMap(*pFrame, m_DepthColorizer, m_DepthTexture);
+			// The upload bound the texture around the state cache
+			queue.GetState().InvalidateTextures();
+		}
+		m_nDepthXRes = pFrame->nXRes;
+		m_nDepthYRes = pFrame->nYRes;
+		queue.Record(RenderQueue::LAYER_DEPTH_MAP, 0, this, 0);
+	}
+	if (m_bFrameID && pFrame != NULL)
+	{
+		// Print out frame ID
+		DrawFrameID(queue, pFrame->nFrameID);
+	}
+}
+void PrintSessionState(RenderQueue& queue, SessionState eState)
+{
+	XnChar strLabel[200];
+
+	switch (eState)
+	{
+	case IN_SESSION:
+		sprintf(strLabel, "Tracking hands"); break;
+	case NOT_IN_SESSION:
+		sprintf(strLabel, "Perform click or wave gestures to track hand"); break;
+	case QUICK_REFOCUS:
+		sprintf(strLabel, "Raise your hand for it to be identified, or perform click or wave gestures"); break;
+	}
+
+	g_Text.Draw(queue, 20, 20, strLabel, 1, 0, 1);
+}
+// Whole seconds as shown: anything the player reports out of range shows as 0
+static XnUInt32 ShownSeconds(XnDouble fSeconds)
+{
+	return fSeconds >= 0 && fSeconds < 360000 ? (XnUInt32)fSeconds : 0;
+}
+XnBool FormatPlayerState(const PlayerState& state, XnChar* strLabel, XnUInt32 nSize)
+{
+	static const XnChar* states[] = {"playing", "paused", "stopped"};
+	XnUInt32 nPosition = ShownSeconds(state.fPosition);
+	XnUInt32 nDuration = ShownSeconds(state.fDuration);
+	XnChar strNew[PLAYER_LABEL_SIZE];
+	XnUInt32 nWritten;
+	// Cut short rather than overflow, whatever the player reported
+	xnOSStrFormat(strNew, sizeof(strNew), &nWritten, "Player %s %u:%02u / %u:%02u, %.0f%%%s",
+		(XnUInt32)state.ePlayback <= PLAYBACK_STOP ? states[state.ePlayback] : "unknown", nPosition/60, nPosition%60,
+		nDuration/60, nDuration%60, state.fZoom, state.bFullScreen ? ", full screen" : "");
+	if (strncmp(strNew, strLabel, nSize) == 0)
+		return false;
+	xnOSStrCopy(strLabel, strNew, nSize);
+	return true;
+}
+void PrintPlayerState(RenderQueue& queue, const XnChar* strLabel)
+{
+	g_Text.Draw(queue, 20, 110, strLabel, 0, 1, 1);
+}
@@ -1,83 +1,289 @@
-/*******************************************************************************
-*                                                                              *
-*   PrimeSense NITE 1.3 - Point Viewer Sample                                  *
-*   Copyright (C) 2010 PrimeSense Ltd.                                         *
-*                                                                              *
-*******************************************************************************/
-
-#ifndef XNV_POINT_DRAWER_H_
-#define XNV_POINT_DRAWER_H_
-
-#include <map>
-#include <list>
-#include <XnCppWrapper.h>
-#include <XnVPointControl.h>
-
-typedef enum
-{
-	IN_SESSION,
-	NOT_IN_SESSION,
-	QUICK_REFOCUS
-} SessionState;
-
-void PrintSessionState(SessionState eState);
-/**
- * This is a point control, which stores the history of every point
- * It can draw all the points as well as the depth map.
- */
-class XnVPointDrawer : public XnVPointControl
-{
-public:
-	XnVPointDrawer(XnUInt32 nHistorySize, xn::DepthGenerator depthGenerator);
-	virtual ~XnVPointDrawer();
-
-	/**
-	 * Handle a new message.
-	 * Calls other callbacks for each point, then draw the depth map (if needed) and the points
-	 */
-	void Update(XnVMessage* pMessage);
-
-	/**
-	 * Handle creation of a new point
-	 */
-	void OnPointCreate(const XnVHandPointContext* cxt);
-	/**
-	 * Handle new position of an existing point
-	 */
-	void OnPointUpdate(const XnVHandPointContext* cxt);
-	/**
-	 * Handle destruction of an existing point
-	 */
-	void OnPointDestroy(XnUInt32 nID);
-
-	/**
-	 * Draw the points, each with its own color.
-	 */
-	void Draw() const;
-
-	/**
-	 * Change mode - should draw the depth map?
-	 */
-	void SetDepthMap(XnBool bDrawDM);
-	/**
-	 * Change mode - print out the frame id
-	 */
-	void SetFrameID(XnBool bFrameID);
-
-	void SetTouchingFOVEdge(XnUInt32 nID);
-protected:
-	XnBool IsTouching(XnUInt32 nID) const;
-	// Number of previous position to store for each hand
-	XnUInt32 m_nHistorySize;
-	// previous positions per hand
-	std::map<XnUInt32, std::list<XnPoint3D> > m_History;
-	std::list<XnUInt32> m_TouchingFOVEdge;
-	// Source of the depth map
-	xn::DepthGenerator m_DepthGenerator;
-	XnFloat* m_pfPositionBuffer;
-
-	XnBool m_bDrawDM;
-	XnBool m_bFrameID;
-};
-
-#endif
+/*******************************************************************************
+*                                                                              *
+*   PrimeSense NITE 1.3 - Point Viewer Sample                                  *
+*   Copyright (C) 2010 PrimeSense Ltd.                                         *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef XNV_POINT_DRAWER_H_
+#define XNV_POINT_DRAWER_H_
+
+#include <stdio.h>
+#include <XnCppWrapper.h>
+#include <XnVPointControl.h>
+#include <XnVHandPointContext.h>
+#include "DepthColorizer.h"
+#include "TextureStream.h"
+#include "FrameAcquirer.h"
+#include "FOVEdgeTracker.h"
+#include "HandStore.h"
+#include "ProjectiveConverter.h"
+#include "RenderQueue.h"
+#include "PlayerBackend.h"
+#include "Atomics.h"
+
+typedef enum
+{
+	IN_SESSION,
+	NOT_IN_SESSION,
+	QUICK_REFOCUS
+} SessionState;
+
+void PrintSessionState(RenderQueue& queue, SessionState eState);
+// Longest line the player's state is shown as
+#define PLAYER_LABEL_SIZE 100
+/**
+ * What the player is doing, as one line: played to the second, zoom to the percent. Returns whether it differs from
+ * what strLabel held
+ */
+XnBool FormatPlayerState(const PlayerState& state, XnChar* strLabel, XnUInt32 nSize);
+/**
+ * Draw a line FormatPlayerState wrote
+ */
+void PrintPlayerState(RenderQueue& queue, const XnChar* strLabel);
+/**
+ * What a point drawer does apart from keeping the hands: the depth map and how it is drawn, the projection of the
+ * positions NITE reports, and the edges of the field of view the hands touch.
+ * It holds no hands: those, and everything done with them, are in XnVPointDrawerT
+ */
+class XnVPointDrawerBase : public XnVPointControl, public Renderable
+{
+public:
+	XnVPointDrawerBase(XnUInt32 nHistorySize, xn::DepthGenerator depthGenerator);
+	virtual ~XnVPointDrawerBase();
+
+	/**
+	 * Draw the depth map, when the queue gets to it
+	 */
+	virtual void Render(RenderState& state, XnUInt32 nParam);
+
+	/**
+	 * Change mode - should draw the depth map?
+	 */
+	void SetDepthMap(XnBool bDrawDM);
+	/**
+	 * Change mode - how the depth map's equalization table follows the frames
+	 */
+	void SetDepthHistogramPolicy(DepthColorizer::HistogramPolicy ePolicy);
+	/**
+	 * Change mode - upload the whole depth map every frame, or only the rows that changed
+	 */
+	void SetDepthUpload(TextureStream::UploadMode eMode);
+	/**
+	 * Change mode - colors of the depth map
+	 */
+	void SetColormap(DepthColorizer::Colormap eColormap);
+	/**
+	 * Change mode - print out the frame id
+	 */
+	void SetFrameID(XnBool bFrameID);
+	/**
+	 * The colorizer used when drawing the depth map
+	 */
+	DepthColorizer& GetDepthColorizer();
+	/**
+	 * Nearest/farthest depth and valid pixel count of the last depth map drawn
+	 */
+	const DepthFrameStats& GetDepthStats() const;
+	/**
+	 * The texture the depth map is streamed to
+	 */
+	TextureStream& GetDepthTexture();
+	/**
+	 * How the hands' positions are converted to projective coordinates
+	 */
+	ProjectiveConverter& GetProjection();
+	/**
+	 * The edge the primary hand touched in the last update, XN_DIRECTION_ILLEGAL if none.
+	 * Readable from any thread
+	 */
+	XnDirection GetPrimaryFOVEdge() const;
+protected:
+	/**
+	 * Colorize and queue the depth map (if needed) and the frame ID: DrawFrame without the hands
+	 */
+	void DrawDepthMap(RenderQueue& queue, const DepthFrame* pFrame, XnBool bNewFrame);
+	/**
+	 * Queue the position of a hand, to be converted with the others of the update
+	 */
+	void QueuePosition(const XnVHandPointContext* cxt);
+	/**
+	 * Convert the queued positions in place, in one call
+	 */
+	void ConvertPositions();
+
+	// Number of previous position to store for each hand
+	XnUInt32 m_nHistorySize;
+	// Hands at the edge of the field of view in the last update, and those reported since
+	FOVEdgeTracker m_FOVEdges;
+	volatile XnUInt32 m_nPrimaryFOVEdge;
+	// Source of the depth map
+	xn::DepthGenerator m_DepthGenerator;
+	ProjectiveConverter m_Projection;
+
+	// Real world positions reported during the current update, waiting to be converted together
+	XnPoint3D m_PendingPositions[MAX_HANDS];
+	XnUInt32 m_PendingIDs[MAX_HANDS];
+	XnFloat m_PendingTimes[MAX_HANDS];
+	XnBool m_PendingPrint[MAX_HANDS];
+	XnUInt32 m_nPendingPositions;
+	// Print the next position queued, the first of a new hand
+	XnBool m_bShouldPrint;
+
+	// Converts depth frames to the grey texture
+	DepthColorizer m_DepthColorizer;
+	TextureStream m_DepthTexture;
+	// Size of the depth map queued
+	XnUInt32 m_nDepthXRes;
+	XnUInt32 m_nDepthYRes;
+
+	XnBool m_bDrawDM;
+	XnBool m_bFrameID;
+};
+
+/**
+ * This is a point control, which stores the history of every point
+ * It can draw all the points as well as the depth map, queued in a RenderQueue with the rest of the frame.
+ * NITE updates it on its own thread. Every update ends with a snapshot of the hands,
+ * which is all the drawing side ever reads.
+ * The hands are kept in a HandStoreT over Table, HandHistory for a history fixed at compile time or HandTable for
+ * one sized at runtime. The drawer holds it, so every call on the hands' path is a direct one
+ */
+template <class Table>
+class XnVPointDrawerT : public XnVPointDrawerBase
+{
+public:
+	XnVPointDrawerT(XnUInt32 nHistorySize, xn::DepthGenerator depthGenerator) :
+		XnVPointDrawerBase(nHistorySize, depthGenerator), m_Hands(nHistorySize)
+	{
+	}
+
+	/**
+	 * Handle a new message.
+	 * Calls other callbacks for each point, then converts the positions they reported in one batch.
+	 * Drawing is left to DrawFrame
+	 */
+	void Update(XnVMessage* pMessage)
+	{
+		// PointControl's Update calls all callbacks for each hand
+		XnVPointControl::Update(pMessage);
+		// One projection for all the hands that moved
+		FlushPositions();
+
+		// The edge reports of this update are drawn until the next one
+		m_FOVEdges.EndUpdate();
+		AtomicExchange(&m_nPrimaryFOVEdge, m_FOVEdges.Get(m_Hands.Find(GetPrimaryID()), GetPrimaryID()));
+
+		// Copy the hands for the display
+		m_Hands.Publish(GetPrimaryID(), m_FOVEdges);
+	}
+
+	/**
+	 * Handle creation of a new point
+	 */
+	void OnPointCreate(const XnVHandPointContext* cxt)
+	{
+		printf("** %d\n", cxt->nID);
+		// Positions queued for an earlier hand with the same ID must not land in the new one
+		FlushPositions();
+		// Create entry for the hand
+		if (m_Hands.Add(cxt->nID) == INVALID_HAND_SLOT)
+			printf("No room for hand %d\n", cxt->nID);
+		m_bShouldPrint = true;
+		OnPointUpdate(cxt);
+		m_bShouldPrint = true;
+	}
+	/**
+	 * Handle new position of an existing point
+	 */
+	void OnPointUpdate(const XnVHandPointContext* cxt)
+	{
+		if (m_nPendingPositions == MAX_HANDS)
+			FlushPositions();
+		QueuePosition(cxt);
+	}
+	/**
+	 * Handle destruction of an existing point
+	 */
+	void OnPointDestroy(XnUInt32 nID)
+	{
+		// Its queued positions go in first, so they are dropped with it
+		FlushPositions();
+		// No need for the history buffer
+		m_Hands.Remove(nID);
+	}
+
+	/**
+	 * Hand nID touches the eDirection edge of the field of view. Called from the touching callback,
+	 * under the context lock, which keeps the hands' slots from changing
+	 */
+	void SetTouchingFOVEdge(XnUInt32 nID, XnDirection eDirection)
+	{
+		m_FOVEdges.Report(m_Hands.Find(nID), nID, eDirection);
+	}
+
+	/**
+	 * Take the newest snapshot of the hands, then queue the depth map (if needed) and the points.
+	 * The depth map is only colorized again when bNewFrame is set, otherwise its texture is drawn as it is
+	 */
+	void DrawFrame(RenderQueue& queue, const DepthFrame* pFrame, XnBool bNewFrame)
+	{
+		DrawDepthMap(queue, pFrame, bNewFrame);
+
+		// Draw hands, taking the newest snapshot on the way
+		m_Hands.Draw(queue);
+	}
+
+	/**
+	 * How the hands are placed between the sensor's samples, at display rate. Display thread only
+	 */
+	HandCursor& GetHandCursor()
+	{
+		return m_Hands.GetCursor();
+	}
+protected:
+	/**
+	 * Convert the positions queued since the last flush and add them to the hands, in the order they came
+	 */
+	void FlushPositions()
+	{
+		ConvertPositions();
+		for (XnUInt32 i = 0; i < m_nPendingPositions; ++i)
+		{
+			// Add new position to the history ring, which drops the oldest one when full
+			m_Hands.Push(m_PendingIDs[i], m_PendingPositions[i], m_PendingTimes[i]);
+		}
+		m_nPendingPositions = 0;
+	}
+
+	// previous positions per hand, in projective coordinates, and their snapshots for the display
+	HandStoreT<Table> m_Hands;
+};
+
+/**
+ * A point drawer with the history length N and the layout of the positions fixed at compile time,
+ * its hands part of the object
+ */
+template <XnUInt32 N, HandLayout Layout>
+class XnVFixedPointDrawer : public XnVPointDrawerT<HandHistory<N, Layout> >
+{
+public:
+	XnVFixedPointDrawer(xn::DepthGenerator depthGenerator) :
+		XnVPointDrawerT<HandHistory<N, Layout> >(N, depthGenerator)
+	{
+	}
+};
+
+/**
+ * A point drawer with the history length chosen at runtime
+ */
+class XnVPointDrawer : public XnVPointDrawerT<HandTable>
+{
+public:
+	XnVPointDrawer(XnUInt32 nHistorySize, xn::DepthGenerator depthGenerator) :
+		XnVPointDrawerT<HandTable>(nHistorySize, depthGenerator)
+	{
+	}
+};
+
+#endif
@@ -0,0 +1,234 @@
+#include "ProjectiveConverter.h"
+#include "CpuFeatures.h"
+#include "Atomics.h"
+#include <XnOS.h>
+#include <math.h>
+#include <stdio.h>
+
+#ifdef XN_CPU_X86
+	#include <emmintrin.h>
+#endif
+
+ProjectiveConverter::ProjectiveConverter() :
+	m_eMode(CONVERT_LIBRARY), m_bNativeReady(false), m_hModeChange(NULL), m_nModeChanged(0),
+	m_fCoeffX(0), m_fCoeffY(0), m_fHalfX(0), m_fHalfY(0)
+{
+}
+
+ProjectiveConverter::~ProjectiveConverter()
+{
+	if (m_hModeChange != NULL)
+		m_DepthGenerator.UnregisterFromMapOutputModeChange(m_hModeChange);
+}
+
+XnStatus ProjectiveConverter::Init(xn::DepthGenerator depthGenerator)
+{
+	if (m_hModeChange != NULL)
+		m_DepthGenerator.UnregisterFromMapOutputModeChange(m_hModeChange);
+	m_hModeChange = NULL;
+	m_DepthGenerator = depthGenerator;
+	m_DepthGenerator.RegisterToMapOutputModeChange(OnOutputModeChanged, this, m_hModeChange);
+	return ReadModel();
+}
+
+void XN_CALLBACK_TYPE ProjectiveConverter::OnOutputModeChanged(xn::ProductionNode& node, void* pCookie)
+{
+	// On whichever thread changed the mode: the converting thread reads the model again itself
+	AtomicExchange(&((ProjectiveConverter*)pCookie)->m_nModeChanged, 1);
+}
+
+XnStatus ProjectiveConverter::ReadModel()
+{
+	XnFieldOfView fov;
+	XnMapOutputMode mode;
+	XnStatus rc = m_DepthGenerator.GetFieldOfView(fov);
+	if (rc == XN_STATUS_OK)
+		rc = m_DepthGenerator.GetMapOutputMode(mode);
+	if (rc != XN_STATUS_OK)
+	{
+		m_bNativeReady = false;
+		return rc;
+	}
+
+	// Same constants as the library: the image plane at z=1 is 2*tan(fov/2) wide, and its center is the
+	// middle pixel, rounded down
+	m_fCoeffX = (XnFloat)(mode.nXRes/(2*tan(fov.fHFOV/2)));
+	m_fCoeffY = (XnFloat)(mode.nYRes/(2*tan(fov.fVFOV/2)));
+	m_fHalfX = (XnFloat)(mode.nXRes/2);
+	m_fHalfY = (XnFloat)(mode.nYRes/2);
+	m_bNativeReady = true;
+	return XN_STATUS_OK;
+}
+
+void ProjectiveConverter::SetMode(Mode eMode)
+{
+	m_eMode = (eMode == CONVERT_NATIVE && !m_bNativeReady) ? CONVERT_LIBRARY : eMode;
+}
+ProjectiveConverter::Mode ProjectiveConverter::GetMode() const
+{
+	return m_eMode;
+}
+const XnChar* ProjectiveConverter::GetModeName(Mode eMode)
+{
+	return eMode == CONVERT_NATIVE ? "native" : "library";
+}
+
+void ProjectiveConverter::Convert(XnUInt32 nCount, XnPoint3D* pPoints)
+{
+	if (nCount == 0)
+		return;
+
+	if (AtomicExchange(&m_nModeChanged, 0) != 0)
+		ReadModel();
+	if (m_eMode == CONVERT_NATIVE && m_bNativeReady)
+		ConvertNative(nCount, pPoints);
+	else
+		m_DepthGenerator.ConvertRealWorldToProjective(nCount, pPoints, pPoints);
+}
+
+#ifdef XN_CPU_X86
+// Four points at a time: gathered into x, y and z vectors, projected, and scattered back. Z is unchanged
+XN_TARGET("sse2") static XnUInt32 ProjectSSE(XnUInt32 nCount, XnPoint3D* pPoints, XnFloat fCoeffX, XnFloat fCoeffY, XnFloat fHalfX, XnFloat fHalfY)
+{
+	const __m128 coeffX = _mm_set1_ps(fCoeffX);
+	const __m128 coeffY = _mm_set1_ps(fCoeffY);
+	const __m128 halfX = _mm_set1_ps(fHalfX);
+	const __m128 halfY = _mm_set1_ps(fHalfY);
+
+	XnUInt32 i = 0;
+	for (; i + 4 <= nCount; i += 4)
+	{
+		XnPoint3D* p = pPoints + i;
+		__m128 x = _mm_setr_ps(p[0].X, p[1].X, p[2].X, p[3].X);
+		__m128 y = _mm_setr_ps(p[0].Y, p[1].Y, p[2].Y, p[3].Y);
+		__m128 z = _mm_setr_ps(p[0].Z, p[1].Z, p[2].Z, p[3].Z);
+
+		// A full division: the reciprocal estimate alone is off by up to half a pixel at the edges
+		x = _mm_add_ps(_mm_div_ps(_mm_mul_ps(coeffX, x), z), halfX);
+		y = _mm_sub_ps(halfY, _mm_div_ps(_mm_mul_ps(coeffY, y), z));
+
+		XnFloat fX[4], fY[4];
+		_mm_storeu_ps(fX, x);
+		_mm_storeu_ps(fY, y);
+		for (XnUInt32 j = 0; j < 4; ++j)
+		{
+			p[j].X = fX[j];
+			p[j].Y = fY[j];
+		}
+	}
+	return i;
+}
+#endif
+
+void ProjectiveConverter::ConvertNative(XnUInt32 nCount, XnPoint3D* pPoints) const
+{
+	XnUInt32 i = 0;
+#ifdef XN_CPU_X86
+	i = ProjectSSE(nCount, pPoints, m_fCoeffX, m_fCoeffY, m_fHalfX, m_fHalfY);
+#endif
+	for (; i < nCount; ++i)
+	{
+		pPoints[i].X = m_fCoeffX*pPoints[i].X/pPoints[i].Z + m_fHalfX;
+		pPoints[i].Y = m_fHalfY - m_fCoeffY*pPoints[i].Y/pPoints[i].Z;
+	}
+}
+
+XnBool ProjectiveConverter::CheckNative(XnFloat& fMaxError) const
+{
+	fMaxError = 0;
+	if (!m_bNativeReady)
+		return false;
+
+	// A grid over the whole view, from near to far: the library's projection of it is the reference
+	const XnUInt32 nGrid = 16;
+	XnPoint3D* pReference = new XnPoint3D[nGrid*nGrid*nGrid];
+	XnPoint3D* pNative = new XnPoint3D[nGrid*nGrid*nGrid];
+	XnUInt32 nPoints = 0;
+	for (XnUInt32 k = 0; k < nGrid; ++k)
+	{
+		XnFloat fZ = 500.0f + 3500.0f*k/(nGrid - 1);
+		for (XnUInt32 j = 0; j < nGrid; ++j)
+		{
+			for (XnUInt32 i = 0; i < nGrid; ++i, ++nPoints)
+			{
+				// Inverse of the projection, so the grid lands on [0, resolution]
+				XnFloat fU = 2*m_fHalfX*i/(nGrid - 1);
+				XnFloat fV = 2*m_fHalfY*j/(nGrid - 1);
+				pReference[nPoints].X = (fU - m_fHalfX)*fZ/m_fCoeffX;
+				pReference[nPoints].Y = (m_fHalfY - fV)*fZ/m_fCoeffY;
+				pReference[nPoints].Z = fZ;
+				pNative[nPoints] = pReference[nPoints];
+			}
+		}
+	}
+	m_DepthGenerator.ConvertRealWorldToProjective(nPoints, pReference, pReference);
+	ConvertNative(nPoints, pNative);
+
+	for (XnUInt32 i = 0; i < nPoints; ++i)
+	{
+		XnFloat fErrorX = (XnFloat)fabs(pNative[i].X - pReference[i].X);
+		XnFloat fErrorY = (XnFloat)fabs(pNative[i].Y - pReference[i].Y);
+		if (fErrorX > fMaxError)
+			fMaxError = fErrorX;
+		if (fErrorY > fMaxError)
+			fMaxError = fErrorY;
+	}
+
+	delete []pReference;
+	delete []pNative;
+	return fMaxError <= PROJECTION_TOLERANCE_PX;
+}
+
+XnBool ProjectiveConverter::Benchmark(XnUInt32 nIterations) const
+{
+	XnFloat fMaxError;
+	if (!m_bNativeReady)
+	{
+		printf("Projection benchmark: no field of view, only the library is available\n");
+		return false;
+	}
+	XnBool bMatch = CheckNative(fMaxError);
+
+	printf("Projection benchmark, %u iterations\n", nIterations);
+	printf("  native vs library: %.4f px worst %s\n", fMaxError, bMatch ? "" : "(OVER THE TOLERANCE)");
+
+	printf("  %-16s %10s %10s %10s\n", "", "1 point", "4 points", "16 points");
+	XnPoint3D pNative[16];
+	XnUInt32 counts[] = {1, 4, 16};
+	for (XnUInt32 nWay = 0; nWay < 3; ++nWay)
+	{
+		XnDouble fTime[3];
+		for (XnUInt32 c = 0; c < 3; ++c)
+		{
+			XnUInt64 nStart, nEnd;
+			xnOSGetHighResTimeStamp(&nStart);
+			for (XnUInt32 n = 0; n < nIterations; ++n)
+			{
+				// Converting in place: restore the inputs, so every iteration sees real world points
+				for (XnUInt32 i = 0; i < counts[c]; ++i)
+				{
+					pNative[i].X = (XnFloat)(i*10.0f - 80.0f);
+					pNative[i].Y = (XnFloat)(40.0f - i*5.0f);
+					pNative[i].Z = 1500.0f + i;
+				}
+				if (nWay == 0)
+				{
+					for (XnUInt32 i = 0; i < counts[c]; ++i)
+					{
+						m_DepthGenerator.ConvertRealWorldToProjective(1, pNative + i, pNative + i);
+					}
+				}
+				else if (nWay == 1)
+					m_DepthGenerator.ConvertRealWorldToProjective(counts[c], pNative, pNative);
+				else
+					ConvertNative(counts[c], pNative);
+			}
+			xnOSGetHighResTimeStamp(&nEnd);
+			fTime[c] = (nEnd - nStart)*1000.0/nIterations;
+		}
+		const XnChar* names[] = {"library, 1/call", "library, batch", "native, batch"};
+		printf("  %-16s %7.0f ns %7.0f ns %7.0f ns\n", names[nWay], fTime[0], fTime[1], fTime[2]);
+	}
+
+	return bMatch;
+}
@@ -0,0 +1,74 @@
+#ifndef PROJECTIVE_CONVERTER_H_
+#define PROJECTIVE_CONVERTER_H_
+
+#include <XnCppWrapper.h>
+
+// The most the native projection may differ from the library's, in pixels, to be used
+#define PROJECTION_TOLERANCE_PX 0.5f
+
+/**
+ * Converts batches of real world points to projective coordinates, the ones the depth map is drawn in.
+ * Either through the depth generator, one library call per batch, or natively: the generator's pinhole
+ * model, from its field of view and resolution, evaluated four points at a time with SSE. The model is read
+ * again, before the next conversion, whenever the generator's output mode changes.
+ */
+class ProjectiveConverter
+{
+public:
+	typedef enum
+	{
+		// DepthGenerator::ConvertRealWorldToProjective on the whole batch
+		CONVERT_LIBRARY,
+		// The cached pinhole model. Matches the library within a fraction of a pixel
+		CONVERT_NATIVE
+	} Mode;
+
+	ProjectiveConverter();
+	~ProjectiveConverter();
+
+	/**
+	 * Read the field of view and resolution of the generator, and follow their changes. Until then, and while
+	 * they cannot be read, conversions go through the library whatever the mode
+	 */
+	XnStatus Init(xn::DepthGenerator depthGenerator);
+
+	void SetMode(Mode eMode);
+	Mode GetMode() const;
+	static const XnChar* GetModeName(Mode eMode);
+
+	/**
+	 * Convert nCount points in place, from the thread that converts only
+	 */
+	void Convert(XnUInt32 nCount, XnPoint3D* pPoints);
+
+	/**
+	 * Convert points spread over the field of view both ways, fMaxError being the largest difference in pixels.
+	 * Returns whether the native projection can be used: read, and within PROJECTION_TOLERANCE_PX of the library
+	 */
+	XnBool CheckNative(XnFloat& fMaxError) const;
+	/**
+	 * CheckNative, then print the cost of converting 1, 4 and 16 points per call with each mode, and one library
+	 * call per point. Returns what CheckNative did
+	 */
+	XnBool Benchmark(XnUInt32 nIterations) const;
+protected:
+	static void XN_CALLBACK_TYPE OnOutputModeChanged(xn::ProductionNode& node, void* pCookie);
+	// Work out the pinhole model from the generator's field of view and resolution
+	XnStatus ReadModel();
+	void ConvertNative(XnUInt32 nCount, XnPoint3D* pPoints) const;
+
+	xn::DepthGenerator m_DepthGenerator;
+	Mode m_eMode;
+	XnBool m_bNativeReady;
+	XnCallbackHandle m_hModeChange;
+	// Set when the output mode changed, so the model is read again before the next conversion
+	volatile XnUInt32 m_nModeChanged;
+
+	// X = fCoeffX*x/z + fHalfX, Y = fHalfY - fCoeffY*y/z, the way OpenNI projects
+	XnFloat m_fCoeffX;
+	XnFloat m_fCoeffY;
+	XnFloat m_fHalfX;
+	XnFloat m_fHalfY;
+};
+
+#endif
@@ -0,0 +1,74 @@
+#include "RenderQueue.h"
+#include <stdio.h>
+
+RenderQueue::RenderQueue() :
+	m_nCommands(0), m_bFullReported(false),
+	m_nLastIssued(0), m_nLastSkipped(0), m_nLastCommands(0), m_nFrameCommands(0)
+{
+}
+
+void RenderQueue::BeginFrame()
+{
+	m_nLastIssued = m_State.GetIssued();
+	m_nLastSkipped = m_State.GetSkipped();
+	m_nLastCommands = m_nFrameCommands;
+	m_State.ResetCounts();
+	m_nFrameCommands = 0;
+}
+
+XnBool RenderQueue::Record(Layer eLayer, XnUInt32 nState, Renderable* pRenderable, XnUInt32 nParam)
+{
+	if (m_nCommands == MAX_RENDER_COMMANDS)
+	{
+		if (!m_bFullReported)
+			printf("Render queue full, draws are dropped\n");
+		m_bFullReported = true;
+		return false;
+	}
+
+	Command& command = m_Commands[m_nCommands++];
+	command.nKey = ((XnUInt32)eLayer << 24) | (nState & 0xFFFFFF);
+	command.pRenderable = pRenderable;
+	command.nParam = nParam;
+	return true;
+}
+
+void RenderQueue::Flush()
+{
+	// Insertion sort: stable, and a frame's few commands are mostly in order already
+	for (XnUInt32 i = 1; i < m_nCommands; ++i)
+	{
+		Command command = m_Commands[i];
+		XnUInt32 j = i;
+		for (; j > 0 && m_Commands[j - 1].nKey > command.nKey; --j)
+		{
+			m_Commands[j] = m_Commands[j - 1];
+		}
+		m_Commands[j] = command;
+	}
+
+	for (XnUInt32 i = 0; i < m_nCommands; ++i)
+	{
+		m_Commands[i].pRenderable->Render(m_State, m_Commands[i].nParam);
+	}
+	m_nFrameCommands += m_nCommands;
+	m_nCommands = 0;
+}
+
+RenderState& RenderQueue::GetState()
+{
+	return m_State;
+}
+
+XnUInt32 RenderQueue::GetIssued() const
+{
+	return m_nLastIssued;
+}
+XnUInt32 RenderQueue::GetSkipped() const
+{
+	return m_nLastSkipped;
+}
+XnUInt32 RenderQueue::GetCommands() const
+{
+	return m_nLastCommands;
+}
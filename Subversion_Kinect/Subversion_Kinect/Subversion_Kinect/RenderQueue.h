@@ -0,0 +1,84 @@
+#ifndef RENDER_QUEUE_H_
+#define RENDER_QUEUE_H_
+
+#include "RenderState.h"
+
+#define MAX_RENDER_COMMANDS 64
+
+/**
+ * Something drawn through a RenderQueue. Render sets every state it relies on through the RenderState,
+ * including the ones it needs off, since it cannot know what was drawn before it
+ */
+class Renderable
+{
+public:
+	virtual ~Renderable() {}
+	/**
+	 * Draw what was recorded with nParam
+	 */
+	virtual void Render(RenderState& state, XnUInt32 nParam) = 0;
+};
+
+/**
+ * The draws of one frame. Components record them while the frame is put together, and they are all
+ * rendered at its end, in layers from back to front, and within a layer sorted by the state they bind,
+ * so draws sharing a texture follow each other. Draws with the same layer and state keep their order.
+ * Rendering goes through one RenderState, kept from frame to frame.
+ */
+class RenderQueue
+{
+public:
+	typedef enum
+	{
+		LAYER_DEPTH_MAP,
+		LAYER_HANDS,
+		LAYER_TEXT
+	} Layer;
+
+	RenderQueue();
+
+	/**
+	 * Start a frame: the counts of the last one are kept for GetIssued and GetSkipped
+	 */
+	void BeginFrame();
+	/**
+	 * Queue a call to pRenderable->Render(state, nParam). nState identifies the state it binds, its texture.
+	 * False if the queue is full, then nothing is queued
+	 */
+	XnBool Record(Layer eLayer, XnUInt32 nState, Renderable* pRenderable, XnUInt32 nParam);
+	/**
+	 * Sort and render everything recorded, and empty the queue
+	 */
+	void Flush();
+
+	RenderState& GetState();
+	/**
+	 * GL calls made in the last frame, and those the state cache skipped. Without it, there would have been both
+	 */
+	XnUInt32 GetIssued() const;
+	XnUInt32 GetSkipped() const;
+	/**
+	 * Draws rendered in the last frame
+	 */
+	XnUInt32 GetCommands() const;
+protected:
+	typedef struct
+	{
+		// Layer in the high byte, state below it
+		XnUInt32 nKey;
+		Renderable* pRenderable;
+		XnUInt32 nParam;
+	} Command;
+
+	RenderState m_State;
+	Command m_Commands[MAX_RENDER_COMMANDS];
+	XnUInt32 m_nCommands;
+	XnBool m_bFullReported;
+
+	XnUInt32 m_nLastIssued;
+	XnUInt32 m_nLastSkipped;
+	XnUInt32 m_nLastCommands;
+	XnUInt32 m_nFrameCommands;
+};
+
+#endif
@@ -0,0 +1,182 @@
+#include "RenderState.h"
+#include <string.h>
+
+// What a shadow holds before its first call
+#define UNKNOWN_STATE -1
+
+// The targets UseTexture switches between. Rectangle textures only exist with GLUT
+static const GLenum TextureTargets[] =
+{
+	GL_TEXTURE_2D,
+#ifdef USE_GLUT
+	GL_TEXTURE_RECTANGLE_ARB
+#endif
+};
+static const XnUInt32 nTextureTargets = sizeof(TextureTargets)/sizeof(TextureTargets[0]);
+
+RenderState::RenderState() :
+	m_nCaps(0), m_nArrays(0), m_nTargets(0)
+{
+	Invalidate();
+	ResetCounts();
+}
+
+void RenderState::Invalidate()
+{
+	m_nCaps = m_nArrays = 0;
+	InvalidateTextures();
+	InvalidateColor();
+	m_bPointSizeKnown = false;
+	m_bBlendKnown = false;
+	m_bMatrixModeKnown = false;
+}
+
+void RenderState::InvalidateTextures()
+{
+	m_nTargets = 0;
+}
+
+void RenderState::InvalidateColor()
+{
+	m_bColorKnown = false;
+}
+
+XnInt32* RenderState::Find(GLenum* pKeys, XnInt32* pValues, XnUInt32& nKeys, GLenum eKey)
+{
+	for (XnUInt32 i = 0; i < nKeys; ++i)
+	{
+		if (pKeys[i] == eKey)
+			return &pValues[i];
+	}
+	if (nKeys == MAX_SHADOWED_STATES)
+		return NULL;
+
+	pKeys[nKeys] = eKey;
+	pValues[nKeys] = UNKNOWN_STATE;
+	return &pValues[nKeys++];
+}
+
+XnBool RenderState::Change(XnInt32* pShadow, XnInt32 nValue)
+{
+	// States with no room in the shadow always go through
+	if (pShadow != NULL && *pShadow == nValue)
+	{
+		m_nSkipped++;
+		return false;
+	}
+	if (pShadow != NULL)
+		*pShadow = nValue;
+	m_nIssued++;
+	return true;
+}
+
+void RenderState::Enable(GLenum eCap)
+{
+	if (Change(Find(m_Caps, m_CapValues, m_nCaps, eCap), 1))
+		glEnable(eCap);
+}
+void RenderState::Disable(GLenum eCap)
+{
+	if (Change(Find(m_Caps, m_CapValues, m_nCaps, eCap), 0))
+		glDisable(eCap);
+}
+
+void RenderState::EnableClientState(GLenum eArray)
+{
+	if (Change(Find(m_Arrays, m_ArrayValues, m_nArrays, eArray), 1))
+		glEnableClientState(eArray);
+}
+void RenderState::DisableClientState(GLenum eArray)
+{
+	if (Change(Find(m_Arrays, m_ArrayValues, m_nArrays, eArray), 0))
+		glDisableClientState(eArray);
+}
+
+void RenderState::UseTexture(GLenum eTarget, GLuint nTexture)
+{
+	// Only one target on at a time, the fixed pipeline would pick the one with the highest priority
+	for (XnUInt32 i = 0; i < nTextureTargets; ++i)
+	{
+		if (TextureTargets[i] != eTarget)
+			Disable(TextureTargets[i]);
+	}
+	if (eTarget == 0)
+		return;
+
+	Enable(eTarget);
+	if (Change(Find(m_Targets, m_TargetValues, m_nTargets, eTarget), (XnInt32)nTexture))
+		glBindTexture(eTarget, nTexture);
+}
+
+void RenderState::Color(GLfloat fRed, GLfloat fGreen, GLfloat fBlue, GLfloat fAlpha)
+{
+	GLfloat color[4] = {fRed, fGreen, fBlue, fAlpha};
+	if (m_bColorKnown && memcmp(color, m_fColor, sizeof(color)) == 0)
+	{
+		m_nSkipped++;
+		return;
+	}
+	memcpy(m_fColor, color, sizeof(color));
+	m_bColorKnown = true;
+	m_nIssued++;
+	glColor4f(fRed, fGreen, fBlue, fAlpha);
+}
+
+void RenderState::PointSize(GLfloat fSize)
+{
+	if (m_bPointSizeKnown && m_fPointSize == fSize)
+	{
+		m_nSkipped++;
+		return;
+	}
+	m_fPointSize = fSize;
+	m_bPointSizeKnown = true;
+	m_nIssued++;
+	glPointSize(fSize);
+}
+
+void RenderState::BlendFunc(GLenum eSource, GLenum eDestination)
+{
+	if (m_bBlendKnown && m_eBlendSource == eSource && m_eBlendDestination == eDestination)
+	{
+		m_nSkipped++;
+		return;
+	}
+	m_eBlendSource = eSource;
+	m_eBlendDestination = eDestination;
+	m_bBlendKnown = true;
+	m_nIssued++;
+	glBlendFunc(eSource, eDestination);
+}
+
+void RenderState::MatrixMode(GLenum eMode)
+{
+	if (m_bMatrixModeKnown && m_eMatrixMode == eMode)
+	{
+		m_nSkipped++;
+		return;
+	}
+	m_eMatrixMode = eMode;
+	m_bMatrixModeKnown = true;
+	m_nIssued++;
+	glMatrixMode(eMode);
+}
+
+void RenderState::Count(XnUInt32 nCalls)
+{
+	m_nIssued += nCalls;
+}
+
+XnUInt32 RenderState::GetIssued() const
+{
+	return m_nIssued;
+}
+XnUInt32 RenderState::GetSkipped() const
+{
+	return m_nSkipped;
+}
+void RenderState::ResetCounts()
+{
+	m_nIssued = 0;
+	m_nSkipped = 0;
+}
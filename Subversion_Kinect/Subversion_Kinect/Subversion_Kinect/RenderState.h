@@ -0,0 +1,92 @@
+#ifndef RENDER_STATE_H_
+#define RENDER_STATE_H_
+
+#include <XnPlatform.h>
+
+#ifdef USE_GLUT
+	#include <glh_extensions.h>
+#elif defined(USE_GLES)
+	#include "opengles.h"
+#endif
+
+#define MAX_SHADOWED_STATES 8
+
+/**
+ * A shadow of the GL state the overlays change from frame to frame: the switches, client arrays, texture
+ * bindings, color, point size, blend function and matrix mode. A call that would set what is already set
+ * never reaches GL. Every state starts unknown, so its first call always goes through.
+ * Whoever changes any of these behind its back must call Invalidate.
+ * Calls made around it, like draws and pointers, are only counted, so the counts cover the whole frame.
+ */
+class RenderState
+{
+public:
+	RenderState();
+
+	/**
+	 * Forget everything, the next call of every kind goes to GL
+	 */
+	void Invalidate();
+	/**
+	 * Forget the texture bindings only
+	 */
+	void InvalidateTextures();
+	/**
+	 * Forget the current color, as after drawing with a color array
+	 */
+	void InvalidateColor();
+
+	void Enable(GLenum eCap);
+	void Disable(GLenum eCap);
+	void EnableClientState(GLenum eArray);
+	void DisableClientState(GLenum eArray);
+	/**
+	 * Texture nTexture on eTarget, with every other texture target disabled. eTarget 0 to disable them all
+	 */
+	void UseTexture(GLenum eTarget, GLuint nTexture);
+	void Color(GLfloat fRed, GLfloat fGreen, GLfloat fBlue, GLfloat fAlpha);
+	void PointSize(GLfloat fSize);
+	void BlendFunc(GLenum eSource, GLenum eDestination);
+	void MatrixMode(GLenum eMode);
+
+	/**
+	 * Count nCalls made straight to GL
+	 */
+	void Count(XnUInt32 nCalls = 1);
+	/**
+	 * Calls that went to GL, and calls skipped because they changed nothing, since the last reset
+	 */
+	XnUInt32 GetIssued() const;
+	XnUInt32 GetSkipped() const;
+	void ResetCounts();
+protected:
+	// The shadow of a switch or binding for eKey, added the first time it is seen. NULL when there is no more room
+	XnInt32* Find(GLenum* pKeys, XnInt32* pValues, XnUInt32& nKeys, GLenum eKey);
+	// Whether to make a call setting *pShadow to nValue, updating the shadow and the counts
+	XnBool Change(XnInt32* pShadow, XnInt32 nValue);
+
+	GLenum m_Caps[MAX_SHADOWED_STATES];
+	XnInt32 m_CapValues[MAX_SHADOWED_STATES];
+	XnUInt32 m_nCaps;
+	GLenum m_Arrays[MAX_SHADOWED_STATES];
+	XnInt32 m_ArrayValues[MAX_SHADOWED_STATES];
+	XnUInt32 m_nArrays;
+	GLenum m_Targets[MAX_SHADOWED_STATES];
+	XnInt32 m_TargetValues[MAX_SHADOWED_STATES];
+	XnUInt32 m_nTargets;
+
+	XnBool m_bColorKnown;
+	GLfloat m_fColor[4];
+	XnBool m_bPointSizeKnown;
+	GLfloat m_fPointSize;
+	XnBool m_bBlendKnown;
+	GLenum m_eBlendSource;
+	GLenum m_eBlendDestination;
+	XnBool m_bMatrixModeKnown;
+	GLenum m_eMatrixMode;
+
+	XnUInt32 m_nIssued;
+	XnUInt32 m_nSkipped;
+};
+
+#endif
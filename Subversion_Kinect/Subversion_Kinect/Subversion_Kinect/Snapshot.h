@@ -0,0 +1,61 @@
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+#include <XnPlatform.h>
+#include "Atomics.h"
+
+/**
+ * A value written by one thread and read by any, without a lock: a sequence lock. The version is odd while the
+ * value is being written, and a reader that saw it odd, or changed under it, reads again. The writer never waits,
+ * and a reader only for as long as it takes to copy a T.
+ * T is copied as it is, so it must not own anything.
+ */
+template <class T>
+class Snapshot
+{
+public:
+	Snapshot() : m_nVersion(0)
+	{
+	}
+
+	/**
+	 * From the writing thread only
+	 */
+	void Publish(const T& value)
+	{
+		AtomicIncrement(&m_nVersion);
+		m_Value = value;
+		AtomicIncrement(&m_nVersion);
+	}
+
+	/**
+	 * From any thread: the value last published, whole
+	 */
+	void Read(T& value) const
+	{
+		volatile XnUInt32* pVersion = (volatile XnUInt32*)&m_nVersion;
+		for (;;)
+		{
+			XnUInt32 nBefore = AtomicLoad(pVersion);
+			if ((nBefore & 1) != 0)
+				continue;
+
+			value = m_Value;
+			if (AtomicLoad(pVersion) == nBefore)
+				return;
+		}
+	}
+
+	/**
+	 * How many times a value was published. Changes whenever the value may have
+	 */
+	XnUInt32 GetVersion() const
+	{
+		return AtomicLoad((volatile XnUInt32*)&m_nVersion)/2;
+	}
+private:
+	volatile XnUInt32 m_nVersion;
+	T m_Value;
+};
+
+#endif
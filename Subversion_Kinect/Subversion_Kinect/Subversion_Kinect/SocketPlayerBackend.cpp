@@ -0,0 +1,360 @@
+#include "SocketPlayerBackend.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+	#include <errno.h>
+	#include <sys/socket.h>
+	#include <sys/un.h>
+	#include <unistd.h>
+#endif
+
+SocketPlayerBackend::SocketPlayerBackend(const XnChar* strSocket) :
+	m_nSocket(-1), m_bReportFailure(true), m_nReceived(0), m_bDropping(false)
+{
+	xnOSStrCopy(m_strSocket, strSocket, sizeof(m_strSocket));
+	m_strOpen[0] = '\0';
+	m_strRepeat[0] = '\0';
+}
+
+SocketPlayerBackend::~SocketPlayerBackend()
+{
+	Disconnect();
+}
+
+XnStatus SocketPlayerBackend::Connect()
+{
+	// A new player, with nothing to bring it back to
+	m_strOpen[0] = '\0';
+	m_strRepeat[0] = '\0';
+	m_bReportFailure = true;
+	return OpenSocket();
+}
+
+XnStatus SocketPlayerBackend::OpenSocket()
+{
+#ifdef _WIN32
+	printf("Player at %s: Unix sockets are not available here\n", m_strSocket);
+	return XN_STATUS_ERROR;
+#else
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (strlen(m_strSocket) >= sizeof(address.sun_path))
+	{
+		printf("Player at %s: the path is too long for a socket\n", m_strSocket);
+		return XN_STATUS_ERROR;
+	}
+	strcpy(address.sun_path, m_strSocket);
+
+	m_nSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (m_nSocket < 0 || connect(m_nSocket, (sockaddr*)&address, sizeof(address)) != 0)
+	{
+		// Once: a player that is gone is tried again on every call
+		if (m_bReportFailure)
+			printf("Player at %s: cannot connect: %s\n", m_strSocket, strerror(errno));
+		m_bReportFailure = false;
+		if (m_nSocket >= 0)
+			close(m_nSocket);
+		m_nSocket = -1;
+		return XN_STATUS_ERROR;
+	}
+	m_bReportFailure = true;
+	m_nReceived = 0;
+	m_bDropping = false;
+	return XN_STATUS_OK;
+#endif
+}
+
+void SocketPlayerBackend::CloseSocket()
+{
+	if (m_nSocket < 0)
+		return;
+#ifndef _WIN32
+	close(m_nSocket);
+#endif
+	m_nSocket = -1;
+}
+
+XnStatus SocketPlayerBackend::Reconnect()
+{
+	XnStatus rc = OpenSocket();
+	XN_IS_STATUS_OK(rc);
+	printf("Player at %s: connected again\n", m_strSocket);
+
+	if (m_strOpen[0] != '\0')
+	{
+		rc = Exchange(m_strOpen, NULL, 0);
+		XN_IS_STATUS_OK(rc);
+	}
+	if (m_strRepeat[0] != '\0')
+		rc = Exchange(m_strRepeat, NULL, 0);
+	return rc;
+}
+
+void SocketPlayerBackend::Disconnect()
+{
+	if (m_nSocket < 0)
+		return;
+
+	// Closing is a courtesy: a player that is gone already is not an error
+	Exchange("CLOSE\n", NULL, 0);
+	CloseSocket();
+}
+
+XnStatus SocketPlayerBackend::Escape(const XnChar* strField, XnChar* strEscaped, XnUInt32 nSize)
+{
+	XnUInt32 nLength = 0;
+	for (; *strField != '\0'; ++strField)
+	{
+		XnChar cEscaped = *strField == '\t' ? 't' : *strField == '\n' ? 'n' : *strField == '\r' ? 'r' :
+			*strField == '\\' ? '\\' : '\0';
+		if (nLength + (cEscaped != '\0' ? 2 : 1) >= nSize)
+		{
+			printf("Player: a field is too long for a request\n");
+			return XN_STATUS_ERROR;
+		}
+		if (cEscaped != '\0')
+		{
+			strEscaped[nLength++] = '\\';
+			strEscaped[nLength++] = cEscaped;
+		}
+		else
+			strEscaped[nLength++] = *strField;
+	}
+	strEscaped[nLength] = '\0';
+	return XN_STATUS_OK;
+}
+
+void SocketPlayerBackend::Unescape(XnChar* strField)
+{
+	XnChar* pOut = strField;
+	for (const XnChar* pIn = strField; *pIn != '\0'; ++pIn)
+	{
+		if (*pIn != '\\' || pIn[1] == '\0')
+		{
+			*pOut++ = *pIn;
+			continue;
+		}
+		++pIn;
+		*pOut++ = *pIn == 't' ? '\t' : *pIn == 'n' ? '\n' : *pIn == 'r' ? '\r' : *pIn;
+	}
+	*pOut = '\0';
+}
+
+XnStatus SocketPlayerBackend::OpenFile(const XnChar* strFile)
+{
+	XnChar strEscaped[PLAYER_LINE_MAX];
+	XnStatus rc = Escape(strFile, strEscaped, sizeof(strEscaped));
+	XN_IS_STATUS_OK(rc);
+	XnChar strRequest[PLAYER_LINE_MAX];
+	XnUInt32 nWritten;
+	rc = xnOSStrFormat(strRequest, sizeof(strRequest), &nWritten, "OPEN\t%s\n", strEscaped);
+	XN_IS_STATUS_OK(rc);
+	rc = Call(strRequest);
+	XN_IS_STATUS_OK(rc);
+	xnOSStrCopy(m_strOpen, strRequest, sizeof(m_strOpen));
+	return XN_STATUS_OK;
+}
+
+XnStatus SocketPlayerBackend::OpenLeftRightFiles(const XnChar* strLeft, const XnChar* strRight,
+	const XnChar* strAudio, XnInt32 nAudioMode)
+{
+	XnChar strEscaped[3][PLAYER_LINE_MAX];
+	XnStatus rc = Escape(strLeft, strEscaped[0], sizeof(strEscaped[0]));
+	XN_IS_STATUS_OK(rc);
+	rc = Escape(strRight, strEscaped[1], sizeof(strEscaped[1]));
+	XN_IS_STATUS_OK(rc);
+	rc = Escape(strAudio == NULL ? "" : strAudio, strEscaped[2], sizeof(strEscaped[2]));
+	XN_IS_STATUS_OK(rc);
+	XnChar strRequest[PLAYER_LINE_MAX];
+	XnUInt32 nWritten;
+	rc = xnOSStrFormat(strRequest, sizeof(strRequest), &nWritten, "OPENLR\t%d\t%s\t%s%s%s\n", nAudioMode,
+		strEscaped[0], strEscaped[1], strAudio == NULL ? "" : "\t", strEscaped[2]);
+	XN_IS_STATUS_OK(rc);
+	rc = Call(strRequest);
+	XN_IS_STATUS_OK(rc);
+	xnOSStrCopy(m_strOpen, strRequest, sizeof(m_strOpen));
+	return XN_STATUS_OK;
+}
+
+XnStatus SocketPlayerBackend::GetDuration(XnDouble& fSeconds)
+{
+	XnChar strValue[64];
+	XnStatus rc = Call("DURATION\n", strValue, sizeof(strValue));
+	XN_IS_STATUS_OK(rc);
+	fSeconds = atof(strValue);
+	return XN_STATUS_OK;
+}
+
+XnStatus SocketPlayerBackend::SetPlaybackState(PlaybackState eState)
+{
+	static const XnChar* requests[] = {"PLAYBACK\tPLAY\n", "PLAYBACK\tPAUSE\n", "PLAYBACK\tSTOP\n"};
+	return Call(requests[eState]);
+}
+
+XnStatus SocketPlayerBackend::SetZoom(XnDouble fPercent)
+{
+	XnChar strRequest[64];
+	XnUInt32 nWritten;
+	XnStatus rc = xnOSStrFormat(strRequest, sizeof(strRequest), &nWritten, "ZOOM\t%.3f\n", fPercent);
+	XN_IS_STATUS_OK(rc);
+	return Call(strRequest);
+}
+
+XnStatus SocketPlayerBackend::SetFullScreen(XnBool bFullScreen)
+{
+	return Call(bFullScreen ? "FULLSCREEN\t1\n" : "FULLSCREEN\t0\n");
+}
+
+XnStatus SocketPlayerBackend::SetRepeat(XnBool bRepeat)
+{
+	const XnChar* strRequest = bRepeat ? "REPEAT\t1\n" : "REPEAT\t0\n";
+	XnStatus rc = Call(strRequest);
+	XN_IS_STATUS_OK(rc);
+	xnOSStrCopy(m_strRepeat, strRequest, sizeof(m_strRepeat));
+	return XN_STATUS_OK;
+}
+
+XnStatus SocketPlayerBackend::GetState(PlayerState& state)
+{
+	XnChar strValue[PLAYER_LINE_MAX];
+	XnStatus rc = Call("STATE\n", strValue, sizeof(strValue));
+	XN_IS_STATUS_OK(rc);
+
+	XnChar strPlayback[16];
+	XnDouble fPosition, fDuration, fZoom;
+	XnInt32 nFullScreen;
+	if (sscanf(strValue, "%15s %lf %lf %lf %d", strPlayback, &fPosition, &fDuration, &fZoom, &nFullScreen) != 5)
+	{
+		printf("Player: STATE answered %s\n", strValue);
+		return XN_STATUS_ERROR;
+	}
+
+	if (strcmp(strPlayback, "PLAY") == 0)
+		state.ePlayback = PLAYBACK_PLAY;
+	else if (strcmp(strPlayback, "PAUSE") == 0)
+		state.ePlayback = PLAYBACK_PAUSE;
+	else
+		state.ePlayback = PLAYBACK_STOP;
+	state.fPosition = fPosition;
+	state.fDuration = fDuration;
+	state.fZoom = fZoom;
+	state.bFullScreen = nFullScreen != 0;
+	state.nReported |= PLAYER_STATE_ALL;
+	return XN_STATUS_OK;
+}
+
+XnStatus SocketPlayerBackend::Call(const XnChar* strRequest, XnChar* strValue, XnUInt32 nValueSize)
+{
+	if (m_nSocket < 0)
+	{
+		XnStatus rc = Reconnect();
+		XN_IS_STATUS_OK(rc);
+	}
+
+	XnStatus rc = Exchange(strRequest, strValue, nValueSize);
+	// A player that went away since the last call is tried again, once
+	if (rc != XN_STATUS_OK && m_nSocket < 0 && Reconnect() == XN_STATUS_OK)
+		rc = Exchange(strRequest, strValue, nValueSize);
+	return rc;
+}
+
+XnStatus SocketPlayerBackend::Exchange(const XnChar* strRequest, XnChar* strValue, XnUInt32 nValueSize)
+{
+	XnChar strReply[PLAYER_LINE_MAX];
+	if (!Write(strRequest, (XnUInt32)strlen(strRequest)) || !ReadLine(strReply, sizeof(strReply)))
+	{
+		if (m_nSocket >= 0)
+		{
+			printf("Player: %.*s failed: the reply is longer than %d bytes\n", (int)strcspn(strRequest, "\n"), strRequest,
+				PLAYER_LINE_MAX);
+			return XN_STATUS_ERROR;
+		}
+		printf("Player at %s: the connection is lost\n", m_strSocket);
+		return XN_STATUS_ERROR;
+	}
+
+	if (strncmp(strReply, "OK", 2) != 0 || (strReply[2] != '\0' && strReply[2] != '\t'))
+	{
+		// The request without its newline, then why it failed
+		printf("Player: %.*s failed: %s\n", (int)strcspn(strRequest, "\n"), strRequest,
+			strncmp(strReply, "ERR\t", 4) == 0 ? strReply + 4 : strReply);
+		return XN_STATUS_ERROR;
+	}
+
+	if (strValue != NULL)
+		xnOSStrCopy(strValue, strReply[2] == '\t' ? strReply + 3 : "", nValueSize);
+	return XN_STATUS_OK;
+}
+
+XnBool SocketPlayerBackend::Write(const XnChar* strData, XnUInt32 nSize)
+{
+#ifdef _WIN32
+	return false;
+#else
+	while (nSize > 0)
+	{
+		// A player that went away is a failed command, not a SIGPIPE
+#ifdef MSG_NOSIGNAL
+		ssize_t nSent = send(m_nSocket, strData, nSize, MSG_NOSIGNAL);
+#else
+		ssize_t nSent = send(m_nSocket, strData, nSize, 0);
+#endif
+		if (nSent < 0 && errno == EINTR)
+			continue;
+		if (nSent <= 0)
+		{
+			CloseSocket();
+			return false;
+		}
+		strData += nSent;
+		nSize -= (XnUInt32)nSent;
+	}
+	return true;
+#endif
+}
+
+XnBool SocketPlayerBackend::ReadLine(XnChar* strLine, XnUInt32 nSize)
+{
+#ifdef _WIN32
+	return false;
+#else
+	for (;;)
+	{
+		XnChar* pEnd = (XnChar*)memchr(m_Received, '\n', m_nReceived);
+		if (pEnd != NULL)
+		{
+			XnUInt32 nLength = (XnUInt32)(pEnd - m_Received);
+			XnUInt32 nCopied = nLength < nSize - 1 ? nLength : nSize - 1;
+			memcpy(strLine, m_Received, nCopied);
+			strLine[nCopied] = '\0';
+			m_nReceived -= nLength + 1;
+			memmove(m_Received, pEnd + 1, m_nReceived);
+			if (!m_bDropping)
+				return true;
+			// The end of the line too long: the next one is whole again
+			m_bDropping = false;
+			return false;
+		}
+
+		// A line longer than the buffer is not one the protocol has: dropped up to its newline, so the replies
+		// after it are read as they come
+		if (m_nReceived == sizeof(m_Received))
+		{
+			m_nReceived = 0;
+			m_bDropping = true;
+		}
+		ssize_t nRead = recv(m_nSocket, m_Received + m_nReceived, sizeof(m_Received) - m_nReceived, 0);
+		if (nRead < 0 && errno == EINTR)
+			continue;
+		if (nRead <= 0)
+		{
+			CloseSocket();
+			return false;
+		}
+		m_nReceived += (XnUInt32)nRead;
+	}
+#endif
+}
@@ -0,0 +1,90 @@
+#ifndef SOCKET_PLAYER_BACKEND_H_
+#define SOCKET_PLAYER_BACKEND_H_
+
+#include "PlayerBackend.h"
+
+// Longest request or reply, newline included
+#define PLAYER_LINE_MAX 2048
+// Where the player listens, unless told otherwise
+#define PLAYER_SOCKET "/tmp/stereoplayer.sock"
+
+/**
+ * A player behind a Unix socket, such as the mock player (see MockPlayer.h), so the commands can be driven and
+ * timed without StereoPlayer, or Windows.
+ * One request a line, its fields separated by tabs, each answered before the next is sent:
+ *	OPEN <file>
+ *	OPENLR <audio mode> <left file> <right file> [<audio file>]
+ *	DURATION				answered OK <seconds>
+ *	PLAYBACK PLAY|PAUSE|STOP
+ *	ZOOM <percent>
+ *	FULLSCREEN 0|1
+ *	REPEAT 0|1
+ *	STATE				answered OK PLAY|PAUSE|STOP <position> <duration> <zoom> <fullscreen 0|1>
+ *	CLOSE
+ * answered OK, or ERR <why>. Within a field, a tab is written \t, a newline \n, a carriage return \r and a
+ * backslash \\ (see Escape).
+ * A line too long for the other side is dropped up to its newline, and answered or reported as an error.
+ * When the player goes away, the next call connects again, opens the video last opened and sets the repeat last
+ * set, then makes the request: every request is absolute, so making it again is harmless.
+ * Unix sockets only: on Windows, Connect fails.
+ */
+class SocketPlayerBackend : public PlayerBackend
+{
+public:
+	SocketPlayerBackend(const XnChar* strSocket);
+	~SocketPlayerBackend();
+
+	XnStatus Connect();
+	void Disconnect();
+
+	XnStatus OpenFile(const XnChar* strFile);
+	XnStatus OpenLeftRightFiles(const XnChar* strLeft, const XnChar* strRight, const XnChar* strAudio,
+		XnInt32 nAudioMode);
+	XnStatus GetDuration(XnDouble& fSeconds);
+
+	XnStatus SetPlaybackState(PlaybackState eState);
+	XnStatus SetZoom(XnDouble fPercent);
+	XnStatus SetFullScreen(XnBool bFullScreen);
+	XnStatus SetRepeat(XnBool bRepeat);
+	XnStatus GetState(PlayerState& state);
+
+	/**
+	 * Write strField into strEscaped, tabs, newlines, carriage returns and backslashes escaped. Fails if it does not
+	 * fit in nSize
+	 */
+	static XnStatus Escape(const XnChar* strField, XnChar* strEscaped, XnUInt32 nSize);
+	/**
+	 * Undo Escape, in place
+	 */
+	static void Unescape(XnChar* strField);
+protected:
+	// Reach the player, reporting a failure only if the last attempt succeeded
+	XnStatus OpenSocket();
+	void CloseSocket();
+	// Connect again, and bring the player back to the video and repeat last set
+	XnStatus Reconnect();
+	// Send one request line and wait for its reply, connecting again if the player went away.
+	// What follows the OK goes to strValue, when given
+	XnStatus Call(const XnChar* strRequest, XnChar* strValue = NULL, XnUInt32 nValueSize = 0);
+	// Call, on the connection as it is. The connection is closed if it is lost on the way
+	XnStatus Exchange(const XnChar* strRequest, XnChar* strValue, XnUInt32 nValueSize);
+	XnBool Write(const XnChar* strData, XnUInt32 nSize);
+	// The next line the player sent, without its newline. False if the connection is lost, or the line is too long,
+	// in which case it is dropped and the connection kept
+	XnBool ReadLine(XnChar* strLine, XnUInt32 nSize);
+
+	XnChar m_strSocket[XN_FILE_MAX_PATH];
+	int m_nSocket;
+	XnBool m_bReportFailure;
+	// Read from the socket, not yet taken as a line
+	XnChar m_Received[PLAYER_LINE_MAX];
+	XnUInt32 m_nReceived;
+	// Dropping the rest of a line too long to be taken
+	XnBool m_bDropping;
+
+	// The requests a new connection replays, empty if none was made yet
+	XnChar m_strOpen[PLAYER_LINE_MAX];
+	XnChar m_strRepeat[16];
+};
+
+#endif
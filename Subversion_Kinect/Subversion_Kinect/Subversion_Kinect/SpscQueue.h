@@ -0,0 +1,80 @@
+#ifndef SPSC_QUEUE_H_
+#define SPSC_QUEUE_H_
+
+#include <XnPlatform.h>
+#include "Atomics.h"
+
+/**
+ * A first in, first out queue of at most N items, between one producer thread and one consumer thread,
+ * without a lock: each side only ever writes its own end. N must be a power of two.
+ * It never allocates: when it is full Push fails, and the item is counted as rejected.
+ */
+template <class T, XnUInt32 N>
+class SpscQueue
+{
+public:
+	SpscQueue() : m_nHead(0), m_nTail(0), m_nRejected(0)
+	{
+		// The ends wrap around 2^32, which has to stay a multiple of N
+		typedef char PowerOfTwo[(N & (N - 1)) == 0 ? 1 : -1];
+		(void)sizeof(PowerOfTwo);
+	}
+
+	/**
+	 * From the producer thread only
+	 */
+	XnBool Push(const T& item)
+	{
+		XnUInt32 nTail = m_nTail;
+		if (nTail - AtomicLoad(&m_nHead) == N)
+		{
+			m_nRejected++;
+			return false;
+		}
+
+		m_Items[nTail % N] = item;
+		// Publishes the item along with the new end
+		AtomicExchange(&m_nTail, nTail + 1);
+		return true;
+	}
+
+	/**
+	 * From the consumer thread only. Takes the oldest item, returns false without waiting when there is none
+	 */
+	XnBool Pop(T& item)
+	{
+		XnUInt32 nHead = m_nHead;
+		if (AtomicLoad(&m_nTail) == nHead)
+			return false;
+
+		item = m_Items[nHead % N];
+		// The slot can be written again from now on
+		AtomicExchange(&m_nHead, nHead + 1);
+		return true;
+	}
+
+	/**
+	 * Items waiting, from any thread. Only a snapshot, either end may move right after
+	 */
+	XnUInt32 GetDepth() const
+	{
+		return AtomicLoad((volatile XnUInt32*)&m_nTail) - AtomicLoad((volatile XnUInt32*)&m_nHead);
+	}
+
+	XnUInt32 GetRejectedCount() const
+	{
+		return m_nRejected;
+	}
+private:
+	SpscQueue(const SpscQueue&);
+	SpscQueue& operator=(const SpscQueue&);
+
+	T m_Items[N];
+	// Written by the consumer only
+	volatile XnUInt32 m_nHead;
+	// Written by the producer only
+	volatile XnUInt32 m_nTail;
+	XnUInt32 m_nRejected;
+};
+
+#endif
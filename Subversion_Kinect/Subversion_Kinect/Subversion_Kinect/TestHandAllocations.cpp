@@ -0,0 +1,162 @@
+//Drives the point drawer through NITE's point messages, the way the viewer's NITE and display threads do, and fails
+//if any frame allocates on the heap once the hands are in. Needs no sensor: the depth generator is a mock one
+
+//headers for OpenNI
+#include <XnOpenNI.h>
+#include <XnCppWrapper.h>
+#include <XnPropNames.h>
+
+//header for NITE
+#include <XnVPointMessage.h>
+#include <XnVMultipleHands.h>
+
+#include <math.h>
+#include <stdio.h>
+
+//local headers
+#include "PointDrawer.h"
+#include "AllocationCounter.h"
+
+#define CHECK_RC(rc, what)											\
+	if (rc != XN_STATUS_OK)											\
+	{																\
+		printf("%s failed: %s\n", what, xnGetStatusString(rc));		\
+		return rc;													\
+	}
+
+#define TEST_HANDS 4
+// Frames run before counting: the first snapshots and labels may allocate, what follows must not
+#define WARMUP_FRAMES 50
+#define COUNTED_FRAMES 2000
+
+//a depth generator with the Kinect's resolution and field of view, for the projection
+static XnStatus CreateDepth(xn::Context& context, xn::MockDepthGenerator& depthGenerator)
+{
+	XnStatus rc = context.Init();
+	CHECK_RC(rc, "Init");
+	rc = depthGenerator.Create(context);
+	CHECK_RC(rc, "Create mock depth");
+	XnMapOutputMode mode;
+	mode.nXRes = 640;
+	mode.nYRes = 480;
+	mode.nFPS = 30;
+	rc = depthGenerator.SetMapOutputMode(mode);
+	CHECK_RC(rc, "Set output mode");
+	XnFieldOfView fov;
+	fov.fHFOV = 1.0144686707507438;
+	fov.fVFOV = 0.78980943449644714;
+	rc = depthGenerator.SetGeneralProperty(XN_PROP_FIELD_OF_VIEW, sizeof(fov), &fov);
+	CHECK_RC(rc, "Set field of view");
+	return XN_STATUS_OK;
+}
+
+//hand i of TEST_HANDS at frame nFrame: each on its own circle in front of the sensor
+static void MoveHand(XnVHandPointContext& cxt, XnUInt32 i, XnUInt32 nFrame)
+{
+	XnFloat fAngle = nFrame*0.1f + i*1.5f;
+	cxt.ptPosition.X = -300.0f + 200.0f*i + 100.0f*cosf(fAngle);
+	cxt.ptPosition.Y = 100.0f*sinf(fAngle);
+	cxt.ptPosition.Z = 1500.0f + 50.0f*i;
+	cxt.fTime = nFrame/30.0f;
+}
+
+//one NITE update and one display frame for each of nFrames frames. Every hand moves on every frame, and every hundred
+//frames one of them is lost and found again, so creating and destroying hands is on the path too.
+//Returns the allocations made from nCountFrom on
+template <class Drawer>
+static XnUInt32 RunFrames(Drawer& drawer, XnUInt32 nFrames, XnUInt32 nCountFrom)
+{
+	XnVMultipleHands hands;
+	XnVHandPointContext contexts[TEST_HANDS];
+	for (XnUInt32 i = 0; i < TEST_HANDS; ++i)
+	{
+		contexts[i].nID = i + 1;
+		contexts[i].nUserID = 0;
+		contexts[i].fConfidence = 1;
+		MoveHand(contexts[i], i, 0);
+		hands.Add(&contexts[i]);
+		hands.MarkNew(contexts[i].nID);
+	}
+
+	for (XnUInt32 nFrame = 0; nFrame < nFrames; ++nFrame)
+	{
+		if (nFrame == nCountFrom)
+			BeginCountingAllocations();
+
+		if (nFrame > 0)
+		{
+			hands.ClearLists();
+			for (XnUInt32 i = 0; i < TEST_HANDS; ++i)
+			{
+				MoveHand(contexts[i], i, nFrame);
+				hands.Add(&contexts[i]);
+			}
+			// Lose one hand, and find it again the next frame under a new ID
+			XnUInt32 nLost = (nFrame/100) % TEST_HANDS;
+			if (nFrame % 100 == 0)
+			{
+				hands.Remove(contexts[nLost].nID);
+				hands.MarkOld(contexts[nLost].nID);
+			}
+			else if (nFrame % 100 == 1)
+			{
+				contexts[nLost].nID += TEST_HANDS;
+				hands.Add(&contexts[nLost]);
+				hands.MarkNew(contexts[nLost].nID);
+			}
+			for (XnUInt32 i = 0; i < TEST_HANDS; ++i)
+				hands.MarkActive(contexts[i].nID);
+		}
+
+		// What the NITE thread does
+		XnVPointMessage message(&hands);
+		drawer.Update(&message);
+
+		// And the display, which only records the hands: there is no GL context to render them, so every frame
+		// has a queue of its own rather than flushing one
+		RenderQueue queue;
+		drawer.DrawFrame(queue, NULL, true);
+	}
+	return EndCountingAllocations();
+}
+
+template <class Drawer>
+static XnBool Check(Drawer& drawer, const XnChar* strName)
+{
+	XnUInt32 nAllocations = RunFrames(drawer, WARMUP_FRAMES + COUNTED_FRAMES, WARMUP_FRAMES);
+	printf("%-40s %u heap allocations over %u frames%s\n", strName, nAllocations, COUNTED_FRAMES,
+		nAllocations == 0 ? "" : " - SHOULD BE 0");
+	return nAllocations == 0;
+}
+
+int main(int argc, char ** argv)
+{
+	xn::Context context;
+	xn::MockDepthGenerator depthGenerator;
+	if (CreateDepth(context, depthGenerator) != XN_STATUS_OK)
+		return 1;
+
+	XnBool bPassed = true;
+	{
+		// The viewer's drawer, with each projection
+		XnVFixedPointDrawer<20, HAND_LAYOUT_PROJECTIVE> drawer(depthGenerator);
+		bPassed &= Check(drawer, "XnVFixedPointDrawer<20>, library");
+		XnFloat fError;
+		if (drawer.GetProjection().CheckNative(fError))
+		{
+			drawer.GetProjection().SetMode(ProjectiveConverter::CONVERT_NATIVE);
+			bPassed &= Check(drawer, "XnVFixedPointDrawer<20>, native");
+		}
+	}
+	{
+		XnVFixedPointDrawer<32, HAND_LAYOUT_3D> drawer(depthGenerator);
+		bPassed &= Check(drawer, "XnVFixedPointDrawer<32, 3D>");
+	}
+	{
+		XnVPointDrawer drawer(20, depthGenerator);
+		bPassed &= Check(drawer, "XnVPointDrawer(20)");
+	}
+
+	context.Release();
+	return bPassed ? 0 : 1;
+}
@@ -0,0 +1,57 @@
+//Scores the hand filter the viewer runs against the raw positions, on a synthetic hand whose true path is known,
+//and fails if it does not beat them. Needs no sensor
+
+#include <stdio.h>
+
+//local headers
+#include "HandTrajectories.h"
+
+// The synthetic hand's sensor noise, in mm, and the lateness prediction is checked against, in ms
+#define TEST_NOISE 3.0f
+#define TEST_LATE_MS 66.0f
+
+static void PrintScore(const XnChar* strName, const HandTrajectories::Score& score)
+{
+	printf("  %-24s lag %4.0f ms, jitter %6.2f mm, error %6.2f mm\n", strName, score.fLagMs, score.fJitter, score.fError);
+}
+
+int main(int argc, char ** argv)
+{
+	XnBool bPassed = true;
+	HandTrajectories trajectories;
+
+	HandFilter raw;
+	raw.SetType(HandFilter::FILTER_NONE);
+	// As the viewer starts it
+	HandFilter chosen;
+
+	// On time: smoothing only, it has to be closer to the true path than the noisy positions, and steadier
+	trajectories.Synthesize(0, TEST_NOISE);
+	printf("Synthetic hand on time, %.0f mm noise\n", TEST_NOISE);
+	HandTrajectories::Score rawScore = trajectories.Run(raw);
+	HandTrajectories::Score chosenScore = trajectories.Run(chosen);
+	PrintScore("raw", rawScore);
+	PrintScore(HandFilter::GetTypeName(chosen.GetType()), chosenScore);
+	if (chosenScore.fError >= rawScore.fError || chosenScore.fJitter >= rawScore.fJitter)
+	{
+		printf("FAILED: %s does not beat the raw positions\n", HandFilter::GetTypeName(chosen.GetType()));
+		bPassed = false;
+	}
+
+	// Late: predicting the lateness away has to land closer to where the hand is than the late positions do
+	trajectories.Synthesize(TEST_LATE_MS, TEST_NOISE);
+	printf("Synthetic hand %.0f ms late, %.0f mm noise\n", TEST_LATE_MS, TEST_NOISE);
+	HandFilter predicting = chosen;
+	predicting.SetPrediction(TEST_LATE_MS);
+	rawScore = trajectories.Run(raw);
+	chosenScore = trajectories.Run(predicting);
+	PrintScore("raw", rawScore);
+	PrintScore("predicting", chosenScore);
+	if (chosenScore.fError >= rawScore.fError)
+	{
+		printf("FAILED: %s predicting %.0f ms does not beat the raw positions\n", HandFilter::GetTypeName(chosen.GetType()), TEST_LATE_MS);
+		bPassed = false;
+	}
+
+	return bPassed ? 0 : 1;
+}
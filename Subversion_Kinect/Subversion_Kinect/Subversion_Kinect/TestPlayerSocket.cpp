@@ -0,0 +1,187 @@
+//The player behind a socket, against the mock player and a player that misbehaves: what it refuses, how it
+//escapes its fields, and that it survives the player going away or sending a line too long. Needs no sensor
+//or Windows, only Unix sockets
+
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+//local headers
+#include "SocketPlayerBackend.h"
+#include "MockPlayer.h"
+
+#define TEST_SOCKET "/tmp/test_player_socket.sock"
+// How long a player just started is given to listen, in ms
+#define TEST_LISTEN_MS 2000
+
+#define CHECK(condition, what)						\
+	if (!(condition))								\
+	{												\
+		printf("FAILED: %s\n", what);				\
+		bPassed = false;							\
+	}
+
+// Wait for a player to listen on strSocket. The connection made to find out is closed again
+static XnBool WaitForPlayer(const XnChar* strSocket)
+{
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, strSocket);
+	for (XnUInt32 nWaited = 0; nWaited < TEST_LISTEN_MS; nWaited += 10)
+	{
+		int nSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+		XnBool bConnected = nSocket >= 0 && connect(nSocket, (sockaddr*)&address, sizeof(address)) == 0;
+		if (nSocket >= 0)
+			close(nSocket);
+		if (bConnected)
+			return true;
+		xnOSSleep(10);
+	}
+	return false;
+}
+
+// The mock player, answering at once, in a process of its own
+static pid_t StartMockPlayer()
+{
+	unlink(TEST_SOCKET);
+	// Or the child prints what the parent has yet to
+	fflush(stdout);
+	pid_t nChild = fork();
+	if (nChild == 0)
+		_exit(MockPlayer::Serve(TEST_SOCKET, 0, 0));
+	return WaitForPlayer(TEST_SOCKET) ? nChild : -1;
+}
+
+// A player that answers its first request with a line too long for the protocol, and every other one OK
+static pid_t StartLongLinePlayer()
+{
+	unlink(TEST_SOCKET);
+	fflush(stdout);
+	pid_t nChild = fork();
+	if (nChild != 0)
+		return WaitForPlayer(TEST_SOCKET) ? nChild : -1;
+
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, TEST_SOCKET);
+	int nListener = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (nListener < 0 || bind(nListener, (sockaddr*)&address, sizeof(address)) != 0 || listen(nListener, 1) != 0)
+		_exit(1);
+
+	static XnChar strLong[2*PLAYER_LINE_MAX + 2];
+	memset(strLong, 'x', sizeof(strLong) - 2);
+	strLong[sizeof(strLong) - 2] = '\n';
+	strLong[sizeof(strLong) - 1] = '\0';
+	for (;;)
+	{
+		int nClient = accept(nListener, NULL, NULL);
+		if (nClient < 0)
+			_exit(1);
+		XnUInt32 nRequests = 0;
+		XnChar c;
+		while (recv(nClient, &c, 1, 0) == 1)
+		{
+			if (c != '\n')
+				continue;
+			const XnChar* strReply = nRequests++ == 0 ? strLong : "OK\n";
+			if (send(nClient, strReply, strlen(strReply), 0) < 0)
+				break;
+		}
+		close(nClient);
+	}
+}
+
+static void StopPlayer(pid_t nChild)
+{
+	if (nChild <= 0)
+		return;
+	kill(nChild, SIGKILL);
+	waitpid(nChild, NULL, 0);
+}
+
+int main(int argc, char ** argv)
+{
+	XnBool bPassed = true;
+	// A player killed under a test is a lost connection, not the end of the test
+	signal(SIGPIPE, SIG_IGN);
+
+	// A zoom that is not a number, or out of range, is refused, and the zoom kept
+	{
+		MockPlayer player(0, 0);
+		XnChar strReply[PLAYER_LINE_MAX];
+		XnChar strRequest[64];
+		XnUInt32 nWritten;
+		xnOSStrCopy(strRequest, "OPEN\tclip.mov", sizeof(strRequest));
+		player.Answer(strRequest, strReply, sizeof(strReply));
+		const XnChar* zooms[] = {"nan", "NAN", "inf", "-5", "1e9", "150x", ""};
+		for (XnUInt32 i = 0; i < sizeof(zooms)/sizeof(zooms[0]); ++i)
+		{
+			xnOSStrFormat(strRequest, sizeof(strRequest), &nWritten, "ZOOM\t%s", zooms[i]);
+			player.Answer(strRequest, strReply, sizeof(strReply));
+			printf("ZOOM %-5s answered %s\n", zooms[i], strReply);
+			CHECK(strncmp(strReply, "ERR", 3) == 0, "a zoom out of range was taken");
+		}
+		xnOSStrCopy(strRequest, "STATE", sizeof(strRequest));
+		player.Answer(strRequest, strReply, sizeof(strReply));
+		XnChar strPlayback[16];
+		XnDouble fPosition, fDuration, fZoom;
+		CHECK(sscanf(strReply, "OK %15s %lf %lf %lf", strPlayback, &fPosition, &fDuration, &fZoom) == 4 &&
+			fZoom == ZOOM_DEFAULT, "a refused zoom changed the zoom");
+	}
+
+	// A path with tabs, newlines and backslashes arrives as it was
+	{
+		const XnChar* strFile = "a\tb\nc\\d\r.mov";
+		XnChar strEscaped[64];
+		CHECK(SocketPlayerBackend::Escape(strFile, strEscaped, sizeof(strEscaped)) == XN_STATUS_OK &&
+			strpbrk(strEscaped, "\t\n\r") == NULL, "the escaped path still has tabs or newlines");
+		XnChar strRequest[PLAYER_LINE_MAX];
+		XnUInt32 nWritten;
+		xnOSStrFormat(strRequest, sizeof(strRequest), &nWritten, "OPEN\t%s", strEscaped);
+		MockPlayer player(0, 0);
+		XnChar strReply[PLAYER_LINE_MAX];
+		player.Answer(strRequest, strReply, sizeof(strReply));
+		CHECK(strcmp(strReply, "OK") == 0 && strcmp(player.GetFile(), strFile) == 0, "the path did not arrive as it was");
+		CHECK(SocketPlayerBackend::Escape(strFile, strEscaped, 8) != XN_STATUS_OK, "a path too long was cut short");
+	}
+
+	// The player going away and coming back: the next call connects again, and finds the video open again
+	{
+		pid_t nChild = StartMockPlayer();
+		CHECK(nChild > 0, "the mock player did not start");
+		SocketPlayerBackend player(TEST_SOCKET);
+		PlayerState state;
+		state.nReported = 0;
+		CHECK(player.Connect() == XN_STATUS_OK && player.OpenFile("clip\tone.mov") == XN_STATUS_OK &&
+			player.SetRepeat(true) == XN_STATUS_OK, "the mock player could not be opened");
+
+		StopPlayer(nChild);
+		CHECK(player.GetState(state) != XN_STATUS_OK, "a player that is gone answered");
+		nChild = StartMockPlayer();
+		CHECK(player.GetState(state) == XN_STATUS_OK && state.ePlayback == PLAYBACK_PLAY,
+			"the player back was not connected again, or the video not opened again");
+		StopPlayer(nChild);
+	}
+
+	// A reply too long fails its call, and the calls after it are answered on the same connection
+	{
+		pid_t nChild = StartLongLinePlayer();
+		CHECK(nChild > 0, "the player did not start");
+		SocketPlayerBackend player(TEST_SOCKET);
+		CHECK(player.Connect() == XN_STATUS_OK, "the player could not be reached");
+		CHECK(player.SetFullScreen(true) != XN_STATUS_OK, "a reply too long was taken");
+		CHECK(player.SetFullScreen(false) == XN_STATUS_OK, "the reply after one too long was lost");
+		CHECK(player.SetFullScreen(true) == XN_STATUS_OK, "the connection did not come back in step");
+		StopPlayer(nChild);
+	}
+
+	unlink(TEST_SOCKET);
+	printf(bPassed ? "Passed\n" : "Failed\n");
+	return bPassed ? 0 : 1;
+}
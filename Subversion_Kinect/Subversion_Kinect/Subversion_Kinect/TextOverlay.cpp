@@ -0,0 +1,437 @@
+#include "TextOverlay.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef USE_GLUT
+	// glh's text helpers take std::string unqualified
+	#include <string>
+	using std::string;
+	#include <glh/glh_glut_text.h>
+#endif
+
+// 96 cells of 20x22 pixels, 12 to a row, characters 32 to 127 in order.
+// Every glyph starts two pixels into its cell, its baseline 16 pixels down. The outermost pixels of every cell
+// stay blank, so filtering at the edge of a character's quad never picks up its neighbor in the atlas
+#define ATLAS_WIDTH 256
+#define ATLAS_HEIGHT 256
+#define CELL_WIDTH 20
+#define CELL_HEIGHT 22
+#define CELL_COLUMNS 12
+#define CELL_LEFT 2
+#define CELL_BASELINE 16
+#define FIRST_CHAR 32
+#define LAST_CHAR 126
+
+#ifdef USE_GLUT
+// Ascent and descent of the stroke font, in its units, over the 18 pixels of a line
+static const XnFloat fStrokeScale = 18/(119.05f + 33.33f);
+// Half the width of a stroke, in pixels
+static const XnFloat fStrokeRadius = 0.7f;
+
+// Add the segment from (fX0, fY0) to (fX1, fY1) to the atlas, anti-aliased by its distance to every pixel center.
+// Only inside the cell whose top left pixel is nCellX, nCellY, less its border
+static void RasterizeSegment(XnUChar* pAtlas, XnInt32 nCellX, XnInt32 nCellY, XnFloat fX0, XnFloat fY0, XnFloat fX1, XnFloat fY1)
+{
+	XnInt32 nLeft = (XnInt32)floor((fX0 < fX1 ? fX0 : fX1) - 2);
+	XnInt32 nRight = (XnInt32)ceil((fX0 > fX1 ? fX0 : fX1) + 2);
+	XnInt32 nTop = (XnInt32)floor((fY0 < fY1 ? fY0 : fY1) - 2);
+	XnInt32 nBottom = (XnInt32)ceil((fY0 > fY1 ? fY0 : fY1) + 2);
+	XnFloat fDX = fX1 - fX0;
+	XnFloat fDY = fY1 - fY0;
+	XnFloat fLength2 = fDX*fDX + fDY*fDY;
+
+	for (XnInt32 y = nTop; y <= nBottom; ++y)
+	{
+		for (XnInt32 x = nLeft; x <= nRight; ++x)
+		{
+			if (x <= nCellX || y <= nCellY || x >= nCellX + CELL_WIDTH - 1 || y >= nCellY + CELL_HEIGHT - 1)
+				continue;
+
+			// Nearest point of the segment to the pixel's center
+			XnFloat fPX = x + 0.5f - fX0;
+			XnFloat fPY = y + 0.5f - fY0;
+			XnFloat fT = fLength2 > 0 ? (fPX*fDX + fPY*fDY)/fLength2 : 0;
+			fT = fT < 0 ? 0 : (fT > 1 ? 1 : fT);
+			XnFloat fEX = fPX - fT*fDX;
+			XnFloat fEY = fPY - fT*fDY;
+
+			XnFloat fCoverage = fStrokeRadius + 0.5f - sqrt(fEX*fEX + fEY*fEY);
+			if (fCoverage <= 0)
+				continue;
+			XnUChar nValue = (XnUChar)(fCoverage >= 1 ? 255 : fCoverage*255);
+			XnUChar& nPixel = pAtlas[y*ATLAS_WIDTH + x];
+			if (nValue > nPixel)
+				nPixel = nValue;
+		}
+	}
+}
+
+// Draw each glyph of glh's stroke roman font in feedback mode, which hands back its segments instead of
+// drawing them, and rasterize them into the glyph's cell. Nothing reaches the framebuffer
+static XnBool BuildGlyphs(XnUChar* pAtlas, XnFloat* pAdvance)
+{
+	glh::glut_stroke_roman font;
+	// Builds the display lists and measures the glyphs, with color writes off
+	glMatrixMode(GL_MODELVIEW);
+	font.initialize();
+
+	// One pixel per unit of the font, with room around the glyphs so none of them is clipped
+	glPushAttrib(GL_VIEWPORT_BIT | GL_TRANSFORM_BIT);
+	glViewport(0, 0, 256, 256);
+	glMatrixMode(GL_PROJECTION);
+	glPushMatrix();
+	glLoadIdentity();
+	glOrtho(-64, 192, -64, 192, -1, 1);
+	glMatrixMode(GL_MODELVIEW);
+	glPushMatrix();
+
+	static GLfloat feedback[4096];
+	XnBool bComplete = true;
+	for (XnUInt32 nChar = FIRST_CHAR; nChar <= LAST_CHAR; ++nChar)
+	{
+		pAdvance[nChar] = font.get_width(nChar)*fStrokeScale;
+
+		glLoadIdentity();
+		glFeedbackBuffer(sizeof(feedback)/sizeof(feedback[0]), GL_2D, feedback);
+		glRenderMode(GL_FEEDBACK);
+		font.render(nChar);
+		GLint nValues = glRenderMode(GL_RENDER);
+		if (nValues < 0)
+		{
+			// Overflowed, the glyph is left blank
+			bComplete = false;
+			continue;
+		}
+
+		XnInt32 nCellX = (nChar - FIRST_CHAR) % CELL_COLUMNS*CELL_WIDTH;
+		XnInt32 nCellY = (nChar - FIRST_CHAR) / CELL_COLUMNS*CELL_HEIGHT;
+		XnFloat fLeft = (XnFloat)(nCellX + CELL_LEFT);
+		XnFloat fBaseline = (XnFloat)(nCellY + CELL_BASELINE);
+		for (GLint i = 0; i < nValues; )
+		{
+			GLint nToken = (GLint)feedback[i++];
+			switch (nToken)
+			{
+			case GL_LINE_TOKEN:
+			case GL_LINE_RESET_TOKEN:
+				// Window coordinates are font units off by the 64 around them. The atlas' rows go down
+				RasterizeSegment(pAtlas, nCellX, nCellY,
+					fLeft + (feedback[i] - 64)*fStrokeScale, fBaseline - (feedback[i + 1] - 64)*fStrokeScale,
+					fLeft + (feedback[i + 2] - 64)*fStrokeScale, fBaseline - (feedback[i + 3] - 64)*fStrokeScale);
+				i += 4;
+				break;
+			case GL_POLYGON_TOKEN:
+				i += 1 + 2*(GLint)feedback[i];
+				break;
+			case GL_POINT_TOKEN:
+			case GL_BITMAP_TOKEN:
+			case GL_DRAW_PIXEL_TOKEN:
+			case GL_COPY_PIXEL_TOKEN:
+				i += 2;
+				break;
+			default:
+				// GL_PASS_THROUGH_TOKEN
+				i += 1;
+				break;
+			}
+		}
+	}
+
+	glPopMatrix();
+	glMatrixMode(GL_PROJECTION);
+	glPopMatrix();
+	glPopAttrib();
+	return bComplete;
+}
+#else
+// Rows of 5 pixels, the leftmost in bit 4, top row first. Characters 32 to 126
+static const XnUChar Font5x7[95][7] =
+{
+	{0x00,0x00,0x00,0x00,0x00,0x00,0x00},	// ' '
+	{0x04,0x04,0x04,0x04,0x04,0x00,0x04},	// '!'
+	{0x0A,0x0A,0x0A,0x00,0x00,0x00,0x00},	// '"'
+	{0x0A,0x0A,0x1F,0x0A,0x1F,0x0A,0x0A},	// '#'
+	{0x04,0x0F,0x14,0x0E,0x05,0x1E,0x04},	// '$'
+	{0x18,0x19,0x02,0x04,0x08,0x13,0x03},	// '%'
+	{0x0C,0x12,0x14,0x08,0x15,0x12,0x0D},	// '&'
+	{0x04,0x04,0x08,0x00,0x00,0x00,0x00},	// '''
+	{0x02,0x04,0x08,0x08,0x08,0x04,0x02},	// '('
+	{0x08,0x04,0x02,0x02,0x02,0x04,0x08},	// ')'
+	{0x00,0x04,0x15,0x0E,0x15,0x04,0x00},	// '*'
+	{0x00,0x04,0x04,0x1F,0x04,0x04,0x00},	// '+'
+	{0x00,0x00,0x00,0x00,0x0C,0x04,0x08},	// ','
+	{0x00,0x00,0x00,0x1F,0x00,0x00,0x00},	// '-'
+	{0x00,0x00,0x00,0x00,0x00,0x0C,0x0C},	// '.'
+	{0x00,0x01,0x02,0x04,0x08,0x10,0x00},	// '/'
+	{0x0E,0x11,0x13,0x15,0x19,0x11,0x0E},	// '0'
+	{0x04,0x0C,0x04,0x04,0x04,0x04,0x0E},	// '1'
+	{0x0E,0x11,0x01,0x02,0x04,0x08,0x1F},	// '2'
+	{0x1F,0x02,0x04,0x02,0x01,0x11,0x0E},	// '3'
+	{0x02,0x06,0x0A,0x12,0x1F,0x02,0x02},	// '4'
+	{0x1F,0x10,0x1E,0x01,0x01,0x11,0x0E},	// '5'
+	{0x06,0x08,0x10,0x1E,0x11,0x11,0x0E},	// '6'
+	{0x1F,0x01,0x02,0x04,0x08,0x08,0x08},	// '7'
+	{0x0E,0x11,0x11,0x0E,0x11,0x11,0x0E},	// '8'
+	{0x0E,0x11,0x11,0x0F,0x01,0x02,0x0C},	// '9'
+	{0x00,0x0C,0x0C,0x00,0x0C,0x0C,0x00},	// ':'
+	{0x00,0x0C,0x0C,0x00,0x0C,0x04,0x08},	// ';'
+	{0x02,0x04,0x08,0x10,0x08,0x04,0x02},	// '<'
+	{0x00,0x00,0x1F,0x00,0x1F,0x00,0x00},	// '='
+	{0x08,0x04,0x02,0x01,0x02,0x04,0x08},	// '>'
+	{0x0E,0x11,0x01,0x02,0x04,0x00,0x04},	// '?'
+	{0x0E,0x11,0x01,0x0D,0x15,0x15,0x0E},	// '@'
+	{0x0E,0x11,0x11,0x1F,0x11,0x11,0x11},	// 'A'
+	{0x1E,0x11,0x11,0x1E,0x11,0x11,0x1E},	// 'B'
+	{0x0E,0x11,0x10,0x10,0x10,0x11,0x0E},	// 'C'
+	{0x1C,0x12,0x11,0x11,0x11,0x12,0x1C},	// 'D'
+	{0x1F,0x10,0x10,0x1E,0x10,0x10,0x1F},	// 'E'
+	{0x1F,0x10,0x10,0x1E,0x10,0x10,0x10},	// 'F'
+	{0x0E,0x11,0x10,0x17,0x11,0x11,0x0F},	// 'G'
+	{0x11,0x11,0x11,0x1F,0x11,0x11,0x11},	// 'H'
+	{0x0E,0x04,0x04,0x04,0x04,0x04,0x0E},	// 'I'
+	{0x07,0x02,0x02,0x02,0x02,0x12,0x0C},	// 'J'
+	{0x11,0x12,0x14,0x18,0x14,0x12,0x11},	// 'K'
+	{0x10,0x10,0x10,0x10,0x10,0x10,0x1F},	// 'L'
+	{0x11,0x1B,0x15,0x15,0x11,0x11,0x11},	// 'M'
+	{0x11,0x11,0x19,0x15,0x13,0x11,0x11},	// 'N'
+	{0x0E,0x11,0x11,0x11,0x11,0x11,0x0E},	// 'O'
+	{0x1E,0x11,0x11,0x1E,0x10,0x10,0x10},	// 'P'
+	{0x0E,0x11,0x11,0x11,0x15,0x12,0x0D},	// 'Q'
+	{0x1E,0x11,0x11,0x1E,0x14,0x12,0x11},	// 'R'
+	{0x0F,0x10,0x10,0x0E,0x01,0x01,0x1E},	// 'S'
+	{0x1F,0x04,0x04,0x04,0x04,0x04,0x04},	// 'T'
+	{0x11,0x11,0x11,0x11,0x11,0x11,0x0E},	// 'U'
+	{0x11,0x11,0x11,0x11,0x11,0x0A,0x04},	// 'V'
+	{0x11,0x11,0x11,0x15,0x15,0x15,0x0A},	// 'W'
+	{0x11,0x11,0x0A,0x04,0x0A,0x11,0x11},	// 'X'
+	{0x11,0x11,0x11,0x0A,0x04,0x04,0x04},	// 'Y'
+	{0x1F,0x01,0x02,0x04,0x08,0x10,0x1F},	// 'Z'
+	{0x0E,0x08,0x08,0x08,0x08,0x08,0x0E},	// '['
+	{0x00,0x10,0x08,0x04,0x02,0x01,0x00},	// '\\'
+	{0x0E,0x02,0x02,0x02,0x02,0x02,0x0E},	// ']'
+	{0x04,0x0A,0x11,0x00,0x00,0x00,0x00},	// '^'
+	{0x00,0x00,0x00,0x00,0x00,0x00,0x1F},	// '_'
+	{0x08,0x04,0x02,0x00,0x00,0x00,0x00},	// '`'
+	{0x00,0x00,0x0E,0x01,0x0F,0x11,0x0F},	// 'a'
+	{0x10,0x10,0x16,0x19,0x11,0x11,0x1E},	// 'b'
+	{0x00,0x00,0x0E,0x10,0x10,0x11,0x0E},	// 'c'
+	{0x01,0x01,0x0D,0x13,0x11,0x11,0x0F},	// 'd'
+	{0x00,0x00,0x0E,0x11,0x1F,0x10,0x0E},	// 'e'
+	{0x06,0x09,0x08,0x1C,0x08,0x08,0x08},	// 'f'
+	{0x00,0x0F,0x11,0x11,0x0F,0x01,0x0E},	// 'g'
+	{0x10,0x10,0x16,0x19,0x11,0x11,0x11},	// 'h'
+	{0x04,0x00,0x0C,0x04,0x04,0x04,0x0E},	// 'i'
+	{0x02,0x00,0x06,0x02,0x02,0x12,0x0C},	// 'j'
+	{0x10,0x10,0x12,0x14,0x18,0x14,0x12},	// 'k'
+	{0x0C,0x04,0x04,0x04,0x04,0x04,0x0E},	// 'l'
+	{0x00,0x00,0x1A,0x15,0x15,0x11,0x11},	// 'm'
+	{0x00,0x00,0x16,0x19,0x11,0x11,0x11},	// 'n'
+	{0x00,0x00,0x0E,0x11,0x11,0x11,0x0E},	// 'o'
+	{0x00,0x00,0x1E,0x11,0x1E,0x10,0x10},	// 'p'
+	{0x00,0x00,0x0D,0x13,0x0F,0x01,0x01},	// 'q'
+	{0x00,0x00,0x16,0x19,0x10,0x10,0x10},	// 'r'
+	{0x00,0x00,0x0E,0x10,0x0E,0x01,0x1E},	// 's'
+	{0x08,0x08,0x1C,0x08,0x08,0x09,0x06},	// 't'
+	{0x00,0x00,0x11,0x11,0x11,0x13,0x0D},	// 'u'
+	{0x00,0x00,0x11,0x11,0x11,0x0A,0x04},	// 'v'
+	{0x00,0x00,0x11,0x11,0x15,0x15,0x0A},	// 'w'
+	{0x00,0x00,0x11,0x0A,0x04,0x0A,0x11},	// 'x'
+	{0x00,0x00,0x11,0x11,0x0F,0x01,0x0E},	// 'y'
+	{0x00,0x00,0x1F,0x02,0x04,0x08,0x1F},	// 'z'
+	{0x02,0x04,0x04,0x08,0x04,0x04,0x02},	// '{'
+	{0x04,0x04,0x04,0x04,0x04,0x04,0x04},	// '|'
+	{0x08,0x04,0x04,0x02,0x04,0x04,0x08},	// '}'
+	{0x00,0x00,0x08,0x15,0x02,0x00,0x00},	// '~'
+};
+
+// The built-in font at twice its size: 10x14 glyphs, 12 pixels apart
+static XnBool BuildGlyphs(XnUChar* pAtlas, XnFloat* pAdvance)
+{
+	for (XnUInt32 nChar = FIRST_CHAR; nChar <= LAST_CHAR; ++nChar)
+	{
+		pAdvance[nChar] = 12;
+
+		XnUInt32 nCellX = (nChar - FIRST_CHAR) % CELL_COLUMNS*CELL_WIDTH + CELL_LEFT;
+		XnUInt32 nCellY = (nChar - FIRST_CHAR) / CELL_COLUMNS*CELL_HEIGHT + CELL_BASELINE - 14;
+		const XnUChar* pRows = Font5x7[nChar - FIRST_CHAR];
+		for (XnUInt32 y = 0; y < 14; ++y)
+		{
+			XnUChar* pPixel = pAtlas + (nCellY + y)*ATLAS_WIDTH + nCellX;
+			for (XnUInt32 x = 0; x < 10; ++x)
+			{
+				pPixel[x] = (pRows[y/2] >> (4 - x/2)) & 1 ? 255 : 0;
+			}
+		}
+	}
+	return true;
+}
+#endif
+
+TextOverlay::TextOverlay() :
+	m_bAtlasBuilt(false), m_nTexture(0), m_nLabels(0), m_nCapacity(MAX_LABELS), m_nPlacements(0), m_nQueued(0),
+	m_nDrawn(0), m_nLayouts(0)
+{
+	memset(m_fAdvance, 0, sizeof(m_fAdvance));
+	// All the labels there will be, unless more than MAX_LABELS are queued at once
+	m_pLabels = new Label[m_nCapacity];
+}
+
+// The texture is left to the GL context, which is usually gone by now
+TextOverlay::~TextOverlay()
+{
+	delete []m_pLabels;
+}
+
+XnUInt32 TextOverlay::GetLayouts() const
+{
+	return m_nLayouts;
+}
+
+XnBool TextOverlay::BuildAtlas()
+{
+	XnUChar* pAtlas = new XnUChar[ATLAS_WIDTH*ATLAS_HEIGHT];
+	memset(pAtlas, 0, ATLAS_WIDTH*ATLAS_HEIGHT);
+	XnBool bComplete = BuildGlyphs(pAtlas, m_fAdvance);
+
+	glGenTextures(1, &m_nTexture);
+	glBindTexture(GL_TEXTURE_2D, m_nTexture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	// Only coverage: the color comes from the current one
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, ATLAS_WIDTH, ATLAS_HEIGHT, 0, GL_ALPHA, GL_UNSIGNED_BYTE, pAtlas);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	delete []pAtlas;
+	m_bAtlasBuilt = true;
+	return bComplete;
+}
+
+void TextOverlay::Grow()
+{
+	Label* pLabels = new Label[m_nCapacity*2];
+	memcpy(pLabels, m_pLabels, m_nLabels*sizeof(Label));
+	delete []m_pLabels;
+	m_pLabels = pLabels;
+	m_nCapacity *= 2;
+	printf("More than %u labels queued at once, room made for %u\n", m_nCapacity/2, m_nCapacity);
+}
+
+XnUInt32 TextOverlay::GetLabel(const XnChar* strText)
+{
+	// The label not drawn for the longest, of those the queue does not still have to render
+	XnUInt32 nOldest = m_nLabels;
+	for (XnUInt32 i = 0; i < m_nLabels; ++i)
+	{
+		if (strncmp(m_pLabels[i].strText, strText, MAX_LABEL_LENGTH) == 0)
+			return i;
+		if (m_pLabels[i].nQueued == 0 && (nOldest == m_nLabels || m_pLabels[i].nLastDrawn < m_pLabels[nOldest].nLastDrawn))
+			nOldest = i;
+	}
+
+	// A new text: in a free label, or in place of the oldest one. If all of them are queued, with more room
+	if (m_nLabels == m_nCapacity && nOldest == m_nLabels)
+		Grow();
+	XnUInt32 nLabel = m_nLabels < m_nCapacity ? m_nLabels++ : nOldest;
+	Label& label = m_pLabels[nLabel];
+	label.nQueued = 0;
+	strncpy(label.strText, strText, MAX_LABEL_LENGTH);
+	label.strText[MAX_LABEL_LENGTH] = '\0';
+	m_nLayouts++;
+
+	// Relative to the start of the baseline, a quad of the glyph's whole cell per character
+	XnFloat fPen = 0;
+	Vertex* pVertex = label.Vertices;
+	for (const XnChar* pChar = label.strText; *pChar != '\0'; ++pChar)
+	{
+		XnUInt32 nChar = (XnUChar)*pChar;
+		if (nChar < FIRST_CHAR || nChar > LAST_CHAR)
+			nChar = '?';
+
+		GLfloat fX0 = fPen - CELL_LEFT;
+		GLfloat fX1 = fX0 + CELL_WIDTH;
+		GLfloat fY0 = -CELL_BASELINE;
+		GLfloat fY1 = fY0 + CELL_HEIGHT;
+		GLfloat fU0 = (GLfloat)((nChar - FIRST_CHAR) % CELL_COLUMNS*CELL_WIDTH)/ATLAS_WIDTH;
+		GLfloat fU1 = fU0 + (GLfloat)CELL_WIDTH/ATLAS_WIDTH;
+		GLfloat fV0 = (GLfloat)((nChar - FIRST_CHAR) / CELL_COLUMNS*CELL_HEIGHT)/ATLAS_HEIGHT;
+		GLfloat fV1 = fV0 + (GLfloat)CELL_HEIGHT/ATLAS_HEIGHT;
+
+		Vertex quad[4] = {{fX0, fY0, fU0, fV0}, {fX0, fY1, fU0, fV1}, {fX1, fY1, fU1, fV1}, {fX1, fY0, fU1, fV0}};
+		pVertex[0] = quad[0];
+		pVertex[1] = quad[1];
+		pVertex[2] = quad[2];
+		pVertex[3] = quad[0];
+		pVertex[4] = quad[2];
+		pVertex[5] = quad[3];
+		pVertex += 6;
+
+		fPen += m_fAdvance[nChar];
+	}
+	label.nVertices = (XnUInt32)(pVertex - label.Vertices);
+	return nLabel;
+}
+
+void TextOverlay::Draw(RenderQueue& queue, XnFloat fX, XnFloat fY, const XnChar* strText, GLfloat fRed, GLfloat fGreen, GLfloat fBlue)
+{
+	if (!m_bAtlasBuilt)
+	{
+		if (!BuildAtlas())
+			printf("Some glyphs could not be built, they are left blank\n");
+		// Building it went around the state cache
+		queue.GetState().Invalidate();
+	}
+
+	// The queue is full, and every placement still to be rendered
+	if (m_nQueued == MAX_RENDER_COMMANDS)
+		return;
+
+	XnUInt32 nLabel = GetLabel(strText);
+	m_pLabels[nLabel].nLastDrawn = ++m_nDrawn;
+	if (m_pLabels[nLabel].nVertices == 0)
+		return;
+
+	// At most MAX_RENDER_COMMANDS are queued, so the ring never reaches one still to be rendered
+	XnUInt32 nPlacement = m_nPlacements % MAX_RENDER_COMMANDS;
+	Placement& placement = m_Placements[nPlacement];
+	placement.nLabel = nLabel;
+	placement.fX = fX;
+	placement.fY = fY;
+	placement.Color[0] = fRed;
+	placement.Color[1] = fGreen;
+	placement.Color[2] = fBlue;
+	// All the labels share the atlas, they are sorted next to each other
+	if (!queue.Record(RenderQueue::LAYER_TEXT, m_nTexture, this, nPlacement))
+		return;
+	// Kept until rendered
+	m_nPlacements++;
+	m_pLabels[nLabel].nQueued++;
+	m_nQueued++;
+}
+
+void TextOverlay::Render(RenderState& state, XnUInt32 nParam)
+{
+	const Placement& placement = m_Placements[nParam];
+	Label& label = m_pLabels[placement.nLabel];
+	// Once rendered, the label may be replaced
+	label.nQueued--;
+	m_nQueued--;
+
+	state.UseTexture(GL_TEXTURE_2D, m_nTexture);
+	state.Enable(GL_BLEND);
+	state.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	state.EnableClientState(GL_VERTEX_ARRAY);
+	state.EnableClientState(GL_TEXTURE_COORD_ARRAY);
+	state.DisableClientState(GL_COLOR_ARRAY);
+	state.Color(placement.Color[0], placement.Color[1], placement.Color[2], 1);
+	state.MatrixMode(GL_MODELVIEW);
+
+	glPushMatrix();
+	glTranslatef(placement.fX, placement.fY, 0);
+	glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &label.Vertices[0].fX);
+	glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), &label.Vertices[0].fU);
+	glDrawArrays(GL_TRIANGLES, 0, label.nVertices);
+	glPopMatrix();
+	state.Count(6);
+}
@@ -0,0 +1,93 @@
+#ifndef TEXT_OVERLAY_H_
+#define TEXT_OVERLAY_H_
+
+#include <XnPlatform.h>
+#include "RenderQueue.h"
+
+#define MAX_LABELS 16
+#define MAX_LABEL_LENGTH 127
+
+/**
+ * Draws short labels from a glyph atlas: every printable ASCII character is rasterized once into one alpha
+ * texture, and every label is laid out once into a vertex array, kept as long as its text does not change.
+ * Drawing a label is one call, whatever its length, made when the render queue gets to it.
+ * With GLUT the glyphs are glh's stroke roman font, its outlines captured with feedback mode and rasterized here.
+ * GLES has no fonts, it gets a built-in 5x7 one.
+ * The last MAX_LABELS different texts are kept, the least recently drawn one makes room for a new one.
+ * A label queued and not rendered yet is never replaced: when every label is, there is room made for more.
+ * Every queue drawn into must be flushed, which renders what it holds.
+ */
+class TextOverlay : public Renderable
+{
+public:
+	TextOverlay();
+	~TextOverlay();
+
+	/**
+	 * Queue strText with the left end of its baseline at fX, fY, like glRasterPos, in the given color.
+	 * Only the first MAX_LABEL_LENGTH characters are drawn. The atlas is built on the first call
+	 */
+	void Draw(RenderQueue& queue, XnFloat fX, XnFloat fY, const XnChar* strText, GLfloat fRed, GLfloat fGreen, GLfloat fBlue);
+	virtual void Render(RenderState& state, XnUInt32 nParam);
+
+	/**
+	 * How many times a label had to be laid out, because its text was not among the kept ones
+	 */
+	XnUInt32 GetLayouts() const;
+protected:
+	typedef struct
+	{
+		GLfloat fX;
+		GLfloat fY;
+		GLfloat fU;
+		GLfloat fV;
+	} Vertex;
+
+	typedef struct
+	{
+		XnChar strText[MAX_LABEL_LENGTH + 1];
+		XnUInt32 nLastDrawn;
+		// Draws of it queued and not rendered yet
+		XnUInt32 nQueued;
+		XnUInt32 nVertices;
+		// Two triangles per character, GLES has no quads
+		Vertex Vertices[MAX_LABEL_LENGTH*6];
+	} Label;
+
+	// Where a label goes, in one of the draws queued
+	typedef struct
+	{
+		XnUInt32 nLabel;
+		GLfloat fX;
+		GLfloat fY;
+		GLfloat Color[3];
+	} Placement;
+
+	XnBool BuildAtlas();
+	/**
+	 * The label with strText, laid out if it is not kept already
+	 */
+	XnUInt32 GetLabel(const XnChar* strText);
+	/**
+	 * Double the room for labels, keeping the ones there
+	 */
+	void Grow();
+
+	XnBool m_bAtlasBuilt;
+	GLuint m_nTexture;
+	// How far the pen moves after each character, in pixels
+	XnFloat m_fAdvance[128];
+
+	Label* m_pLabels;
+	XnUInt32 m_nLabels;
+	XnUInt32 m_nCapacity;
+	// A ring, with room for every draw one queue can hold
+	Placement m_Placements[MAX_RENDER_COMMANDS];
+	XnUInt32 m_nPlacements;
+	// Draws queued and not rendered yet, all labels together
+	XnUInt32 m_nQueued;
+	XnUInt32 m_nDrawn;
+	XnUInt32 m_nLayouts;
+};
+
+#endif
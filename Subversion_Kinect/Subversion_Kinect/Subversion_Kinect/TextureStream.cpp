@@ -0,0 +1,274 @@
+#ifdef USE_GLUT
+	// This is the one file that carries glh's extension loader
+	#define GLH_EXT_SINGLE_FILE
+#endif
+#include "TextureStream.h"
+
+// Clean rows between two dirty spans that are uploaded anyway, since another call costs more than a few rows
+#define SPAN_GAP 4
+
+static XnUInt32 ClosestPowerOfTwo(XnUInt32 n)
+{
+	XnUInt32 m = 2;
+	while (m < n) m <<= 1;
+
+	return m;
+}
+
+TextureStream::TextureStream() :
+	m_bTight(false), m_bReallocate(true), m_nWidth(0), m_nHeight(0), m_nTexWidth(0), m_nTexHeight(0),
+	m_eFormat(0), m_nFrameSize(0), m_pBuffer(NULL), m_eUploadMode(UPLOAD_FULL), m_pDirtyRows(NULL), m_bUploadAll(true),
+	m_nUploadedBytes(0), m_nUploads(0), m_nFrames(0),
+#ifdef USE_GLUT
+	m_pTexture(&m_Texture2D), m_bPBOChecked(false), m_bUsePBO(false), m_nFill(0), m_bMapped(false)
+#else
+	m_nTexture(0)
+#endif
+{
+#ifdef USE_GLUT
+	m_PBOs[0] = m_PBOs[1] = 0;
+#endif
+}
+
+// The GL objects are left to the context, which is usually gone by now
+TextureStream::~TextureStream()
+{
+	delete []m_pBuffer;
+	delete []m_pDirtyRows;
+}
+
+void TextureStream::SetTight(XnBool bTight)
+{
+	m_bTight = bTight;
+	m_bReallocate = true;
+}
+XnBool TextureStream::IsTight() const
+{
+	return m_bTight;
+}
+
+XnBool TextureStream::IsUsingPBO() const
+{
+#ifdef USE_GLUT
+	return m_bUsePBO;
+#else
+	return false;
+#endif
+}
+
+void TextureStream::SetUploadMode(UploadMode eMode)
+{
+	m_eUploadMode = eMode;
+	// The client copy was not kept up to date while uploading through pixel buffer objects
+	m_bUploadAll = true;
+}
+TextureStream::UploadMode TextureStream::GetUploadMode() const
+{
+	return m_eUploadMode;
+}
+XnUChar* TextureStream::GetDirtyRows()
+{
+	return m_eUploadMode == UPLOAD_DIRTY_ROWS ? m_pDirtyRows : NULL;
+}
+
+XnDouble TextureStream::GetBytesPerFrame() const
+{
+	return m_nFrames == 0 ? 0 : (XnDouble)m_nUploadedBytes/m_nFrames;
+}
+XnDouble TextureStream::GetUploadsPerFrame() const
+{
+	return m_nFrames == 0 ? 0 : (XnDouble)m_nUploads/m_nFrames;
+}
+void TextureStream::ResetStats()
+{
+	m_nUploadedBytes = 0;
+	m_nUploads = 0;
+	m_nFrames = 0;
+}
+
+GLenum TextureStream::GetTarget() const
+{
+#ifdef USE_GLUT
+	return m_pTexture->target;
+#else
+	return GL_TEXTURE_2D;
+#endif
+}
+
+void TextureStream::Bind()
+{
+#ifdef USE_GLUT
+	m_pTexture->bind();
+#else
+	if (m_nTexture == 0)
+		glGenTextures(1, &m_nTexture);
+	glBindTexture(GL_TEXTURE_2D, m_nTexture);
+#endif
+}
+
+void TextureStream::Allocate(XnUInt32 nWidth, XnUInt32 nHeight, GLenum format)
+{
+	m_nWidth = nWidth;
+	m_nHeight = nHeight;
+	m_eFormat = format;
+	m_nFrameSize = nWidth*nHeight*(format == GL_LUMINANCE ? 1 : (format == GL_RGB ? 3 : 4));
+
+	delete []m_pBuffer;
+	m_pBuffer = new XnUChar[m_nFrameSize];
+	delete []m_pDirtyRows;
+	m_pDirtyRows = new XnUChar[nHeight];
+	m_bUploadAll = true;
+
+	m_nTexWidth = ClosestPowerOfTwo(nWidth);
+	m_nTexHeight = ClosestPowerOfTwo(nHeight);
+
+#ifdef USE_GLUT
+	if (!m_bPBOChecked)
+	{
+		// The entry points come with the vertex buffer extension, the unpack target with the pixel buffer one
+		m_bUsePBO = glh_init_extensions("GL_ARB_vertex_buffer_object") &&
+			glh_extension_supported("GL_ARB_pixel_buffer_object");
+		if (m_bUsePBO)
+			glGenBuffersARB(2, m_PBOs);
+		m_bPBOChecked = true;
+	}
+	if (m_bUsePBO)
+	{
+		for (XnUInt32 i = 0; i < 2; ++i)
+		{
+			glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, m_PBOs[i]);
+			glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, m_nFrameSize, NULL, GL_STREAM_DRAW_ARB);
+		}
+		glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+	}
+
+	m_pTexture = &m_Texture2D;
+#ifdef XN_TEXTURE_RECTANGLE
+	if (m_bTight && (glh_extension_supported("GL_ARB_texture_rectangle") ||
+		glh_extension_supported("GL_EXT_texture_rectangle") || glh_extension_supported("GL_NV_texture_rectangle")))
+	{
+		m_pTexture = &m_TextureRectangle;
+		m_nTexWidth = nWidth;
+		m_nTexHeight = nHeight;
+	}
+#endif
+#endif
+
+	// Storage only, the frames are uploaded into it
+	Bind();
+	glTexParameteri(GetTarget(), GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GetTarget(), GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexImage2D(GetTarget(), 0, format, m_nTexWidth, m_nTexHeight, 0, format, GL_UNSIGNED_BYTE, NULL);
+
+	m_bReallocate = false;
+}
+
+XnUChar* TextureStream::BeginFrame(XnUInt32 nWidth, XnUInt32 nHeight, GLenum format)
+{
+	if (m_bReallocate || nWidth != m_nWidth || nHeight != m_nHeight || format != m_eFormat)
+		Allocate(nWidth, nHeight, format);
+
+#ifdef USE_GLUT
+	if (m_bUsePBO && m_eUploadMode == UPLOAD_FULL)
+	{
+		// No orphaning: the buffer's storage is kept, and its last transfer was started two frames ago, so mapping
+		// it does not wait. The previous frame's buffer may still be in transfer while this one is filled
+		glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, m_PBOs[m_nFill]);
+		XnUChar* pMapped = (XnUChar*)glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
+		if (pMapped != NULL)
+		{
+			m_bMapped = true;
+			return pMapped;
+		}
+		glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+	}
+#endif
+
+	return m_pBuffer;
+}
+
+void TextureStream::Upload(XnUInt32 nFirstRow, XnUInt32 nRows, const XnUChar* pData)
+{
+	XnUInt32 nRowSize = m_nFrameSize/m_nHeight;
+	glTexSubImage2D(GetTarget(), 0, 0, nFirstRow, m_nWidth, nRows, m_eFormat, GL_UNSIGNED_BYTE, pData);
+	m_nUploadedBytes += nRows*nRowSize;
+	m_nUploads++;
+}
+
+void TextureStream::EndFrame()
+{
+	const GLvoid* pData = m_pBuffer;
+#ifdef USE_GLUT
+	if (m_bMapped)
+	{
+		glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB);
+		// Reading from the bound buffer, the data is an offset into it
+		pData = NULL;
+	}
+#endif
+
+	Bind();
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	m_nFrames++;
+
+	if (m_eUploadMode == UPLOAD_FULL || m_bUploadAll)
+	{
+		Upload(0, m_nHeight, (const XnUChar*)pData);
+		m_bUploadAll = false;
+	}
+	else
+	{
+		// Coalesce the dirty rows into spans, one upload each
+		XnUInt32 nRowSize = m_nFrameSize/m_nHeight;
+		XnUInt32 nRow = 0;
+		while (nRow < m_nHeight)
+		{
+			if (!m_pDirtyRows[nRow])
+			{
+				++nRow;
+				continue;
+			}
+
+			XnUInt32 nFirst = nRow, nLast = nRow;
+			for (++nRow; nRow < m_nHeight && nRow - nLast <= SPAN_GAP + 1; ++nRow)
+			{
+				if (m_pDirtyRows[nRow])
+					nLast = nRow;
+			}
+			Upload(nFirst, nLast - nFirst + 1, m_pBuffer + nFirst*nRowSize);
+			nRow = nLast + 1;
+		}
+	}
+
+#ifdef USE_GLUT
+	if (m_bMapped)
+	{
+		glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+		m_bMapped = false;
+		// The next frame is written to the other buffer while the transfer from this one goes on
+		m_nFill = 1 - m_nFill;
+	}
+#endif
+}
+
+void TextureStream::Enable(RenderState& state, XnFloat& fMaxS, XnFloat& fMaxT)
+{
+#ifdef USE_GLUT
+	state.UseTexture(GetTarget(), m_pTexture->texture);
+#else
+	state.UseTexture(GL_TEXTURE_2D, m_nTexture);
+#endif
+
+	// Rectangle textures are addressed in texels, the others in [0, 1]
+	if (GetTarget() == GL_TEXTURE_2D)
+	{
+		fMaxS = (XnFloat)m_nWidth/m_nTexWidth;
+		fMaxT = (XnFloat)m_nHeight/m_nTexHeight;
+	}
+	else
+	{
+		fMaxS = (XnFloat)m_nWidth;
+		fMaxT = (XnFloat)m_nHeight;
+	}
+}
+
@@ -0,0 +1,129 @@
+#ifndef TEXTURE_STREAM_H_
+#define TEXTURE_STREAM_H_
+
+#include <XnPlatform.h>
+#include "RenderState.h"
+
+#ifdef USE_GLUT
+	#include <glh_obs.h>
+	// glh only has tex_object_rectangle when the GL headers know one of the rectangle extensions
+	#if defined(GL_EXT_texture_rectangle) || defined(GL_NV_texture_rectangle)
+		#define XN_TEXTURE_RECTANGLE
+	#endif
+#elif defined(USE_GLES)
+	#include "opengles.h"
+#endif
+
+/**
+ * A texture the CPU refills every frame.
+ * Its storage is allocated once, then every frame only uploads the region in use, with glTexSubImage2D.
+ * Where pixel buffer objects exist, frames are written into two of them in turn, so filling
+ * a frame overlaps the transfer of the previous one.
+ */
+class TextureStream
+{
+public:
+	typedef enum
+	{
+		// Upload the whole frame every time
+		UPLOAD_FULL,
+		// Keep the last frame in client memory, and only upload the rows that changed
+		UPLOAD_DIRTY_ROWS
+	} UploadMode;
+
+	TextureStream();
+	~TextureStream();
+
+	/**
+	 * Size the texture to the frame rather than to the next powers of two, with a rectangle texture.
+	 * Without rectangle texture support it stays a power of two. Takes effect on the next frame
+	 */
+	void SetTight(XnBool bTight);
+	XnBool IsTight() const;
+	/**
+	 * Whether frames go through pixel buffer objects. Known once the first frame was started
+	 */
+	XnBool IsUsingPBO() const;
+
+	/**
+	 * Choose between full and dirty row uploads. Dirty rows come from client memory, never from pixel buffer objects
+	 */
+	void SetUploadMode(UploadMode eMode);
+	UploadMode GetUploadMode() const;
+	/**
+	 * In dirty row mode, one flag per row of the current frame, for whoever fills it to set to non-zero
+	 * when the row changed. NULL in full mode
+	 */
+	XnUChar* GetDirtyRows();
+
+	/**
+	 * Start a frame of nWidth x nHeight pixels, in GL_LUMINANCE, GL_RGB or GL_RGBA.
+	 * Returns where to write it, with rows packed back to back. In dirty row mode it still holds the previous frame.
+	 * The texture is reallocated when the size or the format changed.
+	 */
+	XnUChar* BeginFrame(XnUInt32 nWidth, XnUInt32 nHeight, GLenum format);
+	/**
+	 * Upload the frame started by BeginFrame
+	 */
+	void EndFrame();
+
+	/**
+	 * Bind and enable the texture for drawing, through the render state so nothing already set is set again.
+	 * fMaxS, fMaxT receive the texture coordinates of the far corner of the frame.
+	 * Binding it to upload goes around the render state, whose texture bindings must be forgotten after BeginFrame
+	 */
+	void Enable(RenderState& state, XnFloat& fMaxS, XnFloat& fMaxT);
+
+	/**
+	 * Average upload per frame since the last reset: bytes, and glTexSubImage2D calls
+	 */
+	XnDouble GetBytesPerFrame() const;
+	XnDouble GetUploadsPerFrame() const;
+	void ResetStats();
+protected:
+	void Allocate(XnUInt32 nWidth, XnUInt32 nHeight, GLenum format);
+	void Upload(XnUInt32 nFirstRow, XnUInt32 nRows, const XnUChar* pData);
+	void Bind();
+	GLenum GetTarget() const;
+
+	XnBool m_bTight;
+	XnBool m_bReallocate;
+
+	XnUInt32 m_nWidth;
+	XnUInt32 m_nHeight;
+	XnUInt32 m_nTexWidth;
+	XnUInt32 m_nTexHeight;
+	GLenum m_eFormat;
+	XnUInt32 m_nFrameSize;
+
+	// The frame when there are no pixel buffer objects, or mapping one failed
+	XnUChar* m_pBuffer;
+
+	UploadMode m_eUploadMode;
+	XnUChar* m_pDirtyRows;
+	// Set when the texture has nothing of the frame in it yet, so all of it has to go up
+	XnBool m_bUploadAll;
+
+	XnUInt64 m_nUploadedBytes;
+	XnUInt32 m_nUploads;
+	XnUInt32 m_nFrames;
+
+#ifdef USE_GLUT
+	glh::tex_object_2D m_Texture2D;
+#ifdef XN_TEXTURE_RECTANGLE
+	glh::tex_object_rectangle m_TextureRectangle;
+#endif
+	glh::tex_object* m_pTexture;
+
+	XnBool m_bPBOChecked;
+	XnBool m_bUsePBO;
+	GLuint m_PBOs[2];
+	// The buffer the current frame is written to, and whether it is mapped
+	XnUInt32 m_nFill;
+	XnBool m_bMapped;
+#else
+	GLuint m_nTexture;
+#endif
+};
+
+#endif
@@ -0,0 +1,121 @@
+#include "WorkerPool.h"
+#include <stdio.h>
+
+WorkerPool::WorkerPool() :
+	m_nWorkers(0), m_pFunc(NULL), m_pCookie(NULL), m_bStop(false), m_nPending(0)
+{
+	xnOSCreateCriticalSection(&m_hPendingLock);
+	xnOSCreateEvent(&m_hDone, false);
+}
+
+WorkerPool::~WorkerPool()
+{
+	StopWorkers();
+	xnOSCloseEvent(&m_hDone);
+	xnOSCloseCriticalSection(&m_hPendingLock);
+}
+
+XnUInt32 WorkerPool::GetThreadCount() const
+{
+	return m_nWorkers + 1;
+}
+
+XnStatus WorkerPool::SetThreadCount(XnUInt32 nThreads)
+{
+	if (nThreads < 1)
+		nThreads = 1;
+	if (nThreads > MAX_POOL_THREADS)
+		nThreads = MAX_POOL_THREADS;
+
+	StopWorkers();
+
+	for (XnUInt32 i = 0; i < nThreads - 1; ++i)
+	{
+		Worker& worker = m_Workers[i];
+		worker.pPool = this;
+		// Task 0 always runs on the calling thread
+		worker.nTask = i + 1;
+
+		XnStatus rc = xnOSCreateEvent(&worker.hStart, false);
+		if (rc == XN_STATUS_OK)
+		{
+			rc = xnOSCreateThread(WorkerThread, &worker, &worker.hThread);
+			if (rc != XN_STATUS_OK)
+				xnOSCloseEvent(&worker.hStart);
+		}
+		if (rc != XN_STATUS_OK)
+		{
+			printf("Worker thread creation failed: %s\n", xnGetStatusString(rc));
+			return rc;
+		}
+		m_nWorkers++;
+	}
+
+	return XN_STATUS_OK;
+}
+
+void WorkerPool::StopWorkers()
+{
+	m_bStop = true;
+	for (XnUInt32 i = 0; i < m_nWorkers; ++i)
+	{
+		xnOSSetEvent(m_Workers[i].hStart);
+	}
+	for (XnUInt32 i = 0; i < m_nWorkers; ++i)
+	{
+		xnOSWaitForThreadExit(m_Workers[i].hThread, XN_WAIT_INFINITE);
+		xnOSCloseThread(&m_Workers[i].hThread);
+		xnOSCloseEvent(&m_Workers[i].hStart);
+	}
+	m_nWorkers = 0;
+	m_bStop = false;
+}
+
+void WorkerPool::Run(TaskFunc pFunc, void* pCookie)
+{
+	XnUInt32 nTasks = m_nWorkers + 1;
+	if (m_nWorkers == 0)
+	{
+		pFunc(pCookie, 0, nTasks);
+		return;
+	}
+
+	m_pFunc = pFunc;
+	m_pCookie = pCookie;
+	m_nPending = m_nWorkers;
+	for (XnUInt32 i = 0; i < m_nWorkers; ++i)
+	{
+		xnOSSetEvent(m_Workers[i].hStart);
+	}
+
+	pFunc(pCookie, 0, nTasks);
+
+	xnOSWaitEvent(m_hDone, XN_WAIT_INFINITE);
+}
+
+void WorkerPool::WorkerLoop(XnUInt32 nWorker)
+{
+	Worker& worker = m_Workers[nWorker];
+	for (;;)
+	{
+		xnOSWaitEvent(worker.hStart, XN_WAIT_INFINITE);
+		if (m_bStop)
+			break;
+
+		m_pFunc(m_pCookie, worker.nTask, m_nWorkers + 1);
+
+		xnOSEnterCriticalSection(&m_hPendingLock);
+		XnBool bLast = (--m_nPending == 0);
+		xnOSLeaveCriticalSection(&m_hPendingLock);
+
+		if (bLast)
+			xnOSSetEvent(m_hDone);
+	}
+}
+
+XN_THREAD_PROC WorkerPool::WorkerThread(XN_THREAD_PARAM pParam)
+{
+	Worker* pWorker = (Worker*)pParam;
+	pWorker->pPool->WorkerLoop(pWorker->nTask - 1);
+	XN_THREAD_PROC_RETURN(XN_STATUS_OK);
+}
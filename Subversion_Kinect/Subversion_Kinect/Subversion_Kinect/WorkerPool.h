@@ -0,0 +1,60 @@
+#ifndef WORKER_POOL_H_
+#define WORKER_POOL_H_
+
+#include <XnOS.h>
+
+#define MAX_POOL_THREADS 16
+
+/**
+ * A set of persistent threads that split one job into tasks.
+ * The calling thread takes part in every job, so a pool of N threads
+ * keeps only N-1 workers of its own.
+ */
+class WorkerPool
+{
+public:
+	/**
+	 * A task of a job. Called once for every nTask in [0, nTasks), from any thread of the pool
+	 */
+	typedef void (*TaskFunc)(void* pCookie, XnUInt32 nTask, XnUInt32 nTasks);
+
+	WorkerPool();
+	~WorkerPool();
+
+	/**
+	 * Resize the pool. Running threads are stopped first.
+	 */
+	XnStatus SetThreadCount(XnUInt32 nThreads);
+	XnUInt32 GetThreadCount() const;
+
+	/**
+	 * Run one task per thread, and return when all of them are done.
+	 */
+	void Run(TaskFunc pFunc, void* pCookie);
+protected:
+	void StopWorkers();
+	void WorkerLoop(XnUInt32 nWorker);
+	static XN_THREAD_PROC WorkerThread(XN_THREAD_PARAM pParam);
+
+	typedef struct
+	{
+		WorkerPool* pPool;
+		XnUInt32 nTask;
+		XN_THREAD_HANDLE hThread;
+		XN_EVENT_HANDLE hStart;
+	} Worker;
+
+	Worker m_Workers[MAX_POOL_THREADS];
+	XnUInt32 m_nWorkers;
+
+	TaskFunc m_pFunc;
+	void* m_pCookie;
+	XnBool m_bStop;
+
+	// Workers still running the current job. The last one out signals m_hDone
+	XnUInt32 m_nPending;
+	XN_CRITICAL_SECTION_HANDLE m_hPendingLock;
+	XN_EVENT_HANDLE m_hDone;
+};
+
+#endif
@@ -0,0 +1,64 @@
+#include "ZoomStream.h"
+#include <math.h>
+
+ZoomStream::ZoomStream() :
+	m_nLastTick(0), m_fTarget(0), m_bNewTarget(false), m_bTracking(false), m_nStillTicks(0)
+{
+	SetRate(ZOOM_STREAM_RATE);
+}
+
+void ZoomStream::SetRate(XnFloat fHz)
+{
+	m_nPeriod = fHz <= 0 ? 0 : (XnUInt64)(1000000/fHz);
+}
+
+XnFloat ZoomStream::GetRate() const
+{
+	return m_nPeriod == 0 ? 0 : 1000000.0f/m_nPeriod;
+}
+
+void ZoomStream::SetTarget(XnDouble fZoom)
+{
+	m_fTarget = fZoom;
+	m_bNewTarget = true;
+}
+
+XnBool ZoomStream::IsActive() const
+{
+	return m_bNewTarget || m_bTracking;
+}
+
+XnUInt64 ZoomStream::GetNextTick() const
+{
+	return m_nLastTick + m_nPeriod;
+}
+
+XnBool ZoomStream::Tick(XnUInt64 nNow, XnDouble fCurrent, XnDouble& fZoom)
+{
+	m_nLastTick = nNow;
+	m_bNewTarget = false;
+
+	// Relative, as the hand moves the zoom by ratios
+	XnDouble fChange = fCurrent <= 0 ? 1 : fabs(m_fTarget/fCurrent - 1);
+	if (fChange >= (m_bTracking ? ZOOM_DEADBAND_TRACK : ZOOM_DEADBAND_START))
+	{
+		m_bTracking = true;
+		m_nStillTicks = 0;
+		fZoom = m_fTarget;
+		return true;
+	}
+
+	if (m_bTracking && ++m_nStillTicks >= ZOOM_SETTLE_TICKS)
+		m_bTracking = false;
+	return false;
+}
+
+XnDouble ZoomStream::ForHandDepth(XnFloat fZ, XnFloat fAnchorZ, XnDouble fAnchorZoom)
+{
+	XnDouble fZoom = fAnchorZoom*pow(2.0, (fAnchorZ - fZ)/ZOOM_DOUBLING_MM);
+	if (fZoom < ZOOM_MIN)
+		return ZOOM_MIN;
+	if (fZoom > ZOOM_MAX)
+		return ZOOM_MAX;
+	return fZoom;
+}
@@ -0,0 +1,67 @@
+#ifndef ZOOM_STREAM_H_
+#define ZOOM_STREAM_H_
+
+#include <XnOS.h>
+#include "PlayerBackend.h"
+
+// The most zooms streamed to the player a second
+#define ZOOM_STREAM_RATE 10.0f
+// How much a zoom at rest has to change before it is sent, and how much one on the move, as a fraction of the zoom
+#define ZOOM_DEADBAND_START 0.04
+#define ZOOM_DEADBAND_TRACK 0.01
+// Ticks within the tracking deadband after which the zoom is at rest again
+#define ZOOM_SETTLE_TICKS 3
+// How far the hand moves toward the sensor to double the zoom, in mm
+#define ZOOM_DOUBLING_MM 250.0f
+
+/**
+ * Follows a zoom that changes every sensor frame, the hand's, with as few commands to the player as will do:
+ * on a fixed tick, at most the rate allows, only the latest target is looked at, and it is only sent past a
+ * deadband. The deadband has hysteresis: a zoom at rest has to move by ZOOM_DEADBAND_START to start sending,
+ * after which it is followed to within ZOOM_DEADBAND_TRACK, until it stayed there for ZOOM_SETTLE_TICKS ticks.
+ * Times in us, on the high resolution clock. Not thread safe: the player dispatcher owns one, on its thread.
+ */
+class ZoomStream
+{
+public:
+	ZoomStream();
+
+	/**
+	 * The most ticks a second
+	 */
+	void SetRate(XnFloat fHz);
+	XnFloat GetRate() const;
+
+	/**
+	 * Where the zoom should be now, in percent. Replaces any target not looked at yet
+	 */
+	void SetTarget(XnDouble fZoom);
+	/**
+	 * Whether a tick has anything to look at: a new target, or a zoom still on the move
+	 */
+	XnBool IsActive() const;
+	/**
+	 * The earliest the next tick may come
+	 */
+	XnUInt64 GetNextTick() const;
+	/**
+	 * Tick at nNow, with the player at fCurrent. True when the target is to be sent, as fZoom
+	 */
+	XnBool Tick(XnUInt64 nNow, XnDouble fCurrent, XnDouble& fZoom);
+
+	/**
+	 * The zoom for a hand fZ mm from the sensor, when fAnchorZoom was set with the hand at fAnchorZ: every
+	 * ZOOM_DOUBLING_MM closer doubles it, every one farther halves it, within ZOOM_MIN and ZOOM_MAX
+	 */
+	static XnDouble ForHandDepth(XnFloat fZ, XnFloat fAnchorZ, XnDouble fAnchorZoom);
+
+protected:
+	XnUInt64 m_nPeriod;
+	XnUInt64 m_nLastTick;
+	XnDouble m_fTarget;
+	XnBool m_bNewTarget;
+	XnBool m_bTracking;
+	XnUInt32 m_nStillTicks;
+};
+
+#endif
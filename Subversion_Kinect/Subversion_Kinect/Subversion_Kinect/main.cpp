@@ -1,510 +1,775 @@
-//headers for OpenNI
-#include <XnOpenNI.h>
-#include <XnCppWrapper.h>
-#include <XnHash.h>
-#include <XnLog.h>
-
-//header for NITE
-#include <XnVNite.h>
-
-//local headers
-#include "PointDrawer.h"
-#include "stereoCommand.h" //COM Automation
-#include "vrpnClient.h" //VRPN Server/Client
-
-//instantiate new instance of COMMAND class as "command"
-COMMAND command;
-HRESULT hr;
-
-//Pointers to StereoPlayer control functions
-
-
-//headers for gesture recognition
-#include <XnVSwipeDetector.h>
-#include <XnVSteadyDetector.h>
-#include <XnVCircleDetector.h>
-#include <XnVWaveDetector.h>
-#include <XnVPushDetector.h>
-
-#define CHECK_RC(rc, what)											\
-	if (rc != XN_STATUS_OK)											\
-	{																\
-		printf("%s failed: %s\n", what, xnGetStatusString(rc));		\
-		return rc;													\
-	}																\
-
-#define CHECK_ERRORS(rc, errors, what)		\
-	if (rc == XN_STATUS_NO_NODE_PRESENT)	\
-	{										\
-		XnChar strError[1024];				\
-		errors.ToString(strError, 1024);	\
-		printf("%s\n", strError);			\
-		return (rc);						\
-	}
-
-#ifdef USE_GLUT
-	#if (XN_PLATFORM == XN_PLATFORM_MACOSX)
-		#include <GLUT/glut.h>
-	#else
-		#include <glut.h>
-	#endif
-#elif defined(USE_GLES)
-	#include "opengles.h"
-	#include "kbhit.h"
-#endif
-#include "signal_catch.h"
-
-#ifdef USE_GLES
-static EGLDisplay display = EGL_NO_DISPLAY;
-static EGLSurface surface = EGL_NO_SURFACE;
-static EGLContext context = EGL_NO_CONTEXT;
-#endif
-
-
-//creating the OpenNI objects that get used in the NITE application
-xn::Context g_Context;
-xn::ScriptNode g_ScriptNode;
-xn::DepthGenerator g_DepthGenerator;
-xn::HandsGenerator g_HandsGenerator;
-xn::GestureGenerator g_GestureGenerator;
-
-//NITE-specific objects
-XnVSessionManager* g_pSessionManager;
-XnVFlowRouter* g_pFlowRouter;
-
-//the OpenGL drawer
-XnVPointDrawer* g_pDrawer;
-
-//instantiating circle detector
-XnVCircleDetector* g_pCircle = NULL;
-
-//instantiating swipe detector
-XnVSwipeDetector* g_pSwipe = NULL;
-
-//steady detector
-XnVSteadyDetector* g_pSteady = NULL;
-
-//wave detector
-XnVWaveDetector* g_pWave = NULL;
-
-//push detector
-XnVPushDetector* g_pPush = NULL;
-
-#define GL_WIN_SIZE_X 720
-#define GL_WIN_SIZE_Y 480
-
-//Logic for deciding whether or not to render certain pieces
-XnBool g_bDrawDepthMap = true;
-XnBool g_bPrintFrameID = false;
-
-//use smoothing?
-XnFloat g_fSmoothing = 0.5f;
-XnBool g_bPause = false;
-XnBool g_bQuit = false;
-
-SessionState g_SessionState = NOT_IN_SESSION;
-
-void CleanupExit()
-{
-	g_ScriptNode.Release();
-	g_DepthGenerator.Release();
-	g_HandsGenerator.Release();
-	g_GestureGenerator.Release();
-	g_Context.Release();
-	command.EmergencyExit();
-
-	exit(1);
-}
-
-//this function gets called when the focus gesture is being performed
-void XN_CALLBACK_TYPE FocusProgress(const XnChar* strFocus, const XnPoint3D& ptPosition, XnFloat fProgress, void* UserCxt)
-{
-	//we won't print or do anything when the user is doing the focus gesturwe
-}
-
-//callback function for when the session begin
-void XN_CALLBACK_TYPE SessionStarting(const XnPoint3D& ptPosition, void* UserCxt)
-{
-	printf("Session start: (%f, %f, %f)\n",ptPosition.X, ptPosition.Y, ptPosition.Z);
-	g_SessionState = IN_SESSION;
-}
-
-//callback for the session getting teminated
-void XN_CALLBACK_TYPE SessionEnding(void* UserCxt)
-{
-	printf("Session end\n");
-	g_SessionState = NOT_IN_SESSION;
-}
-
-//this function gets called when the system detects that someone has removed their hands from the tracking area
-void XN_CALLBACK_TYPE NoHands(void * UserCxt)
-{
-	printf("Quick refocus state\n");
-	g_SessionState = QUICK_REFOCUS;
-}
-
-void XN_CALLBACK_TYPE TouchingCallback(xn::HandTouchingFOVEdgeCapability& generator, XnUserID id, const XnPoint3D* pPosition, XnFloat fTime, XnDirection eDir, void* pCookie)
-{
-	//printf("Hand at edge of FIELD OF VIEW\n");
-
-	g_pDrawer->SetTouchingFOVEdge(id);
-}
-
-//the glutDisplay loop gets called on every frame
-void glutDisplay (void)
-{
-
-	glClear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-	// Setup the OpenGL viewpoint
-	glMatrixMode(GL_PROJECTION);
-	glPushMatrix();
-	glLoadIdentity();
-
-	XnMapOutputMode mode;
-	g_DepthGenerator.GetMapOutputMode(mode);
-#ifdef USE_GLUT
-	glOrtho(0, mode.nXRes, mode.nYRes, 0, -1.0, 1.0);
-#elif defined(USE_GLES)
-	glOrthof(0, mode.nXRes, mode.nYRes, 0, -1.0, 1.0);
-#endif
-
-	glDisable(GL_TEXTURE_2D);
-
-	if (!g_bPause)
-	{
-		// Read next available data
-		g_Context.WaitOneUpdateAll(g_DepthGenerator);
-		// Update NITE tree
-		g_pSessionManager->Update(&g_Context);
-#ifdef USE_GLUT
-		PrintSessionState(g_SessionState);
-#endif
-	}
-
-#ifdef USE_GLUT
-	glutSwapBuffers();
-#endif
-}
-
-#ifdef USE_GLUT
-void glutIdle (void)
-{
-	if (g_bQuit) {
-		CleanupExit();
-	}
-
-	// Display the frame
-	glutPostRedisplay();
-}
-
-void glutKeyboard (unsigned char key, int x, int y)
-{
-	switch (key)
-	{
-	case 27:
-		// Exit
-		CleanupExit();
-	case'p':
-		// Toggle pause
-		g_bPause = !g_bPause;
-		break;
-	case 'd':
-		// Toggle drawing of the depth map
-		g_bDrawDepthMap = !g_bDrawDepthMap;
-		g_pDrawer->SetDepthMap(g_bDrawDepthMap);
-		break;
-	case 'f':
-		g_bPrintFrameID = !g_bPrintFrameID;
-		g_pDrawer->SetFrameID(g_bPrintFrameID);
-		break;
-	case 's':
-		// Toggle smoothing
-		if (g_fSmoothing == 0)
-			g_fSmoothing = 0.1;
-		else 
-			g_fSmoothing = 0;
-		g_HandsGenerator.SetSmoothing(g_fSmoothing);
-		break;
-	case 'e':
-		// end current session
-		g_pSessionManager->EndSession();
-		break;
-	}
-}
-void glInit (int * pargc, char ** argv)
-{
-	glutInit(pargc, argv);
-	glutInitDisplayMode(GLUT_RGB | GLUT_DOUBLE | GLUT_DEPTH);
-	glutInitWindowSize(GL_WIN_SIZE_X, GL_WIN_SIZE_Y);
-	glutCreateWindow ("PrimeSense Nite Point Viewer");
-	//glutFullScreen();
-	glutSetCursor(GLUT_CURSOR_NONE);
-
-	glutKeyboardFunc(glutKeyboard);
-	glutDisplayFunc(glutDisplay);
-	glutIdleFunc(glutIdle);
-
-	glDisable(GL_DEPTH_TEST);
-	glEnable(GL_TEXTURE_2D);
-
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glDisableClientState(GL_COLOR_ARRAY);
-}
-#endif
-
-
-void XN_CALLBACK_TYPE GestureIntermediateStageCompletedHandler(xn::GestureGenerator& generator, const XnChar* strGesture, const XnPoint3D* pPosition, void* pCookie)
-{
-	printf("Gesture %s: Intermediate stage complete (%f,%f,%f)\n", strGesture, pPosition->X, pPosition->Y, pPosition->Z);
-}
-
-void XN_CALLBACK_TYPE GestureReadyForNextIntermediateStageHandler(xn::GestureGenerator& generator, const XnChar* strGesture, const XnPoint3D* pPosition, void* pCookie)
-{
-	printf("Gesture %s: Ready for next intermediate stage (%f,%f,%f)\n", strGesture, pPosition->X, pPosition->Y, pPosition->Z);
-}
-
-void XN_CALLBACK_TYPE GestureProgressHandler(xn::GestureGenerator& generator, const XnChar* strGesture, const XnPoint3D* pPosition, XnFloat fProgress, void* pCookie)
-{
-	printf("Gesture %s progress: %f (%f,%f,%f)\n", strGesture, fProgress, pPosition->X, pPosition->Y, pPosition->Z);
-}
-
-void XN_CALLBACK_TYPE CircleCB(XnFloat fTimes, XnBool bConfident, const XnVCircle* pCircle, void* pUserCxt)
-{
-	printf("\nCircle Detected\n");
-	g_pCircle->Reset();
-	CleanupExit();
-}
-
-void XN_CALLBACK_TYPE NoCircleCB(XnFloat fLastValue, XnVCircleDetector::XnVNoCircleReason eReason, void* pUserCxt)
-{
-	//nothing goes here
-}
-
-void XN_CALLBACK_TYPE SwipeDownCB(XnFloat fVelocity, XnFloat fAngle, void* pUserCxt)
-{
-	
-	printf("\nSwipe Down\n");
-	command.SetZoomDecrement();
-
-}
-
-void XN_CALLBACK_TYPE SwipeUpCB(XnFloat fVelocity, XnFloat fAngle, void* pUserCxt)
-{
-	printf("\nSwipe Up\n");
-	command.SetZoomIncrement();
-}
-
-void XN_CALLBACK_TYPE SwipeLeftCB(XnFloat fVelocity, XnFloat fAngle, void* pUserCxt)
-{
-	printf("\n Left Swipe -- SWITCH FULLSCREEN STATE\n");
-	
-	hr = command.SwitchFullScreen();
-
-	if FAILED(hr)
-	{
-		std::cout << "COMMAND ERROR: " << format_error(hr) << endl;
-	}
-
-
-}
-
-void XN_CALLBACK_TYPE SwipeRightCB(XnFloat fVelocity, XnFloat fAngle, void* pUserCxt)
-{
-	printf("\nSwipe Right\n");
-
-	hr = command.togglePlay();
-
-	if FAILED(hr)
-	{
-		std::cout << "COMMAND ERROR: " << format_error(hr) << endl;
-	}
-
-}
-
-void XN_CALLBACK_TYPE WaveCB(void* pUserCxt)
-{
-	printf("\nWave Detected\n");
-}
-
-void XN_CALLBACK_TYPE PushCB(XnFloat fVelocity, XnFloat fAngle, void* UserCxt)
-{
-	printf("\nPush Detected\n");
-
-	hr = command.SetStop();
-
-	if FAILED(hr)
-	{
-		std::cout << "COMMAND ERROR: " << format_error(hr) << endl;
-	}
-
-
-}
-
-//sample XML code that will initialize the OpenNI interface
-#define SAMPLE_XML_PATH "Sample-Tracking.xml"
-
-
-
-int main(int argc, char ** argv)
-{
-	//error handling variables
-	XnStatus rc = XN_STATUS_OK;
-	xn::EnumerationErrors errors;
-
-
-
-	
-
-
-	//prepare the file to be opened by the computer
-	string filename = "C:\\Users\\Public\\Videos\\Pulmonary.mov";
-	cout << "File to Open: " << filename << endl;
-
-
-	//prepare left, right video file names
-	string LeftFile = "C:\\Users\\Public\\Videos\\IliacLeft.mov";
-	cout <<"---Left Video File: " << LeftFile << endl;
-	string RightFile = "C:\\Users\\Public\\Videos\\IliacRight.mov";
-	cout <<"---Right Video File: " << RightFile << endl;
-	int AudioMode = 2;
-	string AudioFile;
-	if (AudioFile.empty())
-	{
-		cout << "No audio file was indicated. Setting AudioMode to 0" << endl;
-		AudioMode = 0;
-	}
-
-	//create instance using COMMAND::CreateInstance
-	hr = command.CreateInstance();
-	if FAILED(hr)
-	{
-		cout << "Main - Failed to CreateInstance: " << format_error(hr) << endl;
-		goto error;
-	}
-
-	//open the file of interest using COMMAND::OpenFile() where the argument is the string of the filepath
-	hr = command.OpenFile(filename);
-
-	//hr = command.SetOpenLRFiles(LeftFile,RightFile,0);
-	if FAILED(hr)
-	{
-		//cout << "Main - Failed to Open File: " << format_error(hr) << endl;
-		cout << "Will now exit.  Press any key to continue..." << endl;
-		int temp;
-		cin >> temp;
-		CleanupExit();
-	}
-	
-	//Initialize the OpenNI interface to the Kinect Camera
-	rc = g_Context.InitFromXmlFile(SAMPLE_XML_PATH, g_ScriptNode,&errors);
-	CHECK_ERRORS(rc,errors,"InitFromXMLFile");
-	CHECK_RC(rc,"InitFromXMLFile");
-
-	rc=g_Context.FindExistingNode(XN_NODE_TYPE_DEPTH, g_DepthGenerator);
-	CHECK_RC(rc,"Find depth generator");
-
-	rc= g_Context.FindExistingNode(XN_NODE_TYPE_HANDS,g_HandsGenerator);
-	CHECK_RC(rc,"Find Hands Generator");
-
-	rc=g_Context.FindExistingNode(XN_NODE_TYPE_GESTURE,g_GestureGenerator);
-	CHECK_RC(rc,"Find Gesture Generator");
-
-	XnCallbackHandle h;
-
-	//if we've activating the sensor for knowing whether or not the hand is near the FOV edge, register the callback
-	if (g_HandsGenerator.IsCapabilitySupported(XN_CAPABILITY_HAND_TOUCHING_FOV_EDGE))
-	{
-		g_HandsGenerator.GetHandTouchingFOVEdgeCap().RegisterToHandTouchingFOVEdge(TouchingCallback, NULL,h);
-	}
-
-	XnCallbackHandle hGestureIntermediateStageCompleted, hGestureProgress, hGestureReadyForNextIntermediateStage;
-	g_GestureGenerator.RegisterToGestureIntermediateStageCompleted(GestureIntermediateStageCompletedHandler, NULL, hGestureIntermediateStageCompleted);
-	g_GestureGenerator.RegisterToGestureReadyForNextIntermediateStage(GestureReadyForNextIntermediateStageHandler, NULL, hGestureReadyForNextIntermediateStage);
-	g_GestureGenerator.RegisterGestureCallbacks(NULL, GestureProgressHandler, NULL, hGestureProgress);
-
-	//We already created OpenNI objects, now we need to Create NITE objects
-
-	g_pSessionManager = new XnVSessionManager;
-	rc = g_pSessionManager->Initialize(&g_Context,"Click,Wave","RaiseHand");
-	CHECK_RC(rc, "SessionManager Initialization");
-
-	g_pSessionManager->RegisterSession(NULL,SessionStarting,SessionEnding,FocusProgress);
-
-	g_pDrawer = new XnVPointDrawer(20, g_DepthGenerator);
-	g_pFlowRouter = new XnVFlowRouter;
-	g_pFlowRouter->SetActive(g_pDrawer);
-
-	//will now draw the circle on the hand
-	g_pSessionManager->AddListener(g_pFlowRouter);
-
-	//logic and registration for the circle detector
-	g_pCircle = new XnVCircleDetector;
-	g_pCircle->RegisterCircle(NULL,&CircleCB); //when circle is recognized, CircleCB will be called
-	g_pCircle->RegisterNoCircle(NULL,&NoCircleCB); //when circle stops being detector, NoCircleCB will be called
-	
-	//UNCOMMENT TO ENABLE THE CIRCLE DETECTOR
-	g_pSessionManager->AddListener(g_pCircle);
-
-	//logic and registration for the swipe detector and its 4 events
-	g_pSwipe = new XnVSwipeDetector;
-	g_pSwipe->SetSteadyDuration(500);
-	g_pSwipe->RegisterSwipeDown(NULL, &SwipeDownCB);
-	g_pSwipe->RegisterSwipeLeft(NULL, &SwipeLeftCB);
-	g_pSwipe->RegisterSwipeRight(NULL, &SwipeRightCB);
-	g_pSwipe->RegisterSwipeUp(NULL, &SwipeUpCB);
-
-	g_pSessionManager->AddListener(g_pSwipe);
-
-	//registration for wave detector
-	g_pWave = new XnVWaveDetector;
-	g_pWave->RegisterWave(NULL, &WaveCB);
-
-	g_pSessionManager->AddListener(g_pWave);
-
-	//register for the push detector
-	g_pPush = new XnVPushDetector;
-	g_pPush->RegisterPush(NULL, &PushCB);
-
-	g_pSessionManager->AddListener(g_pPush);
-
-	g_pDrawer->RegisterNoPoints(NULL, NoHands);
-	g_pDrawer->SetDepthMap(g_bDrawDepthMap);
-
-	rc = g_Context.StartGeneratingAll();
-	CHECK_RC(rc,"Start Generating");
-
-
-
-#ifdef USE_GLUT
-
-	glInit(&argc, argv);
-	glutMainLoop();
-
-#elif defined(USE_GLES)
-	if (!opengles_init(GL_WIN_SIZE_X, GL_WIN_SIZE_Y, &display, &surface, &context))
-	{
-		printf("Error initializing opengles\n");
-		CleanupExit();
-	}
-	glDisable(GL_DEPTH_TEST);
-	glEnable(GL_TEXTURE_2D);
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glDisableClientState(GL_COLOR_ARRAY);
-
-	while ((!_kbhit()) && (!g_bQuit))
-	{
-		glutDisplay();
-		eglSwapBuffers(display, surface);
-	}
-	opengles_shutdown(display, surface, context);
-
-	CleanupExit();
-#endif
-
-	cout << "Please press a key" << endl;
-	int temp;
-	cin >> temp;
-error:
-    return hr;
+//headers for OpenNI
+#include <XnOpenNI.h>
+#include <XnCppWrapper.h>
+#include <XnHash.h>
+#include <XnLog.h>
+
+//header for NITE
+#include <XnVNite.h>
+
+//local headers
+#include "PointDrawer.h"
+#include "HandFilterControl.h"
+#include "HandZoomControl.h"
+#include "FrameAcquirer.h"
+#include "NiteWorker.h"
+#include "FrameScheduler.h"
+#include "PlayerDispatcher.h"
+#include "SocketPlayerBackend.h"
+#if (XN_PLATFORM == XN_PLATFORM_WIN32)
+#include "stereoCommand.h" //COM Automation
+#include "vrpnClient.h" //VRPN Server/Client
+
+//instantiate new instance of COMMAND class as "command"
+COMMAND command;
+#else
+#include <iostream>
+#include <string>
+using namespace std;
+#endif
+
+//Pointers to StereoPlayer control functions
+
+
+//headers for gesture recognition
+#include <XnVSwipeDetector.h>
+#include <XnVSteadyDetector.h>
+#include <XnVCircleDetector.h>
+#include <XnVWaveDetector.h>
+#include <XnVPushDetector.h>
+
+#define CHECK_RC(rc, what)											\
+	if (rc != XN_STATUS_OK)											\
+	{																\
+		printf("%s failed: %s\n", what, xnGetStatusString(rc));		\
+		return rc;													\
+	}																\
+
+#define CHECK_ERRORS(rc, errors, what)		\
+	if (rc == XN_STATUS_NO_NODE_PRESENT)	\
+	{										\
+		XnChar strError[1024];				\
+		errors.ToString(strError, 1024);	\
+		printf("%s\n", strError);			\
+		return (rc);						\
+	}
+
+#ifdef USE_GLUT
+	#if (XN_PLATFORM == XN_PLATFORM_MACOSX)
+		#include <GLUT/glut.h>
+	#else
+		#include <glut.h>
+	#endif
+#elif defined(USE_GLES)
+	#include "opengles.h"
+	#include "kbhit.h"
+#endif
+#include "signal_catch.h"
+
+#ifdef USE_GLES
+static EGLDisplay display = EGL_NO_DISPLAY;
+static EGLSurface surface = EGL_NO_SURFACE;
+static EGLContext context = EGL_NO_CONTEXT;
+#endif
+
+
+//creating the OpenNI objects that get used in the NITE application
+xn::Context g_Context;
+xn::ScriptNode g_ScriptNode;
+xn::DepthGenerator g_DepthGenerator;
+xn::HandsGenerator g_HandsGenerator;
+xn::GestureGenerator g_GestureGenerator;
+
+//reads the sensor on its own thread, and hands the newest depth frame to the display
+FrameAcquirer g_Acquirer;
+
+//runs the session manager and the gesture detectors, once per acquired frame
+NiteWorker g_NiteWorker;
+
+//draws a frame only when something shown changed, at most at the rate cap
+FrameScheduler g_Scheduler;
+#define REFRESH_RATE 60
+#define MAX_FRAME_RATE 60
+//the GLES loop cannot be woken by the keyboard, it looks at it this often, in ms
+#define KEYBOARD_POLL_MS 100
+//how long the hands' cursor keeps moving after a sensor frame, in ms: one sample period
+#define CURSOR_ANIMATION_MS 34
+
+//player commands raised by the gestures on the NITE thread, sent from a thread of their own, which owns the player
+PlayerDispatcher g_PlayerDispatcher;
+PlayerBackend* g_pPlayer = NULL;
+//how often the player's state is read back into the dispatcher's mirror, in ms
+#define PLAYER_POLL_MS 250
+//what the overlay shows of the player, formatted on the player thread only when it changes
+typedef struct
+{
+	XnChar strText[PLAYER_LABEL_SIZE];
+} PlayerLabel;
+Snapshot<PlayerLabel> g_PlayerLabel;
+
+//NITE-specific objects
+XnVSessionManager* g_pSessionManager;
+XnVFlowRouter* g_pFlowRouter;
+// Smooths and predicts the hands for every control after it
+XnVHandFilter* g_pHandFilter;
+// The continuous zoom, the hand's depth streamed to the player instead of a step per swipe ('z')
+XnVHandZoom* g_pHandZoom;
+
+//the OpenGL drawer: 20 positions per hand, in projective coordinates, all the drawing needs
+typedef XnVFixedPointDrawer<20, HAND_LAYOUT_PROJECTIVE> PointDrawer;
+PointDrawer* g_pDrawer;
+
+//instantiating circle detector
+XnVCircleDetector* g_pCircle = NULL;
+
+//instantiating swipe detector
+XnVSwipeDetector* g_pSwipe = NULL;
+
+//steady detector
+XnVSteadyDetector* g_pSteady = NULL;
+
+//wave detector
+XnVWaveDetector* g_pWave = NULL;
+
+//push detector
+XnVPushDetector* g_pPush = NULL;
+
+#define GL_WIN_SIZE_X 720
+#define GL_WIN_SIZE_Y 480
+
+//Logic for deciding whether or not to render certain pieces
+XnBool g_bDrawDepthMap = true;
+//threads sharing the depth map colorization, 0 for one per core
+XnUInt32 g_nDepthThreads = 0;
+//interaction volume, in mm. Depth outside it is left out of the depth map when clipping is on
+XnBool g_bClipDepth = false;
+XnDepthPixel g_nNearClip = 800;
+XnDepthPixel g_nFarClip = 3500;
+//full, subsampled or cached depth histogram
+DepthColorizer::HistogramPolicy g_eHistogramPolicy = DepthColorizer::HISTOGRAM_FULL;
+//colors of the depth map
+DepthColorizer::Colormap g_eColormap = DepthColorizer::COLORMAP_EQUALIZED;
+//upload the whole depth map, or only its changed rows
+TextureStream::UploadMode g_eDepthUpload = TextureStream::UPLOAD_FULL;
+XnBool g_bPrintFrameID = false;
+//the draws of every frame, and the GL state they set
+RenderQueue g_RenderQueue;
+//set when the depth map's resolution changes, the projection is only set up again then
+volatile XnBool g_bProjectionChanged = true;
+
+//use smoothing?
+XnFloat g_fSmoothing = 0.5f;
+XnBool g_bPause = false;
+XnBool g_bQuit = false;
+
+//time spent drawing each frame, in us, reported on exit
+XnUInt64 g_nMaxFrameTime = 0;
+XnUInt64 g_nTotalFrameTime = 0;
+XnUInt32 g_nFrames = 0;
+
+SessionState g_SessionState = NOT_IN_SESSION;
+
+//what the frames, the NITE updates and the player took while the viewer ran
+void PrintStats()
+{
+	printf("Frame time: %.2f ms average, %.2f ms worst over %u frames\n",
+		g_nFrames == 0 ? 0 : g_nTotalFrameTime/1000.0/g_nFrames, g_nMaxFrameTime/1000.0, g_nFrames);
+	printf("Frames: %u produced, %u consumed, %u dropped\n",
+		g_Acquirer.GetProducedCount(), g_Acquirer.GetConsumedCount(), g_Acquirer.GetDroppedCount());
+	printf("NITE: %u updates, %u frames coalesced, %.2f ms worst update\n",
+		g_NiteWorker.GetUpdateCount(), g_NiteWorker.GetCoalescedCount(), g_NiteWorker.GetMaxUpdateMs());
+	g_Scheduler.PrintStats();
+	g_PlayerDispatcher.PrintStats();
+}
+
+void CleanupExit()
+{
+	if (g_nFrames > 0)
+		PrintStats();
+
+	g_Acquirer.Stop();
+	g_NiteWorker.Stop();
+	g_ScriptNode.Release();
+	g_DepthGenerator.Release();
+	g_HandsGenerator.Release();
+	g_GestureGenerator.Release();
+	g_Context.Release();
+	// Closes the player
+	g_PlayerDispatcher.Stop();
+
+	exit(1);
+}
+
+//this function gets called when the focus gesture is being performed
+void XN_CALLBACK_TYPE FocusProgress(const XnChar* strFocus, const XnPoint3D& ptPosition, XnFloat fProgress, void* UserCxt)
+{
+	//we won't print or do anything when the user is doing the focus gesturwe
+}
+
+//callback function for when the session begin
+void XN_CALLBACK_TYPE SessionStarting(const XnPoint3D& ptPosition, void* UserCxt)
+{
+	printf("Session start: (%f, %f, %f)\n",ptPosition.X, ptPosition.Y, ptPosition.Z);
+	g_SessionState = IN_SESSION;
+	g_Scheduler.NotifyChange();
+}
+
+//callback for the session getting teminated
+void XN_CALLBACK_TYPE SessionEnding(void* UserCxt)
+{
+	printf("Session end\n");
+	g_SessionState = NOT_IN_SESSION;
+	g_Scheduler.NotifyChange();
+}
+
+//this function gets called when the system detects that someone has removed their hands from the tracking area
+void XN_CALLBACK_TYPE NoHands(void * UserCxt)
+{
+	printf("Quick refocus state\n");
+	g_SessionState = QUICK_REFOCUS;
+	g_Scheduler.NotifyChange();
+}
+
+void XN_CALLBACK_TYPE TouchingCallback(xn::HandTouchingFOVEdgeCapability& generator, XnUserID id, const XnPoint3D* pPosition, XnFloat fTime, XnDirection eDir, void* pCookie)
+{
+	//printf("Hand at edge of FIELD OF VIEW\n");
+
+	g_pDrawer->SetTouchingFOVEdge(id, eDir);
+}
+
+//the depth map's resolution changed, the projection has to follow it
+void XN_CALLBACK_TYPE MapOutputModeChanged(xn::ProductionNode& node, void* pCookie)
+{
+	g_bProjectionChanged = true;
+	g_Scheduler.NotifyChange();
+}
+
+//a NITE update is done: the frame it ran on and the hands it found can be drawn
+void OnNiteUpdate(void* pCookie)
+{
+	g_Scheduler.NotifyFrame();
+}
+
+//on the player thread, whenever its mirror of the player changed: redraw if what the overlay shows did
+void OnPlayerState(void* pCookie)
+{
+	static PlayerLabel label = {""};
+	PlayerState state;
+	g_PlayerDispatcher.GetPlayerState(state);
+	if (FormatPlayerState(state, label.strText, sizeof(label.strText)))
+	{
+		g_PlayerLabel.Publish(label);
+		g_Scheduler.NotifyChange();
+	}
+}
+
+//the glutDisplay loop gets called on every frame
+void glutDisplay (void)
+{
+	XnUInt64 nFrameStart;
+	xnOSGetHighResTimeStamp(&nFrameStart);
+
+	g_RenderQueue.BeginFrame();
+	RenderState& state = g_RenderQueue.GetState();
+
+	glClear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	state.Count();
+
+	// Setup the OpenGL viewpoint, when the depth map's resolution changed. It stays loaded in between
+	if (g_bProjectionChanged)
+	{
+		g_bProjectionChanged = false;
+		XnMapOutputMode mode;
+		g_DepthGenerator.GetMapOutputMode(mode);
+
+		state.MatrixMode(GL_PROJECTION);
+		glLoadIdentity();
+#ifdef USE_GLUT
+		glOrtho(0, mode.nXRes, mode.nYRes, 0, -1.0, 1.0);
+#elif defined(USE_GLES)
+		glOrthof(0, mode.nXRes, mode.nYRes, 0, -1.0, 1.0);
+#endif
+		state.Count(3);
+		state.MatrixMode(GL_MODELVIEW);
+	}
+
+	if (!g_bPause)
+	{
+		// Take the newest frame, if any arrived. Never waits for the sensor, nor for NITE
+		XnBool bNewFrame;
+		const DepthFrame* pFrame = g_Acquirer.GetLatestFrame(bNewFrame);
+		g_pDrawer->DrawFrame(g_RenderQueue, pFrame, bNewFrame);
+		PrintSessionState(g_RenderQueue, g_SessionState);
+
+		PlayerLabel label;
+		g_PlayerLabel.Read(label);
+		PrintPlayerState(g_RenderQueue, label.strText);
+
+		// The hands' cursor moves between the sensor's frames, unless it only shows the newest sample
+		if (g_SessionState == IN_SESSION && g_pDrawer->GetHandCursor().GetMode() != HandCursor::CURSOR_LATEST)
+			g_Scheduler.Animate(CURSOR_ANIMATION_MS);
+	}
+	else
+	{
+		// Hold the last frame
+		g_pDrawer->DrawFrame(g_RenderQueue, g_Acquirer.GetCurrentFrame(), false);
+	}
+	// Everything recorded above, grouped by the state it needs
+	g_RenderQueue.Flush();
+
+	XnUInt64 nFrameEnd;
+	xnOSGetHighResTimeStamp(&nFrameEnd);
+	if (nFrameEnd - nFrameStart > g_nMaxFrameTime)
+		g_nMaxFrameTime = nFrameEnd - nFrameStart;
+	g_nTotalFrameTime += nFrameEnd - nFrameStart;
+	g_nFrames++;
+
+#ifdef USE_GLUT
+	glutSwapBuffers();
+#endif
+}
+
+//whether a frame should be drawn now, and how long the main loop can sleep until it has to look again, in ms
+XnUInt32 ScheduleFrame(XnBool& bDraw)
+{
+	// New frames only change the picture when the depth map, the hands or the frame ID are shown
+	g_Scheduler.SetFollowingFrames(g_bDrawDepthMap || g_bPrintFrameID || g_SessionState != NOT_IN_SESSION);
+	g_Scheduler.SetPaused(g_bPause);
+	return g_Scheduler.Tick(bDraw);
+}
+
+#ifdef USE_GLUT
+//the timer armed last. Older ones still pending are stale, and do nothing
+int g_nTick = 0;
+
+void glutTick (int nTick)
+{
+	if (nTick != g_nTick)
+		return;
+
+	if (g_bQuit) {
+		CleanupExit();
+	}
+
+	// Display a frame, if anything changed, and sleep until something can have
+	XnBool bDraw;
+	XnUInt32 nSleep = ScheduleFrame(bDraw);
+	if (bDraw)
+		glutPostRedisplay();
+	g_nTick++;
+	// Polled, the scheduler always sets a time to look again, so a quit while paused is still seen
+	glutTimerFunc(nSleep, glutTick, g_nTick);
+}
+
+void glutKeyboard (unsigned char key, int x, int y)
+{
+	switch (key)
+	{
+	case 27:
+		// Exit
+		CleanupExit();
+	case'p':
+		// Toggle pause
+		g_bPause = !g_bPause;
+		g_NiteWorker.SetPaused(g_bPause);
+		break;
+	case 'd':
+		// Toggle drawing of the depth map
+		g_bDrawDepthMap = !g_bDrawDepthMap;
+		g_pDrawer->SetDepthMap(g_bDrawDepthMap);
+		break;
+	case 'f':
+		g_bPrintFrameID = !g_bPrintFrameID;
+		g_pDrawer->SetFrameID(g_bPrintFrameID);
+		break;
+	case 's':
+		// Toggle smoothing
+		if (g_fSmoothing == 0)
+			g_fSmoothing = 0.1;
+		else 
+			g_fSmoothing = 0;
+		g_HandsGenerator.SetSmoothing(g_fSmoothing);
+		break;
+	case 'e':
+		// end current session
+		g_NiteWorker.RequestEndSession();
+		break;
+	case 'z':
+		// Switch between zooming a step per swipe and zooming with the hand's distance
+		g_pHandZoom->SetEnabled(!g_pHandZoom->IsEnabled());
+		printf("Zoom: %s\n", g_pHandZoom->IsEnabled() ? "continuous, move the hand closer to zoom in" : "a step per swipe");
+		break;
+	}
+
+	// Show what the key changed, and sleep again from there
+	g_Scheduler.NotifyInput();
+	glutTick(++g_nTick);
+}
+void glInit (int * pargc, char ** argv)
+{
+	glutInit(pargc, argv);
+	glutInitDisplayMode(GLUT_RGB | GLUT_DOUBLE | GLUT_DEPTH);
+	glutInitWindowSize(GL_WIN_SIZE_X, GL_WIN_SIZE_Y);
+	glutCreateWindow ("PrimeSense Nite Point Viewer");
+	//glutFullScreen();
+	glutSetCursor(GLUT_CURSOR_NONE);
+
+	glutKeyboardFunc(glutKeyboard);
+	glutDisplayFunc(glutDisplay);
+	// No idle callback: GLUT sleeps between the scheduler's timers, which other threads cannot wake
+	g_Scheduler.SetPolled(true);
+	glutTimerFunc(0, glutTick, g_nTick);
+
+	glDisable(GL_DEPTH_TEST);
+	glEnable(GL_TEXTURE_2D);
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glDisableClientState(GL_COLOR_ARRAY);
+}
+#endif
+
+
+void XN_CALLBACK_TYPE GestureIntermediateStageCompletedHandler(xn::GestureGenerator& generator, const XnChar* strGesture, const XnPoint3D* pPosition, void* pCookie)
+{
+	printf("Gesture %s: Intermediate stage complete (%f,%f,%f)\n", strGesture, pPosition->X, pPosition->Y, pPosition->Z);
+}
+
+void XN_CALLBACK_TYPE GestureReadyForNextIntermediateStageHandler(xn::GestureGenerator& generator, const XnChar* strGesture, const XnPoint3D* pPosition, void* pCookie)
+{
+	printf("Gesture %s: Ready for next intermediate stage (%f,%f,%f)\n", strGesture, pPosition->X, pPosition->Y, pPosition->Z);
+}
+
+void XN_CALLBACK_TYPE GestureProgressHandler(xn::GestureGenerator& generator, const XnChar* strGesture, const XnPoint3D* pPosition, XnFloat fProgress, void* pCookie)
+{
+	printf("Gesture %s progress: %f (%f,%f,%f)\n", strGesture, fProgress, pPosition->X, pPosition->Y, pPosition->Z);
+}
+
+void XN_CALLBACK_TYPE CircleCB(XnFloat fTimes, XnBool bConfident, const XnVCircle* pCircle, void* pUserCxt)
+{
+	printf("\nCircle Detected\n");
+	g_pCircle->Reset();
+	// Called from the NITE update, with the context locked. The acquisition thread can only be stopped outside of it
+	g_bQuit = true;
+	g_Scheduler.NotifyChange();
+}
+
+void XN_CALLBACK_TYPE NoCircleCB(XnFloat fLastValue, XnVCircleDetector::XnVNoCircleReason eReason, void* pUserCxt)
+{
+	//nothing goes here
+}
+
+//a hand at the edge of the view loses tracking quality, and a swipe towards that edge is usually
+//the hand leaving the view rather than a gesture. Such swipes are dropped
+XnBool SwipeIntoFOVEdge(XnDirection eSwipe)
+{
+	if (g_pDrawer->GetPrimaryFOVEdge() != eSwipe)
+		return false;
+
+	printf("\nSwipe into the edge of the field of view ignored\n");
+	return true;
+}
+
+//the hand moving up and down while it zooms is no zoom step
+XnBool SwipeWhileHandZooms()
+{
+	if (!g_pHandZoom->IsEnabled())
+		return false;
+
+	printf("\nSwipe ignored, the zoom follows the hand\n");
+	return true;
+}
+
+void XN_CALLBACK_TYPE SwipeDownCB(XnFloat fVelocity, XnFloat fAngle, void* pUserCxt)
+{
+	if (SwipeIntoFOVEdge(XN_DIRECTION_DOWN) || SwipeWhileHandZooms())
+		return;
+	PlayerState player;
+	g_PlayerDispatcher.GetPlayerState(player);
+	printf("\nSwipe Down -- ZOOM OUT from %.0f%%\n", player.fZoom);
+	g_PlayerDispatcher.Push(PLAYER_ZOOM_OUT);
+
+}
+
+void XN_CALLBACK_TYPE SwipeUpCB(XnFloat fVelocity, XnFloat fAngle, void* pUserCxt)
+{
+	if (SwipeIntoFOVEdge(XN_DIRECTION_UP) || SwipeWhileHandZooms())
+		return;
+	PlayerState player;
+	g_PlayerDispatcher.GetPlayerState(player);
+	printf("\nSwipe Up -- ZOOM IN from %.0f%%\n", player.fZoom);
+	g_PlayerDispatcher.Push(PLAYER_ZOOM_IN);
+}
+
+void XN_CALLBACK_TYPE SwipeLeftCB(XnFloat fVelocity, XnFloat fAngle, void* pUserCxt)
+{
+	if (SwipeIntoFOVEdge(XN_DIRECTION_LEFT))
+		return;
+	PlayerState player;
+	g_PlayerDispatcher.GetPlayerState(player);
+	printf("\n Left Swipe -- SWITCH FULLSCREEN STATE to %s\n", player.bFullScreen ? "window" : "full screen");
+	
+	g_PlayerDispatcher.Push(PLAYER_SWITCH_FULLSCREEN);
+}
+
+void XN_CALLBACK_TYPE SwipeRightCB(XnFloat fVelocity, XnFloat fAngle, void* pUserCxt)
+{
+	if (SwipeIntoFOVEdge(XN_DIRECTION_RIGHT))
+		return;
+	//what the player is doing now, without asking it
+	PlayerState player;
+	g_PlayerDispatcher.GetPlayerState(player);
+	printf("\nSwipe Right -- %s\n", player.ePlayback == PLAYBACK_PLAY ? "PAUSE" : "PLAY");
+
+	g_PlayerDispatcher.Push(PLAYER_TOGGLE_PLAY);
+}
+
+void XN_CALLBACK_TYPE WaveCB(void* pUserCxt)
+{
+	printf("\nWave Detected\n");
+}
+
+void XN_CALLBACK_TYPE PushCB(XnFloat fVelocity, XnFloat fAngle, void* UserCxt)
+{
+	//zooming in is the hand moving toward the sensor, which is no stop
+	if (g_pHandZoom->IsEnabled())
+	{
+		printf("\nPush ignored, the zoom follows the hand\n");
+		return;
+	}
+	printf("\nPush Detected\n");
+
+	g_PlayerDispatcher.Push(PLAYER_STOP);
+}
+
+//sample XML code that will initialize the OpenNI interface
+#define SAMPLE_XML_PATH "Sample-Tracking.xml"
+
+
+
+int main(int argc, char ** argv)
+{
+	//error handling variables
+	XnStatus rc = XN_STATUS_OK;
+	xn::EnumerationErrors errors;
+
+#if (XN_PLATFORM == XN_PLATFORM_WIN32)
+	//offline: the cost of a player command looked up by name against one through the resolved table
+	if (argc > 1 && strcmp(argv[1], "--benchmark-commands") == 0)
+	{
+		return FAILED(StereoCommandTable::benchmark(argc > 2 ? atoi(argv[2]) : 1000)) ? 1 : 0;
+	}
+#endif
+	//--player-socket <path>: the player behind a Unix socket, even where StereoPlayer is there.
+	//--record-hands <file>: the hands as NITE reports them, for the filter evaluation
+	const XnChar* strPlayerSocket = NULL;
+	const XnChar* strRecordHands = NULL;
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "--player-socket") == 0)
+			strPlayerSocket = argv[i + 1];
+		else if (strcmp(argv[i], "--record-hands") == 0)
+			strRecordHands = argv[i + 1];
+	}
+
+	//prepare the file to be opened by the computer
+	string filename = "C:\\Users\\Public\\Videos\\Pulmonary.mov";
+	cout << "File to Open: " << filename << endl;
+
+
+	//prepare left, right video file names
+	string LeftFile = "C:\\Users\\Public\\Videos\\IliacLeft.mov";
+	cout <<"---Left Video File: " << LeftFile << endl;
+	string RightFile = "C:\\Users\\Public\\Videos\\IliacRight.mov";
+	cout <<"---Right Video File: " << RightFile << endl;
+	int AudioMode = 2;
+	string AudioFile;
+	if (AudioFile.empty())
+	{
+		cout << "No audio file was indicated. Setting AudioMode to 0" << endl;
+		AudioMode = 0;
+	}
+
+	//start the player and open the file on the player thread, which sends it every command from then on.
+	//StereoPlayer, or a player behind a Unix socket when asked for, or when there is no COM
+#if (XN_PLATFORM == XN_PLATFORM_WIN32)
+	if (strPlayerSocket != NULL)
+		g_pPlayer = new SocketPlayerBackend(strPlayerSocket);
+	else
+		g_pPlayer = new StereoPlayerBackend(command);
+#else
+	g_pPlayer = new SocketPlayerBackend(strPlayerSocket != NULL ? strPlayerSocket : PLAYER_SOCKET);
+#endif
+	g_PlayerDispatcher.SetPollInterval(PLAYER_POLL_MS);
+	g_PlayerDispatcher.SetStateHandler(OnPlayerState, NULL);
+	rc = g_PlayerDispatcher.Start(g_pPlayer, filename.c_str());
+
+	//hr = command.SetOpenLRFiles(LeftFile,RightFile,0);
+	if (rc != XN_STATUS_OK)
+	{
+		cout << "Will now exit.  Press any key to continue..." << endl;
+		int temp;
+		cin >> temp;
+		CleanupExit();
+	}
+	
+	//Initialize the OpenNI interface to the Kinect Camera
+	rc = g_Context.InitFromXmlFile(SAMPLE_XML_PATH, g_ScriptNode,&errors);
+	CHECK_ERRORS(rc,errors,"InitFromXMLFile");
+	CHECK_RC(rc,"InitFromXMLFile");
+
+	rc=g_Context.FindExistingNode(XN_NODE_TYPE_DEPTH, g_DepthGenerator);
+	CHECK_RC(rc,"Find depth generator");
+	XnCallbackHandle hModeChange;
+	g_DepthGenerator.RegisterToMapOutputModeChange(MapOutputModeChanged, NULL, hModeChange);
+
+	rc= g_Context.FindExistingNode(XN_NODE_TYPE_HANDS,g_HandsGenerator);
+	CHECK_RC(rc,"Find Hands Generator");
+
+	rc=g_Context.FindExistingNode(XN_NODE_TYPE_GESTURE,g_GestureGenerator);
+	CHECK_RC(rc,"Find Gesture Generator");
+
+	XnCallbackHandle h;
+
+	//if we've activating the sensor for knowing whether or not the hand is near the FOV edge, register the callback
+	if (g_HandsGenerator.IsCapabilitySupported(XN_CAPABILITY_HAND_TOUCHING_FOV_EDGE))
+	{
+		g_HandsGenerator.GetHandTouchingFOVEdgeCap().RegisterToHandTouchingFOVEdge(TouchingCallback, NULL,h);
+	}
+
+	XnCallbackHandle hGestureIntermediateStageCompleted, hGestureProgress, hGestureReadyForNextIntermediateStage;
+	g_GestureGenerator.RegisterToGestureIntermediateStageCompleted(GestureIntermediateStageCompletedHandler, NULL, hGestureIntermediateStageCompleted);
+	g_GestureGenerator.RegisterToGestureReadyForNextIntermediateStage(GestureReadyForNextIntermediateStageHandler, NULL, hGestureReadyForNextIntermediateStage);
+	g_GestureGenerator.RegisterGestureCallbacks(NULL, GestureProgressHandler, NULL, hGestureProgress);
+
+	//We already created OpenNI objects, now we need to Create NITE objects
+
+	g_pSessionManager = new XnVSessionManager;
+	rc = g_pSessionManager->Initialize(&g_Context,"Click,Wave","RaiseHand");
+	CHECK_RC(rc, "SessionManager Initialization");
+
+	g_pSessionManager->RegisterSession(NULL,SessionStarting,SessionEnding,FocusProgress);
+
+	//every control gets the hands through the filter
+	g_pHandFilter = new XnVHandFilter;
+	g_pSessionManager->AddListener(g_pHandFilter);
+	if (strRecordHands != NULL)
+		g_pHandFilter->SetRecording(strRecordHands);
+
+	g_pDrawer = new PointDrawer(g_DepthGenerator);
+	g_pFlowRouter = new XnVFlowRouter;
+	g_pFlowRouter->SetActive(g_pDrawer);
+
+	//the hands projected natively, where that matches the library on this sensor
+	XnFloat fProjectionError;
+	if (g_pDrawer->GetProjection().CheckNative(fProjectionError))
+		g_pDrawer->GetProjection().SetMode(ProjectiveConverter::CONVERT_NATIVE);
+	printf("Hand projection: %s, native within %.2f px\n",
+		ProjectiveConverter::GetModeName(g_pDrawer->GetProjection().GetMode()), fProjectionError);
+
+	//will now draw the circle on the hand
+	g_pHandFilter->AddListener(g_pFlowRouter);
+
+	//logic and registration for the circle detector
+	g_pCircle = new XnVCircleDetector;
+	g_pCircle->RegisterCircle(NULL,&CircleCB); //when circle is recognized, CircleCB will be called
+	g_pCircle->RegisterNoCircle(NULL,&NoCircleCB); //when circle stops being detector, NoCircleCB will be called
+	
+	//UNCOMMENT TO ENABLE THE CIRCLE DETECTOR
+	g_pHandFilter->AddListener(g_pCircle);
+
+	//logic and registration for the swipe detector and its 4 events
+	g_pSwipe = new XnVSwipeDetector;
+	g_pSwipe->SetSteadyDuration(500);
+	g_pSwipe->RegisterSwipeDown(NULL, &SwipeDownCB);
+	g_pSwipe->RegisterSwipeLeft(NULL, &SwipeLeftCB);
+	g_pSwipe->RegisterSwipeRight(NULL, &SwipeRightCB);
+	g_pSwipe->RegisterSwipeUp(NULL, &SwipeUpCB);
+
+	g_pHandFilter->AddListener(g_pSwipe);
+
+	//registration for wave detector
+	g_pWave = new XnVWaveDetector;
+	g_pWave->RegisterWave(NULL, &WaveCB);
+
+	g_pHandFilter->AddListener(g_pWave);
+
+	//register for the push detector
+	g_pPush = new XnVPushDetector;
+	g_pPush->RegisterPush(NULL, &PushCB);
+
+	g_pHandFilter->AddListener(g_pPush);
+
+	//the continuous zoom, off until 'z'
+	g_pHandZoom = new XnVHandZoom(g_PlayerDispatcher);
+	g_pHandFilter->AddListener(g_pHandZoom);
+
+	g_pDrawer->RegisterNoPoints(NULL, NoHands);
+	g_pDrawer->SetDepthMap(g_bDrawDepthMap);
+	g_pDrawer->SetDepthHistogramPolicy(g_eHistogramPolicy);
+	g_pDrawer->SetColormap(g_eColormap);
+	g_pDrawer->SetDepthUpload(g_eDepthUpload);
+	g_pDrawer->GetDepthColorizer().SetThreadCount(g_nDepthThreads);
+	if (g_bClipDepth)
+		g_pDrawer->GetDepthColorizer().SetClipRange(g_nNearClip, g_nFarClip);
+
+	rc = g_Context.StartGeneratingAll();
+	CHECK_RC(rc,"Start Generating");
+
+	//the session manager's listeners all run on the NITE thread from now on
+	g_NiteWorker.AddListener(g_pHandFilter);
+	g_NiteWorker.AddListener(g_pFlowRouter);
+	g_NiteWorker.AddListener(g_pDrawer);
+	g_NiteWorker.AddListener(g_pCircle);
+	g_NiteWorker.AddListener(g_pSwipe);
+	g_NiteWorker.AddListener(g_pWave);
+	g_NiteWorker.AddListener(g_pPush);
+	g_NiteWorker.AddListener(g_pHandZoom);
+	g_NiteWorker.SetUpdateHandler(OnNiteUpdate, NULL);
+	g_Scheduler.SetRefreshRate(REFRESH_RATE);
+	g_Scheduler.SetMaxRate(MAX_FRAME_RATE);
+	rc = g_NiteWorker.Start(g_pSessionManager, g_Acquirer);
+	CHECK_RC(rc,"Start NITE");
+
+	rc = g_Acquirer.Start(g_Context, g_DepthGenerator);
+	CHECK_RC(rc,"Start Acquisition");
+
+
+
+#ifdef USE_GLUT
+
+	glInit(&argc, argv);
+	glutMainLoop();
+
+#elif defined(USE_GLES)
+	if (!opengles_init(GL_WIN_SIZE_X, GL_WIN_SIZE_Y, &display, &surface, &context))
+	{
+		printf("Error initializing opengles\n");
+		CleanupExit();
+	}
+	glDisable(GL_DEPTH_TEST);
+	glEnable(GL_TEXTURE_2D);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glDisableClientState(GL_COLOR_ARRAY);
+
+	while ((!_kbhit()) && (!g_bQuit))
+	{
+		XnBool bDraw;
+		XnUInt32 nSleep = ScheduleFrame(bDraw);
+		if (bDraw)
+		{
+			glutDisplay();
+			eglSwapBuffers(display, surface);
+		}
+		// Notifications end the wait early, the keyboard does not
+		g_Scheduler.Wait(nSleep < KEYBOARD_POLL_MS ? nSleep : KEYBOARD_POLL_MS);
+	}
+	opengles_shutdown(display, surface, context);
+
+	CleanupExit();
+#endif
+
+	cout << "Please press a key" << endl;
+	int temp;
+	cin >> temp;
+	return 0;
 }
\ No newline at end of file
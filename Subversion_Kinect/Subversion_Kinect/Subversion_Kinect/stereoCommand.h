@@ -1,839 +1,986 @@
-#include <ole2.h>
-#include <OleAuto.h>
-#include <ObjBase.h>
-#include <iostream>
-#include <string>
-#include <stdlib.h>
-#include <math.h>
-#include <stdio.h>
-#include <WinError.h>
-#include <Guiddef.h>
-#include <InitGuid.h>
-#include <sstream>
-#include <iomanip>
-#include <OAIdl.h>
-
-using namespace std;
-
-//GUID for the StereoPlayer automation class
-// {73B28B6E-D306-4589-9ED17AA4D182}
-DEFINE_GUID(StereoPlayer, 0x73b28b6e, 0xd306, 0x4589, 0xb0, 0x32, 0x9e, 0xd1, 0x7a, 0xa4, 0xd1, 0x82);
-//Could use the IDispatch::CoCreatefromProgID method, but this is more likely to work
-
-//enumeration for the SetPlaybackState method
-#define PLAY 0.0
-#define PAUSE 1.0
-#define STOP 2.0
-#define FASTF 3.0
-#define RWIND 4.0
-
-//enumeration for the AudioMode method
-#define NOAUDIO 0
-#define SEPAUDIO 1
-#define LEFTAUDIO 2
-#define RIGHTAUDIO 3
-
-//error handling subroutine returns the string of the error back to main
-string format_error(unsigned __int32 hr)
-{
-  stringstream ss;
-  ss << "Operation Failed. Error code = 0x" << hex << hr << std::endl;
-  return ss.str();
-}
-
-class COMMAND
-{
-	HRESULT hresult;
-	IUnknown * punk;
-	IDispatch * pdisp;
-	DISPID dispid;
-	DISPPARAMS dispparams;
-	EXCEPINFO excepinfo;
-	UINT nArgErr;
-	OLECHAR * pOLEStr;
-	VARIANT stereoCommand[15]; //for most commands
-	VARIANT lrFile[4];
-	WCHAR stringCommand[MAX_PATH];  //MAX_PATH defined as 260
-	LPCWSTR str;
-	float videoDuration;
-	float videoPosition;
-	bool fullScreen;
-	bool play;
-	bool pause;
-	bool stop;
-	VARIANTARG vParam;
-	double zoomLevel;
-
-public:
-	//this is the constructor for the class
-	COMMAND() 
-	{
-		cout << "Constructor has been called" << endl;
-		
-		hresult = OleInitialize(NULL);
-		if FAILED(hresult)
-		{
-			cout << "Failed to initialize OLE Object" << endl;
-		}
-
-		VariantInit(&stereoCommand[0]);
-		VariantInit(&lrFile[0]);
-
-		initalize_CommandStruct();
-
-		str = TEXT("\nConstructor Called\n");
-		OutputDebugString(str);
-
-		
-
-		fullScreen = false;
-		play = false;
-		pause = false;
-		stop = false;
-		zoomLevel = 100.0;
-	}
-	//this is the destructor for the class
-	~COMMAND()
-	{
-		str = TEXT("\nDestructor Called\n");
-		OutputDebugString(str);
-		
-		if(pdisp) pdisp->Release();
-		if(punk) punk->Release();
-
-		OleUninitialize();
-
-	}
-
-	HRESULT CreateInstance()
-	{
-		hresult = CoCreateInstance(StereoPlayer,NULL,CLSCTX_SERVER,IID_IUnknown, (void **) &punk);
-
-		if FAILED(hresult)
-		{
-			cout << "StereoCommand - Failed to CreateInstance: " << format_error(hresult) << endl;
-			return hresult;
-		}
-		return hresult;
-	}
-	
-	HRESULT OpenFile(string filepath)
-	{
-		cout << "Open File..." << endl;
-		//get string with file path and set the proper stereoCommand element
-		//convert to VARIANT structure element using a subroutine
-		prepStringParam(filepath,stringCommand); //conversion
-		stereoCommand[0].bstrVal=SysAllocString(stringCommand); //setting VARIANT struct
-		
-		set_params(&dispparams,0,1); //setting dispparam struct
-		pOLEStr = OLESTR("OpenFile");
-
-		double duration;
-		hresult = myInvoke();
-
-		if FAILED(hresult)
-		{
-			cout<<"FAILED TO OPEN FILE: " << format_error(hresult) << endl;
-			return hresult;
-		}
-		else
-		{
-			play = true;
-			pause = false;
-			stop = false;
-
-			hresult = getDuration();
-
-
-			if FAILED(hresult)
-			{
-				cout << "Failed to get duration." << format_error(hresult) << endl;
-				return hresult;
-			}
-
-		
-
-			//eventually want to wrap into IF DURATION << 60 seconds
-			SetRepeatTrue();
-
-
-			return hresult;
-		}
-		
-	}
-
-	HRESULT SetPause()
-	{
-		//sets up the dispparams structure for sending to the INVOKE command
-		set_params(&dispparams,1,1);
-
-		//identify the command to invoke
-		pOLEStr = OLESTR("SetPlaybackState");
-
-		hresult = myInvoke();
-		play = false;
-		pause = true;
-		stop = false;
-
-		return hresult;
-
-	}
-
-	HRESULT SetPlay()
-	{
-		//sets up the dispparams structure for sending to the INVOKE command
-		set_params(&dispparams,3,1);
-
-		//identify the command to invoke
-		pOLEStr = OLESTR("SetPlaybackState");
-
-		hresult = myInvoke();
-
-		play = true;
-		pause = false;
-		stop = false;
-		
-		
-		return hresult;		
-	}
-
-	HRESULT SetFF()
-	{
-		set_params(&dispparams,4,1);
-
-		pOLEStr = OLESTR("SetPlaybackState");
-
-		hresult = myInvoke();
-
-		return hresult;
-
-	}
-
-	HRESULT SetRW()
-	{
-		set_params(&dispparams,5,1);
-
-		pOLEStr = OLESTR("SetPlaybackState");
-
-		hresult=myInvoke();
-
-		return hresult;
-	}
-
-	HRESULT SetFullScreen()
-	{
-		pOLEStr = OLESTR("EnterFullscreenMode");
-		set_params(&dispparams,6,1);
-		hresult = myInvoke();
-
-		if FAILED(hresult)
-		{
-			std::cout << "FAILED TO SET FULL SCREEN " <<format_error(hresult) << endl;
-		}
-
-		fullScreen = true;
-
-
-		return hresult;
-	}
-
-	HRESULT SetStop()
-	{
-		set_params(&dispparams,2,1);
-		pOLEStr = OLESTR("SetPlaybackState");
-		
-		hresult = myInvoke();
-
-		if FAILED(hresult)
-		{
-			std::cout << "FAILED TO SET STOP " << format_error(hresult) << endl;
-		}
-
-		play = false;
-		pause = false;
-		stop = true;
-
-
-		return hresult;
-	}
-
-	HRESULT SetLeaveFullScreen()
-	{
-		set_params(&dispparams,8,0);
-		pOLEStr = OLESTR("LeaveFullscreenMode");
-
-		hresult = myInvoke();
-
-		if FAILED(hresult)
-		{
-			std::cout<<"FAILED TO LEAVE FULL SCREEN" << endl;
-			EmergencyExit();
-		}
-
-		fullScreen = false;
-
-		return hresult;
-	}
-
-	HRESULT SwitchFullScreen()
-	{
-		if (!fullScreen)
-		{
-			hresult = SetFullScreen();
-
-			if FAILED(hresult)
-			{
-				std::cout << "Failed to set full screen: " << format_error(hresult) << endl;
-				return hresult;
-			}
-
-		}
-		else if (fullScreen)
-		{
-			hresult = SetLeaveFullScreen();
-			if FAILED(hresult)
-			{
-				std::cout << "Failed to set non-full screen: " << format_error(hresult) << endl;
-				return hresult;
-			}
-		}
-
-		return hresult;
-	}
-
-	HRESULT togglePlay()
-	{
-		if(!play | stop)
-		{
-			hresult = SetPlay();
-			if FAILED(hresult)
-			{
-				std::cout << "FAILED TO SET PLAY: " << format_error(hresult) << endl;
-				return hresult;
-			}
-
-		}
-
-		else if (play)
-		{
-			hresult = SetPause();
-			if FAILED(hresult)
-			{
-				std::cout << "FAILED TO SET PAUSE: " << format_error(hresult) << endl;
-				return hresult;
-			}
-		}
-	}
-
-	void EmergencyExit()
-	{
-		if(pdisp) pdisp->Release();
-		if(punk) punk->Release();
-
-
-		pOLEStr = OLESTR("ClosePlayer");
-		set_params(&dispparams,8,0);
-		hresult = myInvoke();
-
-		OleUninitialize();
-		exit(1);
-	}
-
-	HRESULT SetZoomIncrement()
-	{
-		double zoomCheck = stereoCommand[9].dblVal;
-		double newZoom;
-
-		if (zoomLevel!= zoomCheck)
-		{
-			cout << "Zoom level mismatch! Expected: " << zoomLevel << " Actual: " << zoomCheck << endl;
-			return E_ABORT;
-		}
-		else
-		{
-			cout << "Zoom level matches expectation" << endl;
-
-			newZoom = zoomLevel+(double)10.0;
-
-			stereoCommand[9].dblVal = newZoom;
-
-			pOLEStr = OLESTR("SetZoom");
-			set_params(&dispparams,9,1);
-
-			hresult = myInvoke();
-
-			if FAILED(hresult)
-			{
-				cout << "FAILED TO INVOKE ZOOM INCREMENT: " << format_error(hresult) << endl;
-			}
-
-
-			//set equal to new zoom
-			zoomLevel = newZoom;
-			return hresult;
-		}
-	}
-
-	HRESULT SetZoomDecrement()
-	{
-		double zoomCheck = stereoCommand[9].dblVal;
-		double newZoom;
-
-		if (zoomLevel!= zoomCheck)
-		{
-			cout << "Zoom level mismatch! Expected: " << zoomLevel << " Actual: " << zoomCheck << endl;
-			return E_ABORT;
-		}
-		else
-		{
-			cout << "Zoom level matches expectation" << endl;
-
-			newZoom = zoomLevel-(double)10.0;
-
-			stereoCommand[9].dblVal = newZoom;
-
-			pOLEStr = OLESTR("SetZoom");
-			set_params(&dispparams,9,1);
-
-			hresult = myInvoke();
-
-			if FAILED(hresult)
-			{
-				cout << "FAILED TO INVOKE ZOOM DECREMENT: " << format_error(hresult) << endl;
-			}
-
-
-			//set equal to new zoom
-			zoomLevel = newZoom;
-			return hresult;
-		}
-
-
-	}
-
-	HRESULT SetRepeatTrue()
-	{
-		set_params(&dispparams,6,1);
-		pOLEStr = OLESTR("SetRepeat");
-		hresult = myInvoke();
-
-		if FAILED(hresult)
-		{
-			cout << "FAILED TO SET REPEAT TRUE " << format_error(hresult) << endl;
-		}
-		else
-			cout << "Repeat set to TRUE" << endl;
-
-		return hresult;
-	}
-
-	HRESULT SetRepeatFalse()
-	{
-		set_params(&dispparams,7,1);
-		pOLEStr = OLESTR("SetRepeat");
-		hresult = myInvoke();
-
-		if FAILED(hresult)
-		{
-			cout << "FAILED TO SET REPEAT FALSE " << format_error(hresult) << endl;
-		}
-		else
-			cout << "Repeat set to FALSE" << endl;
-
-		return hresult;
-	}
-
-	HRESULT SetOpenLRFiles(string LeftFile, string RightFile, int AudioMode)
-	{
-		pOLEStr = OLESTR("OpenLeftRightFiles");
-		
-		//set LeftFile into stereoCommand structure
-		prepStringParam(LeftFile,stringCommand);
-		lrFile[3].vt = VT_BSTR;
-		lrFile[3].bstrVal = SysAllocString(stringCommand);
-		
-		//set up right file
-		prepStringParam(RightFile,stringCommand);
-		lrFile[2].vt = VT_BSTR;
-		lrFile[2].bstrVal = SysAllocString(stringCommand);
-
-		if (AudioMode ==1.0)
-		{
-			std::cout << "ERROR Parameters indicate a separate audio file is expected, but none was indicated." << endl;
-			return DISP_E_BADPARAMCOUNT;
-		}
-		//we are not specifying an audio file so we need to nullify this array element
-		lrFile[1].vt = VT_EMPTY;
-		//lrFile[2].scode = DISP_E_PARAMNOTFOUND;
-
-		//set audio mode
-		lrFile[0].vt = VT_EMPTY;
-		lrFile[0].lVal = AudioMode;
-
-		
-		hresult = punk ->QueryInterface(&pdisp);
-		if FAILED(hresult)
-		{
-			cout << "Failed to query interface." << format_error(hresult) << endl;
-			int temp;
-			cout << "Press any key to continue..." << endl;
-			cin >> temp;
-			return hresult;
-		}
-
-		hresult = pdisp->GetIDsOfNames(IID_NULL,&pOLEStr,1,LOCALE_USER_DEFAULT,&dispid);
-		if FAILED(hresult)
-		{
-			cout << "Failed to find method." << format_error(hresult) << endl;
-			int temp;
-			cout << "Press any key to continue..." << endl;
-			cin >> temp;
-			return hresult;
-		}
-
-		//cout << "DISPID: " << hex << dispid << endl;
-
-		
-		dispparams.rgvarg = lrFile;
-		dispparams.cArgs = 4;
-		dispparams.cNamedArgs = 0;
-		dispparams.rgdispidNamedArgs = NULL;
-
-		hresult = pdisp->Invoke(dispid,
-			IID_NULL,
-			LOCALE_SYSTEM_DEFAULT,
-			DISPATCH_METHOD,
-			&dispparams,
-			NULL,
-			NULL,
-			NULL);
-
-		if FAILED(hresult)
-		{
-			cout << "Failed to Invoke command." << format_error(hresult) << endl;
-			return hresult;
-		}
-
-		
-		return hresult;
-	}
-	
-
-	HRESULT SetOpenLRFiles(string LeftFile, string RightFile, string AudioFile, int AudioMode)
-	{
-		pOLEStr = OLESTR("OpenLeftRightFiles");
-		
-		//set LeftFile into stereoCommand structure
-		prepStringParam(LeftFile,stringCommand);
-		lrFile[3].vt = VT_BSTR;
-		lrFile[3].bstrVal = SysAllocString(stringCommand);
-		
-		//set up right file
-		prepStringParam(RightFile,stringCommand);
-		lrFile[2].vt = VT_BSTR;
-		lrFile[2].bstrVal = SysAllocString(stringCommand);
-
-		if (AudioMode ==1.0)
-		{
-			std::cout << "ERROR Parameters indicate a separate audio file is expected, but none was indicated." << endl;
-			return DISP_E_BADPARAMCOUNT;
-		}
-		
-		//set audio file
-		prepStringParam(AudioFile,stringCommand);
-		lrFile[1].vt = VT_BSTR;
-		lrFile[1].bstrVal = SysAllocString(stringCommand);
-
-		//set audio mode
-		lrFile[0].vt = VT_EMPTY;
-		lrFile[0].lVal = AudioMode;
-
-		
-		hresult = punk ->QueryInterface(&pdisp);
-		if FAILED(hresult)
-		{
-			cout << "Failed to query interface." << format_error(hresult) << endl;
-			int temp;
-			cout << "Press any key to continue..." << endl;
-			cin >> temp;
-			return hresult;
-		}
-
-		hresult = pdisp->GetIDsOfNames(IID_NULL,&pOLEStr,1,LOCALE_USER_DEFAULT,&dispid);
-		if FAILED(hresult)
-		{
-			cout << "Failed to find method." << format_error(hresult) << endl;
-			int temp;
-			cout << "Press any key to continue..." << endl;
-			cin >> temp;
-			return hresult;
-		}
-
-		//cout << "DISPID: " << hex << dispid << endl;
-
-		
-		dispparams.rgvarg = lrFile;
-		dispparams.cArgs = 4;
-		dispparams.cNamedArgs = 0;
-		dispparams.rgdispidNamedArgs = NULL;
-
-		hresult = pdisp->Invoke(dispid,
-			IID_NULL,
-			LOCALE_SYSTEM_DEFAULT,
-			DISPATCH_METHOD,
-			&dispparams,
-			NULL,
-			NULL,
-			NULL);
-
-		if FAILED(hresult)
-		{
-			cout << "Failed to Invoke command." << format_error(hresult) << endl;
-			return hresult;
-		}
-
-		
-		return hresult;
-
-
-
-
-
-	}
-
-protected:
-	HRESULT getDuration()
-	{
-		cout << "Function: Get Duration" << endl;
-		pOLEStr = OLESTR("GetDuration");
-
-		hresult = punk ->QueryInterface(&pdisp);
-
-		//error checking
-		if FAILED(hresult)
-		{
-			cout << "Failed to query interface." << format_error(hresult) << endl;
-			int temp;
-			cout << "Press any key to continue..." << endl;
-			cin >> temp;
-			return hresult;
-		}
-
-		hresult = pdisp->GetIDsOfNames(IID_NULL, &pOLEStr,  1, LOCALE_USER_DEFAULT, &dispid);
-		//error checking
-		if FAILED(hresult)
-		{
-			cout << "Failed to find Method." << format_error(hresult) << endl;
-			int temp;
-			cout << "Press any key to continue..." << endl;
-			cin >> temp;
-			return hresult;
-		}
-
-		vParam.vt=VT_EMPTY;
-
-		dispparams.cArgs = 0;
-		dispparams.cNamedArgs =0;
-		dispparams.rgdispidNamedArgs = NULL;
-		dispparams.rgvarg = NULL; //NULL
-
-
-		hresult = pdisp->Invoke(dispid,
-			IID_NULL,
-			LOCALE_SYSTEM_DEFAULT,
-			DISPATCH_METHOD,
-			&dispparams,
-			NULL,
-			&excepinfo,
-			&nArgErr);
-		
-		if FAILED(hresult)
-		{
-			cout << "Failed at INVOKE step.  " << format_error(hresult) << endl;
-			return hresult;
-		}
-		else
-		{
-			
-			if (nArgErr >= 1)
-			{cout << "Count of Errors: " << nArgErr << endl << "pExepInfo: " << excepinfo.bstrDescription << endl;}
-		}
-
-		return hresult;
-
-	}
-	
-	HRESULT myInvoke(VARIANTARG pArgs)
-	{
-		//query the interface
-		hresult = punk->QueryInterface(&pdisp);
-
-		if FAILED(hresult)
-		{
-			cout << "Failed at QueryInterface step: " << format_error(hresult) << endl;
-			return hresult;
-		}
-
-		//find command's location in memory
-		hresult = pdisp->GetIDsOfNames(IID_NULL,
-			&pOLEStr,
-			1,
-			LOCALE_USER_DEFAULT,
-			&dispid);
-
-		if FAILED(hresult)
-		{
-			cout << "Failed at GetIDsOfNames step: " << format_error(hresult) << endl;
-			return hresult;
-		}
-
-
-		//invoke the command
-		hresult = pdisp->Invoke(dispid,
-			IID_NULL,
-			LOCALE_SYSTEM_DEFAULT,
-			DISPATCH_PROPERTYGET,
-			&dispparams,
-			&pArgs,
-			NULL,
-			NULL);
-
-		if FAILED(hresult)
-		{
-			cout << "Failed at Invoke step: " << format_error(hresult) << endl;
-			return hresult;
-		}
-
-		return hresult;
-	}
-	
-	HRESULT myInvoke()
-	{
-		//query the interface
-		hresult = punk->QueryInterface(&pdisp);
-
-		if FAILED(hresult)
-		{
-			cout << "Failed at QueryInterface step: " << format_error(hresult) << endl;
-			return hresult;
-		}
-
-		//find command's location in memory
-		hresult = pdisp->GetIDsOfNames(IID_NULL,
-			&pOLEStr,
-			1,
-			LOCALE_USER_DEFAULT,
-			&dispid);
-
-		if FAILED(hresult)
-		{
-			cout << "Failed at GetIDsOfNames step: " << format_error(hresult) << endl;
-			return hresult;
-		}
-
-
-		//invoke the command
-		hresult = pdisp->Invoke(dispid,
-			IID_NULL,
-			LOCALE_SYSTEM_DEFAULT,
-			DISPATCH_METHOD,
-			&dispparams,
-			NULL,
-			NULL,
-			NULL);
-
-		if FAILED(hresult)
-		{
-			cout << "Failed at Invoke step: " << format_error(hresult) << endl;
-			return hresult;
-		}
-
-		return hresult;
-	}
-
-	void prepStringParam(string argument, WCHAR formattedArg[])
-	{
-		//converts the "string" variable to the OLECHAR type for use in the VARIANT structure
-		MultiByteToWideChar(CP_UTF8,0,argument.c_str(),argument.length()+1,formattedArg,MAX_PATH);
-	}
-
-	//sets up the dispparams structure with proper values for use in INVOKE	
-	void set_params(DISPPARAMS *pdispparam, int which, int howMany, bool isNull)
-	{
-		//set up the DISPPARAMS struct for use in the IDispatch::Invoke command
-		if (!isNull)
-			howMany++;
-
-		pdispparam->cArgs = howMany;
-		pdispparam->cNamedArgs =0;
-		pdispparam->rgdispidNamedArgs = NULL;
-		if (howMany !=0)
-		{
-			pdispparam->rgvarg = &stereoCommand[which];
-		}
-		else
-		{
-			pdispparam->rgvarg=NULL;
-		}
-	}
-	void set_params(DISPPARAMS *pdispparam, int which, int howMany)
-	{
-		//set up the DISPPARAMS struct for use in the IDispatch::Invoke command
-		
-		pdispparam->cArgs = howMany;
-		pdispparam->cNamedArgs =0;
-		pdispparam->rgdispidNamedArgs = NULL;
-		if (howMany !=0)
-		{
-			pdispparam->rgvarg = &stereoCommand[which];
-		}
-		else
-		{
-			pdispparam->rgvarg=NULL;
-		}
-	}
-
-	void initalize_CommandStruct()
-	{
-				
-		//VARIANT struct for a string param like a filepath
-		stereoCommand[0].vt=VT_BSTR;
-		//we cannot set the bstrVal here, it must be done after converting the string to the BSTR VARIANT structure
-		//stereoCommand[0].bstrVal = SysAllocString(stringCommand);
-
-		//VARIANT struct for PAUSE command
-		stereoCommand[1].vt = VT_UI4;
-		stereoCommand[1].lVal = PAUSE;
-
-		//VARIANT struct for STOP command
-		stereoCommand[2].vt = VT_UI4;
-		stereoCommand[2].lVal = STOP;
-	
-		//VARIANT struct for PLAY command
-		stereoCommand[3].vt = VT_UI4;
-		stereoCommand[3].lVal = PLAY;
-
-		//VARIANT struct for FAST FORWARD command
-		stereoCommand[4].vt = VT_UI4;
-		stereoCommand[4].lVal = FASTF;
-
-		//VARIANT struct for REWIND command
-		stereoCommand[5].vt = VT_UI4;
-		stereoCommand[5].lVal = RWIND;
-
-		//VARIANT struct for (bool) TRUE
-		stereoCommand[6].vt = VT_BOOL;
-		stereoCommand[6].boolVal =1;
-
-		//VARIANT struct for (bool) FALSE
-		stereoCommand[7].vt = VT_BOOL;
-		stereoCommand[7].boolVal = 0;
-
-		//VARIANT struct for null
-		stereoCommand[8].vt = VT_EMPTY;
-
-		//VARIANT struct for Zoom
-		stereoCommand[9].vt = VT_R8;
-		stereoCommand[9].dblVal =100.0;
-	}
-};
\ No newline at end of file
+#include <ole2.h>
+#include <OleAuto.h>
+#include <ObjBase.h>
+#include <iostream>
+#include <string>
+#include <stdlib.h>
+#include <math.h>
+#include <stdio.h>
+#include <WinError.h>
+#include <Guiddef.h>
+#include <InitGuid.h>
+#include <sstream>
+#include <iomanip>
+#include <OAIdl.h>
+#include "PlayerBackend.h"
+
+using namespace std;
+
+//GUID for the StereoPlayer automation class
+// {73B28B6E-D306-4589-9ED17AA4D182}
+DEFINE_GUID(StereoPlayer, 0x73b28b6e, 0xd306, 0x4589, 0xb0, 0x32, 0x9e, 0xd1, 0x7a, 0xa4, 0xd1, 0x82);
+//Could use the IDispatch::CoCreatefromProgID method, but this is more likely to work
+
+//enumeration for the SetPlaybackState method
+#define PLAY 0.0
+#define PAUSE 1.0
+#define STOP 2.0
+#define FASTF 3.0
+#define RWIND 4.0
+
+//enumeration for the AudioMode method
+#define NOAUDIO 0
+#define SEPAUDIO 1
+#define LEFTAUDIO 2
+#define RIGHTAUDIO 3
+
+//error handling subroutine returns the string of the error back to main
+string format_error(unsigned __int32 hr)
+{
+  stringstream ss;
+  ss << "Operation Failed. Error code = 0x" << hex << hr << std::endl;
+  return ss.str();
+}
+
+//every automation method of the player that a command uses, resolved to its DISPID once, by CreateInstance.
+//the player has to offer the required ones. Without the others, its state is taken to be what it was last set to
+#define STEREO_PLAYER_METHODS(METHOD) \
+	METHOD(STEREO_METHOD_OPEN_FILE, OLESTR("OpenFile"), true) \
+	METHOD(STEREO_METHOD_OPEN_LEFT_RIGHT_FILES, OLESTR("OpenLeftRightFiles"), true) \
+	METHOD(STEREO_METHOD_GET_DURATION, OLESTR("GetDuration"), true) \
+	METHOD(STEREO_METHOD_SET_PLAYBACK_STATE, OLESTR("SetPlaybackState"), true) \
+	METHOD(STEREO_METHOD_ENTER_FULLSCREEN, OLESTR("EnterFullscreenMode"), true) \
+	METHOD(STEREO_METHOD_LEAVE_FULLSCREEN, OLESTR("LeaveFullscreenMode"), true) \
+	METHOD(STEREO_METHOD_SET_REPEAT, OLESTR("SetRepeat"), true) \
+	METHOD(STEREO_METHOD_SET_ZOOM, OLESTR("SetZoom"), true) \
+	METHOD(STEREO_METHOD_CLOSE_PLAYER, OLESTR("ClosePlayer"), true) \
+	METHOD(STEREO_METHOD_GET_PLAYBACK_STATE, OLESTR("GetPlaybackState"), false) \
+	METHOD(STEREO_METHOD_GET_POSITION, OLESTR("GetPosition"), false) \
+	METHOD(STEREO_METHOD_GET_ZOOM, OLESTR("GetZoom"), false) \
+	METHOD(STEREO_METHOD_GET_FULLSCREEN, OLESTR("GetFullscreenMode"), false)
+
+//every command: the method it invokes, and the one argument it passes (VT_EMPTY for none).
+//the argument of OPEN_FILE and SET_ZOOM changes from call to call, the value here is the initial one
+#define STEREO_PLAYER_COMMANDS(COMMAND_ENTRY) \
+	COMMAND_ENTRY(STEREO_OPEN_FILE, STEREO_METHOD_OPEN_FILE, VT_BSTR, 0) \
+	COMMAND_ENTRY(STEREO_GET_DURATION, STEREO_METHOD_GET_DURATION, VT_EMPTY, 0) \
+	COMMAND_ENTRY(STEREO_PLAY, STEREO_METHOD_SET_PLAYBACK_STATE, VT_UI4, PLAY) \
+	COMMAND_ENTRY(STEREO_PAUSE, STEREO_METHOD_SET_PLAYBACK_STATE, VT_UI4, PAUSE) \
+	COMMAND_ENTRY(STEREO_STOP, STEREO_METHOD_SET_PLAYBACK_STATE, VT_UI4, STOP) \
+	COMMAND_ENTRY(STEREO_FAST_FORWARD, STEREO_METHOD_SET_PLAYBACK_STATE, VT_UI4, FASTF) \
+	COMMAND_ENTRY(STEREO_REWIND, STEREO_METHOD_SET_PLAYBACK_STATE, VT_UI4, RWIND) \
+	COMMAND_ENTRY(STEREO_ENTER_FULLSCREEN, STEREO_METHOD_ENTER_FULLSCREEN, VT_BOOL, 1) \
+	COMMAND_ENTRY(STEREO_LEAVE_FULLSCREEN, STEREO_METHOD_LEAVE_FULLSCREEN, VT_EMPTY, 0) \
+	COMMAND_ENTRY(STEREO_REPEAT_ON, STEREO_METHOD_SET_REPEAT, VT_BOOL, 1) \
+	COMMAND_ENTRY(STEREO_REPEAT_OFF, STEREO_METHOD_SET_REPEAT, VT_BOOL, 0) \
+	COMMAND_ENTRY(STEREO_SET_ZOOM, STEREO_METHOD_SET_ZOOM, VT_R8, 100.0) \
+	COMMAND_ENTRY(STEREO_CLOSE_PLAYER, STEREO_METHOD_CLOSE_PLAYER, VT_EMPTY, 0) \
+	COMMAND_ENTRY(STEREO_GET_PLAYBACK_STATE, STEREO_METHOD_GET_PLAYBACK_STATE, VT_EMPTY, 0) \
+	COMMAND_ENTRY(STEREO_GET_POSITION, STEREO_METHOD_GET_POSITION, VT_EMPTY, 0) \
+	COMMAND_ENTRY(STEREO_GET_ZOOM, STEREO_METHOD_GET_ZOOM, VT_EMPTY, 0) \
+	COMMAND_ENTRY(STEREO_GET_FULLSCREEN, STEREO_METHOD_GET_FULLSCREEN, VT_EMPTY, 0)
+
+typedef enum
+{
+#define DECLARE_STEREO_METHOD(id, name, required) id,
+	STEREO_PLAYER_METHODS(DECLARE_STEREO_METHOD)
+#undef DECLARE_STEREO_METHOD
+	STEREO_METHOD_COUNT
+} StereoMethod;
+
+typedef enum
+{
+#define DECLARE_STEREO_COMMAND(id, method, type, value) id,
+	STEREO_PLAYER_COMMANDS(DECLARE_STEREO_COMMAND)
+#undef DECLARE_STEREO_COMMAND
+	STEREO_COMMAND_COUNT
+} StereoCommand;
+
+typedef struct
+{
+	const char* name;
+	StereoMethod method;
+	VARTYPE type;
+	double value;
+} StereoCommandDescriptor;
+
+inline const OLECHAR* getStereoMethodName(StereoMethod method)
+{
+	static const OLECHAR* names[STEREO_METHOD_COUNT] =
+	{
+#define STEREO_METHOD_NAME(id, name, required) name,
+		STEREO_PLAYER_METHODS(STEREO_METHOD_NAME)
+#undef STEREO_METHOD_NAME
+	};
+	return names[method];
+}
+
+inline bool isStereoMethodRequired(StereoMethod method)
+{
+	static const bool required[STEREO_METHOD_COUNT] =
+	{
+#define STEREO_METHOD_REQUIRED(id, name, required) required,
+		STEREO_PLAYER_METHODS(STEREO_METHOD_REQUIRED)
+#undef STEREO_METHOD_REQUIRED
+	};
+	return required[method];
+}
+
+inline const StereoCommandDescriptor& getStereoCommand(StereoCommand command)
+{
+	static const StereoCommandDescriptor commands[STEREO_COMMAND_COUNT] =
+	{
+#define STEREO_COMMAND_DESCRIPTOR(id, method, type, value) {#id, method, type, value},
+		STEREO_PLAYER_COMMANDS(STEREO_COMMAND_DESCRIPTOR)
+#undef STEREO_COMMAND_DESCRIPTOR
+	};
+	return commands[command];
+}
+
+//stands in for the player in the benchmark: answers every method of the table, and does nothing
+class StandInPlayer : public IDispatch
+{
+	LONG refCount;
+	LONG invokeCount[STEREO_METHOD_COUNT];
+
+public:
+	StandInPlayer() : refCount(1)
+	{
+		memset(invokeCount, 0, sizeof(invokeCount));
+	}
+
+	LONG getInvokeCount(StereoMethod method) const
+	{
+		return invokeCount[method];
+	}
+
+	STDMETHODIMP QueryInterface(REFIID riid, void** ppv)
+	{
+		if (riid == IID_IUnknown || riid == IID_IDispatch)
+		{
+			*ppv = static_cast<IDispatch*>(this);
+			AddRef();
+			return S_OK;
+		}
+		*ppv = NULL;
+		return E_NOINTERFACE;
+	}
+	STDMETHODIMP_(ULONG) AddRef()
+	{
+		return InterlockedIncrement(&refCount);
+	}
+	STDMETHODIMP_(ULONG) Release()
+	{
+		LONG count = InterlockedDecrement(&refCount);
+		if (count == 0)
+			delete this;
+		return count;
+	}
+
+	STDMETHODIMP GetTypeInfoCount(UINT* pctinfo)
+	{
+		*pctinfo = 0;
+		return S_OK;
+	}
+	STDMETHODIMP GetTypeInfo(UINT, LCID, ITypeInfo** ppTInfo)
+	{
+		*ppTInfo = NULL;
+		return E_NOTIMPL;
+	}
+	STDMETHODIMP GetIDsOfNames(REFIID, LPOLESTR* rgszNames, UINT cNames, LCID, DISPID* rgDispId)
+	{
+		HRESULT result = S_OK;
+		for (UINT i = 0; i < cNames; ++i)
+		{
+			rgDispId[i] = DISPID_UNKNOWN;
+			for (int method = 0; method < STEREO_METHOD_COUNT; ++method)
+			{
+				if (_wcsicmp(rgszNames[i], getStereoMethodName((StereoMethod)method)) == 0)
+					rgDispId[i] = method + 1;
+			}
+			if (rgDispId[i] == DISPID_UNKNOWN)
+				result = DISP_E_UNKNOWNNAME;
+		}
+		return result;
+	}
+	STDMETHODIMP Invoke(DISPID dispIdMember, REFIID, LCID, WORD, DISPPARAMS*, VARIANT* pVarResult, EXCEPINFO*, UINT*)
+	{
+		if (dispIdMember < 1 || dispIdMember > STEREO_METHOD_COUNT)
+			return DISP_E_MEMBERNOTFOUND;
+
+		invokeCount[dispIdMember - 1]++;
+		if (pVarResult == NULL)
+			return S_OK;
+		//a minute long video, playing from the start, at its own size, in a window
+		switch (dispIdMember - 1)
+		{
+		case STEREO_METHOD_GET_DURATION:
+			pVarResult->vt = VT_R8;
+			pVarResult->dblVal = 60.0;
+			break;
+		case STEREO_METHOD_GET_PLAYBACK_STATE:
+			pVarResult->vt = VT_I4;
+			pVarResult->lVal = (LONG)PLAY;
+			break;
+		case STEREO_METHOD_GET_POSITION:
+			pVarResult->vt = VT_R8;
+			pVarResult->dblVal = 0.0;
+			break;
+		case STEREO_METHOD_GET_ZOOM:
+			pVarResult->vt = VT_R8;
+			pVarResult->dblVal = 100.0;
+			break;
+		case STEREO_METHOD_GET_FULLSCREEN:
+			pVarResult->vt = VT_BOOL;
+			pVarResult->boolVal = VARIANT_FALSE;
+			break;
+		}
+		return S_OK;
+	}
+};
+
+//the player's methods, resolved once, and every command's arguments, built once
+class StereoCommandTable
+{
+	IDispatch * pdisp;
+	DISPID dispids[STEREO_METHOD_COUNT];
+	VARIANT arguments[STEREO_COMMAND_COUNT];
+	DISPPARAMS params[STEREO_COMMAND_COUNT];
+	EXCEPINFO excepinfo;
+	UINT nArgErr;
+
+public:
+	StereoCommandTable() : pdisp(NULL)
+	{
+		for (int method = 0; method < STEREO_METHOD_COUNT; ++method)
+			dispids[method] = DISPID_UNKNOWN;
+
+		for (int command = 0; command < STEREO_COMMAND_COUNT; ++command)
+		{
+			const StereoCommandDescriptor& descriptor = getStereoCommand((StereoCommand)command);
+			VARIANT& argument = arguments[command];
+			VariantInit(&argument);
+			argument.vt = descriptor.type;
+			switch (descriptor.type)
+			{
+			case VT_UI4:
+				argument.lVal = (LONG)descriptor.value; break;
+			case VT_BOOL:
+				argument.boolVal = (VARIANT_BOOL)descriptor.value; break;
+			case VT_R8:
+				argument.dblVal = descriptor.value; break;
+			case VT_BSTR:
+				argument.bstrVal = NULL; break;
+			}
+
+			params[command].cArgs = descriptor.type == VT_EMPTY ? 0 : 1;
+			params[command].rgvarg = descriptor.type == VT_EMPTY ? NULL : &argument;
+			params[command].cNamedArgs = 0;
+			params[command].rgdispidNamedArgs = NULL;
+		}
+	}
+
+	~StereoCommandTable()
+	{
+		release();
+		for (int command = 0; command < STEREO_COMMAND_COUNT; ++command)
+			VariantClear(&arguments[command]);
+	}
+
+	//take the player's IDispatch, and look up every method the commands use
+	HRESULT resolve(IUnknown * punk)
+	{
+		release();
+		HRESULT hresult = punk->QueryInterface(IID_IDispatch, (void **) &pdisp);
+		if FAILED(hresult)
+		{
+			pdisp = NULL;
+			cout << "Failed at QueryInterface step: " << format_error(hresult) << endl;
+			return hresult;
+		}
+
+		//one name per call: the names after the first would be taken for parameter names
+		HRESULT missing = S_OK;
+		for (int method = 0; method < STEREO_METHOD_COUNT; ++method)
+		{
+			LPOLESTR name = (LPOLESTR)getStereoMethodName((StereoMethod)method);
+			hresult = pdisp->GetIDsOfNames(IID_NULL, &name, 1, LOCALE_USER_DEFAULT, &dispids[method]);
+			if FAILED(hresult)
+			{
+				dispids[method] = DISPID_UNKNOWN;
+				if (isStereoMethodRequired((StereoMethod)method))
+				{
+					wcout << L"Failed at GetIDsOfNames step for " << name << L": " << hex << hresult << dec << endl;
+					missing = hresult;
+				}
+				else
+				{
+					wcout << L"The player has no " << name << L", what it does is taken from what it was set to" << endl;
+				}
+			}
+		}
+		return missing;
+	}
+
+	void release()
+	{
+		if(pdisp) pdisp->Release();
+		pdisp = NULL;
+	}
+
+	//whether the player has a method, only ever false for the ones not required
+	bool offers(StereoMethod method) const
+	{
+		return pdisp != NULL && dispids[method] != DISPID_UNKNOWN;
+	}
+
+	//the argument of a command, to change before invoking it
+	VARIANT& getArgument(StereoCommand command)
+	{
+		return arguments[command];
+	}
+
+	void setString(StereoCommand command, const WCHAR * value)
+	{
+		VARIANT& argument = arguments[command];
+		if (argument.bstrVal != NULL)
+			SysFreeString(argument.bstrVal);
+		argument.bstrVal = SysAllocString(value);
+	}
+
+	//one round trip to the player
+	HRESULT invoke(StereoCommand command, VARIANT * pResult = NULL)
+	{
+		return invoke(getStereoCommand(command).method, &params[command], pResult);
+	}
+
+	HRESULT invoke(StereoMethod method, DISPPARAMS * pParams, VARIANT * pResult = NULL)
+	{
+		if (pdisp == NULL)
+			return E_POINTER;
+		if (dispids[method] == DISPID_UNKNOWN)
+			return DISP_E_UNKNOWNNAME;
+
+		nArgErr = 0;
+		HRESULT hresult = pdisp->Invoke(dispids[method],
+			IID_NULL,
+			LOCALE_SYSTEM_DEFAULT,
+			DISPATCH_METHOD,
+			pParams,
+			pResult,
+			&excepinfo,
+			&nArgErr);
+
+		if FAILED(hresult)
+		{
+			cout << "Failed at Invoke step: " << format_error(hresult) << endl;
+		}
+		return hresult;
+	}
+
+	//time every command against a stand-in player, looked up by name on every call as it used to be,
+	//and through the table. The stand-in lives in an apartment of its own, so every call goes through
+	//the IDispatch proxy, as calls to the player do
+	static HRESULT benchmark(int iterations);
+};
+
+struct StandInThread
+{
+	HANDLE ready;
+	IStream * pStream;
+	HRESULT hresult;
+	StandInPlayer * pPlayer;
+};
+
+static DWORD WINAPI standInThreadProc(LPVOID param)
+{
+	StandInThread * pThread = (StandInThread *) param;
+	CoInitializeEx(NULL, COINIT_APARTMENTTHREADED);
+
+	//the first reference stays here until the thread ends, so the benchmark can read the counts
+	pThread->pPlayer = new StandInPlayer;
+	pThread->hresult = CoMarshalInterThreadInterfaceInStream(IID_IDispatch, pThread->pPlayer, &pThread->pStream);
+
+	//make sure the queue exists before anyone posts to it
+	MSG msg;
+	PeekMessage(&msg, NULL, 0, 0, PM_NOREMOVE);
+	SetEvent(pThread->ready);
+
+	while (GetMessage(&msg, NULL, 0, 0) > 0)
+	{
+		DispatchMessage(&msg);
+	}
+
+	pThread->pPlayer->Release();
+	CoUninitialize();
+	return 0;
+}
+
+inline HRESULT StereoCommandTable::benchmark(int iterations)
+{
+	StandInThread standIn;
+	standIn.ready = CreateEvent(NULL, FALSE, FALSE, NULL);
+	standIn.pStream = NULL;
+	standIn.hresult = E_FAIL;
+	standIn.pPlayer = NULL;
+
+	DWORD threadID;
+	HANDLE thread = CreateThread(NULL, 0, standInThreadProc, &standIn, 0, &threadID);
+	if (thread == NULL)
+	{
+		CloseHandle(standIn.ready);
+		return HRESULT_FROM_WIN32(GetLastError());
+	}
+	WaitForSingleObject(standIn.ready, INFINITE);
+	CloseHandle(standIn.ready);
+
+	IUnknown * punk = NULL;
+	HRESULT hresult = standIn.hresult;
+	if SUCCEEDED(hresult)
+		hresult = CoGetInterfaceAndReleaseStream(standIn.pStream, IID_IUnknown, (void **) &punk);
+
+	if SUCCEEDED(hresult)
+	{
+		StereoCommandTable table;
+		hresult = table.resolve(punk);
+
+		LARGE_INTEGER frequency, start, end;
+		QueryPerformanceFrequency(&frequency);
+		printf("Player commands against a stand-in, %d calls each:\n", iterations);
+		for (int command = 0; SUCCEEDED(hresult) && command < STEREO_COMMAND_COUNT; ++command)
+		{
+			const StereoCommandDescriptor& descriptor = getStereoCommand((StereoCommand)command);
+
+			//what every command cost before: a new IDispatch, the method looked up by name, and the call
+			QueryPerformanceCounter(&start);
+			for (int i = 0; SUCCEEDED(hresult) && i < iterations; ++i)
+			{
+				IDispatch * pdisp;
+				hresult = punk->QueryInterface(IID_IDispatch, (void **) &pdisp);
+				if FAILED(hresult)
+					break;
+				LPOLESTR name = (LPOLESTR)getStereoMethodName(descriptor.method);
+				DISPID dispid;
+				hresult = pdisp->GetIDsOfNames(IID_NULL, &name, 1, LOCALE_USER_DEFAULT, &dispid);
+				if SUCCEEDED(hresult)
+					hresult = pdisp->Invoke(dispid, IID_NULL, LOCALE_SYSTEM_DEFAULT, DISPATCH_METHOD, &table.params[command], NULL, NULL, NULL);
+				pdisp->Release();
+			}
+			QueryPerformanceCounter(&end);
+			double byName = (end.QuadPart - start.QuadPart)*1000000.0/frequency.QuadPart/iterations;
+
+			QueryPerformanceCounter(&start);
+			for (int i = 0; SUCCEEDED(hresult) && i < iterations; ++i)
+			{
+				hresult = table.invoke((StereoCommand)command);
+			}
+			QueryPerformanceCounter(&end);
+			double resolved = (end.QuadPart - start.QuadPart)*1000000.0/frequency.QuadPart/iterations;
+
+			printf("  %-24s %8.1f us by name, %8.1f us resolved\n", descriptor.name, byName, resolved);
+		}
+
+		//every call must have reached the method it was meant for
+		if SUCCEEDED(hresult)
+		{
+			LONG expected[STEREO_METHOD_COUNT] = {0};
+			for (int command = 0; command < STEREO_COMMAND_COUNT; ++command)
+				expected[getStereoCommand((StereoCommand)command).method] += 2*iterations;
+			for (int method = 0; method < STEREO_METHOD_COUNT; ++method)
+			{
+				if (standIn.pPlayer->getInvokeCount((StereoMethod)method) != expected[method])
+				{
+					wcout << L"Stand-in got " << standIn.pPlayer->getInvokeCount((StereoMethod)method) << L" calls of "
+						<< getStereoMethodName((StereoMethod)method) << L", expected " << expected[method] << endl;
+					hresult = E_UNEXPECTED;
+				}
+			}
+		}
+
+		table.release();
+		punk->Release();
+	}
+
+	if FAILED(hresult)
+		cout << "Benchmark failed: " << format_error(hresult) << endl;
+
+	PostThreadMessage(threadID, WM_QUIT, 0, 0);
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+	return hresult;
+}
+
+class COMMAND
+{
+	HRESULT hresult;
+	IUnknown * punk;
+	StereoCommandTable commands;
+	VARIANT lrFile[4];
+	WCHAR stringCommand[MAX_PATH];  //MAX_PATH defined as 260
+	LPCWSTR str;
+
+public:
+	//this is the constructor for the class
+	COMMAND() : punk(NULL)
+	{
+		cout << "Constructor has been called" << endl;
+		
+		hresult = OleInitialize(NULL);
+		if FAILED(hresult)
+		{
+			cout << "Failed to initialize OLE Object" << endl;
+		}
+
+		for (int i = 0; i < 4; ++i)
+			VariantInit(&lrFile[i]);
+
+		str = TEXT("\nConstructor Called\n");
+		OutputDebugString(str);
+	}
+	//this is the destructor for the class
+	~COMMAND()
+	{
+		str = TEXT("\nDestructor Called\n");
+		OutputDebugString(str);
+		
+		commands.release();
+		if(punk) punk->Release();
+		punk = NULL;
+
+		OleUninitialize();
+
+	}
+
+	//start the player, and look up every method the commands use: from then on each command is one Invoke
+	HRESULT CreateInstance()
+	{
+		hresult = CoCreateInstance(StereoPlayer,NULL,CLSCTX_SERVER,IID_IUnknown, (void **) &punk);
+
+		if FAILED(hresult)
+		{
+			punk = NULL;
+			cout << "StereoCommand - Failed to CreateInstance: " << format_error(hresult) << endl;
+			return hresult;
+		}
+
+		hresult = commands.resolve(punk);
+		if FAILED(hresult)
+		{
+			cout << "StereoCommand - Failed to look up the player's methods: " << format_error(hresult) << endl;
+		}
+		return hresult;
+	}
+	
+	HRESULT OpenFile(string filepath)
+	{
+		cout << "Open File..." << endl;
+		//convert the path to the BSTR argument of the command
+		prepStringParam(filepath,stringCommand); //conversion
+		commands.setString(STEREO_OPEN_FILE, stringCommand);
+
+		hresult = commands.invoke(STEREO_OPEN_FILE);
+
+		if FAILED(hresult)
+		{
+			cout<<"FAILED TO OPEN FILE: " << format_error(hresult) << endl;
+		}
+		//the duration and repeat are asked for by whoever opened the file (the player dispatcher)
+		return hresult;
+	}
+
+	HRESULT GetDuration(double& seconds)
+	{
+		cout << "Function: Get Duration" << endl;
+
+		hresult = getNumber(STEREO_GET_DURATION, seconds);
+		if FAILED(hresult)
+		{
+			cout << "Failed to get duration.  " << format_error(hresult) << endl;
+		}
+		return hresult;
+	}
+
+	//what the player is doing, read back from it every time: nothing of it is kept here, where it could go stale
+	bool Offers(StereoMethod method) const
+	{
+		return commands.offers(method);
+	}
+
+	HRESULT GetPlaybackState(double& state)
+	{
+		return getNumber(STEREO_GET_PLAYBACK_STATE, state);
+	}
+
+	HRESULT GetPosition(double& seconds)
+	{
+		return getNumber(STEREO_GET_POSITION, seconds);
+	}
+
+	HRESULT GetPlayerZoom(double& percent)
+	{
+		return getNumber(STEREO_GET_ZOOM, percent);
+	}
+
+	HRESULT GetFullScreenMode(bool& full)
+	{
+		double value;
+		hresult = getNumber(STEREO_GET_FULLSCREEN, value);
+		if SUCCEEDED(hresult)
+			full = value != 0;
+		return hresult;
+	}
+
+	HRESULT SetPause()
+	{
+		hresult = commands.invoke(STEREO_PAUSE);
+
+		return hresult;
+
+	}
+
+	HRESULT SetPlay()
+	{
+		hresult = commands.invoke(STEREO_PLAY);
+
+		return hresult;		
+	}
+
+	HRESULT SetFF()
+	{
+		hresult = commands.invoke(STEREO_FAST_FORWARD);
+
+		return hresult;
+
+	}
+
+	HRESULT SetRW()
+	{
+		hresult = commands.invoke(STEREO_REWIND);
+
+		return hresult;
+	}
+
+	HRESULT SetFullScreen()
+	{
+		hresult = commands.invoke(STEREO_ENTER_FULLSCREEN);
+
+		if FAILED(hresult)
+		{
+			std::cout << "FAILED TO SET FULL SCREEN " <<format_error(hresult) << endl;
+		}
+
+		return hresult;
+	}
+
+	HRESULT SetStop()
+	{
+		hresult = commands.invoke(STEREO_STOP);
+
+		if FAILED(hresult)
+		{
+			std::cout << "FAILED TO SET STOP " << format_error(hresult) << endl;
+		}
+
+		return hresult;
+	}
+
+	HRESULT SetLeaveFullScreen()
+	{
+		hresult = commands.invoke(STEREO_LEAVE_FULLSCREEN);
+
+		//the caller counts it as failed: a player that stays full screen is no reason to end the program under the
+		//other threads
+		if FAILED(hresult)
+		{
+			std::cout << "FAILED TO LEAVE FULL SCREEN " << format_error(hresult) << endl;
+		}
+
+		return hresult;
+	}
+
+	void EmergencyExit()
+	{
+		ClosePlayer();
+
+		OleUninitialize();
+		exit(1);
+	}
+
+	//close the player while it can still be reached, and let go of it. From the thread that created it
+	void ClosePlayer()
+	{
+		if (punk == NULL)
+			return;
+
+		hresult = commands.invoke(STEREO_CLOSE_PLAYER);
+
+		commands.release();
+		punk->Release();
+		punk = NULL;
+	}
+
+	//zoom straight to newZoom percent, in one command
+	HRESULT SetZoom(double newZoom)
+	{
+		//newZoom is absolute: whatever zoom the player is at, possibly not the one it was last given, it goes there
+		VARIANT& zoom = commands.getArgument(STEREO_SET_ZOOM);
+		zoom.dblVal = newZoom;
+		hresult = commands.invoke(STEREO_SET_ZOOM);
+
+		if FAILED(hresult)
+		{
+			cout << "FAILED TO INVOKE ZOOM: " << format_error(hresult) << endl;
+		}
+		return hresult;
+	}
+
+	HRESULT SetRepeatTrue()
+	{
+		hresult = commands.invoke(STEREO_REPEAT_ON);
+
+		if FAILED(hresult)
+		{
+			cout << "FAILED TO SET REPEAT TRUE " << format_error(hresult) << endl;
+		}
+		else
+			cout << "Repeat set to TRUE" << endl;
+
+		return hresult;
+	}
+
+	HRESULT SetRepeatFalse()
+	{
+		hresult = commands.invoke(STEREO_REPEAT_OFF);
+
+		if FAILED(hresult)
+		{
+			cout << "FAILED TO SET REPEAT FALSE " << format_error(hresult) << endl;
+		}
+		else
+			cout << "Repeat set to FALSE" << endl;
+
+		return hresult;
+	}
+
+	HRESULT SetOpenLRFiles(string LeftFile, string RightFile, int AudioMode)
+	{
+		//set LeftFile into the arguments
+		prepStringParam(LeftFile,stringCommand);
+		setStringArg(lrFile[3], stringCommand);
+		
+		//set up right file
+		prepStringParam(RightFile,stringCommand);
+		setStringArg(lrFile[2], stringCommand);
+
+		if (AudioMode ==1.0)
+		{
+			std::cout << "ERROR Parameters indicate a separate audio file is expected, but none was indicated." << endl;
+			return DISP_E_BADPARAMCOUNT;
+		}
+		//we are not specifying an audio file so we need to nullify this array element
+		VariantClear(&lrFile[1]);
+
+		return invokeOpenLRFiles(AudioMode);
+	}
+	
+
+	HRESULT SetOpenLRFiles(string LeftFile, string RightFile, string AudioFile, int AudioMode)
+	{
+		//set LeftFile into the arguments
+		prepStringParam(LeftFile,stringCommand);
+		setStringArg(lrFile[3], stringCommand);
+		
+		//set up right file
+		prepStringParam(RightFile,stringCommand);
+		setStringArg(lrFile[2], stringCommand);
+
+		if (AudioMode ==1.0)
+		{
+			std::cout << "ERROR Parameters indicate a separate audio file is expected, but none was indicated." << endl;
+			return DISP_E_BADPARAMCOUNT;
+		}
+		
+		//set audio file
+		prepStringParam(AudioFile,stringCommand);
+		setStringArg(lrFile[1], stringCommand);
+
+		return invokeOpenLRFiles(AudioMode);
+	}
+
+protected:
+	//a getter's result, as a number
+	HRESULT getNumber(StereoCommand command, double& value)
+	{
+		VARIANT result;
+		VariantInit(&result);
+		hresult = commands.invoke(command, &result);
+		if FAILED(hresult)
+			return hresult;
+
+		hresult = VariantChangeType(&result, &result, 0, VT_R8);
+		if SUCCEEDED(hresult)
+			value = result.dblVal;
+		VariantClear(&result);
+		return hresult;
+	}
+
+	HRESULT invokeOpenLRFiles(int AudioMode)
+	{
+		//set audio mode
+		VariantClear(&lrFile[0]);
+		lrFile[0].vt = VT_I4;
+		lrFile[0].lVal = AudioMode;
+
+		DISPPARAMS dispparams;
+		dispparams.rgvarg = lrFile;
+		dispparams.cArgs = 4;
+		dispparams.cNamedArgs = 0;
+		dispparams.rgdispidNamedArgs = NULL;
+
+		hresult = commands.invoke(STEREO_METHOD_OPEN_LEFT_RIGHT_FILES, &dispparams);
+
+		if FAILED(hresult)
+		{
+			cout << "Failed to Invoke command." << format_error(hresult) << endl;
+		}
+		return hresult;
+	}
+
+	void setStringArg(VARIANT& argument, const WCHAR * value)
+	{
+		VariantClear(&argument);
+		argument.vt = VT_BSTR;
+		argument.bstrVal = SysAllocString(value);
+	}
+
+	void prepStringParam(string argument, WCHAR formattedArg[])
+	{
+		//converts the "string" variable to the OLECHAR type for use in the VARIANT structure
+		MultiByteToWideChar(CP_UTF8,0,argument.c_str(),argument.length()+1,formattedArg,MAX_PATH);
+	}
+};
+
+//StereoPlayer through COM automation, as the gestures' player. The player dispatcher's thread makes every call, so
+//that thread joins COM, creates the player and owns it to the end
+class StereoPlayerBackend : public PlayerBackend
+{
+	COMMAND& command;
+	bool oleInitialized;
+
+public:
+	StereoPlayerBackend(COMMAND& command) :
+		command(command), oleInitialized(false)
+	{
+	}
+
+	XnStatus Connect()
+	{
+		oleInitialized = SUCCEEDED(OleInitialize(NULL));
+
+		//create instance using COMMAND::CreateInstance
+		HRESULT hresult = command.CreateInstance();
+		if FAILED(hresult)
+		{
+			cout << "Failed to CreateInstance: " << format_error(hresult) << endl;
+			Disconnect();
+			return XN_STATUS_ERROR;
+		}
+		return XN_STATUS_OK;
+	}
+
+	void Disconnect()
+	{
+		command.ClosePlayer();
+		if (oleInitialized)
+			OleUninitialize();
+		oleInitialized = false;
+	}
+
+	XnStatus OpenFile(const XnChar* strFile)
+	{
+		return check(command.OpenFile(strFile));
+	}
+
+	XnStatus OpenLeftRightFiles(const XnChar* strLeft, const XnChar* strRight, const XnChar* strAudio, XnInt32 nAudioMode)
+	{
+		if (strAudio == NULL)
+			return check(command.SetOpenLRFiles(strLeft, strRight, nAudioMode));
+		return check(command.SetOpenLRFiles(strLeft, strRight, strAudio, nAudioMode));
+	}
+
+	XnStatus GetDuration(XnDouble& fSeconds)
+	{
+		return check(command.GetDuration(fSeconds));
+	}
+
+	XnStatus SetPlaybackState(PlaybackState eState)
+	{
+		switch (eState)
+		{
+		case PLAYBACK_PLAY:
+			return check(command.SetPlay());
+		case PLAYBACK_PAUSE:
+			return check(command.SetPause());
+		default:
+			return check(command.SetStop());
+		}
+	}
+
+	XnStatus SetZoom(XnDouble fPercent)
+	{
+		return check(command.SetZoom(fPercent));
+	}
+
+	XnStatus SetFullScreen(XnBool bFullScreen)
+	{
+		return check(bFullScreen ? command.SetFullScreen() : command.SetLeaveFullScreen());
+	}
+
+	XnStatus SetRepeat(XnBool bRepeat)
+	{
+		return check(bRepeat ? command.SetRepeatTrue() : command.SetRepeatFalse());
+	}
+
+	//one round trip per field the player offers a getter for
+	XnStatus GetState(PlayerState& state)
+	{
+		double value;
+		bool full;
+		if (command.Offers(STEREO_METHOD_GET_PLAYBACK_STATE))
+		{
+			XN_IS_STATUS_OK(check(command.GetPlaybackState(value)));
+			state.ePlayback = value == PLAY ? PLAYBACK_PLAY : value == PAUSE ? PLAYBACK_PAUSE : PLAYBACK_STOP;
+			state.nReported |= PLAYER_STATE_PLAYBACK;
+		}
+		if (command.Offers(STEREO_METHOD_GET_POSITION))
+		{
+			XN_IS_STATUS_OK(check(command.GetPosition(value)));
+			state.fPosition = value;
+			state.nReported |= PLAYER_STATE_POSITION;
+		}
+		if (command.Offers(STEREO_METHOD_GET_ZOOM))
+		{
+			XN_IS_STATUS_OK(check(command.GetPlayerZoom(value)));
+			state.fZoom = value;
+			state.nReported |= PLAYER_STATE_ZOOM;
+		}
+		if (command.Offers(STEREO_METHOD_GET_FULLSCREEN))
+		{
+			XN_IS_STATUS_OK(check(command.GetFullScreenMode(full)));
+			state.bFullScreen = full;
+			state.nReported |= PLAYER_STATE_FULLSCREEN;
+		}
+		return XN_STATUS_OK;
+	}
+
+protected:
+	XnStatus check(HRESULT hresult)
+	{
+		if FAILED(hresult)
+		{
+			std::cout << "COMMAND ERROR: " << format_error(hresult) << endl;
+			return XN_STATUS_ERROR;
+		}
+		return XN_STATUS_OK;
+	}
+};